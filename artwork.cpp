@@ -0,0 +1,92 @@
+// artwork.cpp
+
+#include "artwork.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+double ms_since(Uint64 start) {
+    return static_cast<double>(SDL_GetPerformanceCounter() - start) * 1000.0
+           / static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+SDL_Texture* upload(SDL_Renderer* r, Uint32 format, int w, int h, const void* pixels) {
+    SDL_Texture* tex = SDL_CreateTexture(r, format, SDL_TEXTUREACCESS_STATIC, w, h);
+    if (!tex) return nullptr;
+    if (SDL_UpdateTexture(tex, nullptr, pixels, w * 4) != 0) {
+        SDL_DestroyTexture(tex);
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+    return tex;
+}
+
+} // namespace
+
+Uint32 sdl_pixel_format(PixelLayout layout) {
+    switch (layout) {
+    case PixelLayout::ARGB8888: return SDL_PIXELFORMAT_ARGB8888;
+    case PixelLayout::ABGR8888: return SDL_PIXELFORMAT_ABGR8888;
+    case PixelLayout::RGBA8888: return SDL_PIXELFORMAT_RGBA8888;
+    case PixelLayout::BGRA8888: return SDL_PIXELFORMAT_BGRA8888;
+    }
+    return SDL_PIXELFORMAT_ARGB8888;
+}
+
+PixelLayout renderer_pixel_layout(SDL_Renderer* r) {
+    SDL_RendererInfo info{};
+    if (SDL_GetRendererInfo(r, &info) == 0) {
+        for (Uint32 i = 0; i < info.num_texture_formats; i++) {
+            for (PixelLayout l : { PixelLayout::ARGB8888, PixelLayout::ABGR8888, PixelLayout::RGBA8888, PixelLayout::BGRA8888 })
+                if (info.texture_formats[i] == sdl_pixel_format(l)) return l;
+        }
+    }
+    return PixelLayout::ARGB8888;
+}
+
+SDL_Texture* load_artwork(SDL_Renderer* r, const char* path, ArtworkLoadInfo* info) {
+    ArtworkLoadInfo local;
+    ArtworkLoadInfo& in = info ? *info : local;
+    Uint64 t = SDL_GetPerformanceCounter();
+    std::vector<std::uint8_t> data;
+    if (!read_file(path, data)) return nullptr;
+    in.readMs = ms_since(t);
+
+    SDL_Texture* tex = nullptr;
+    ArtHeader h;
+    const std::uint32_t* px = nullptr;
+    if (art_parse(data.data(), data.size(), h, px)) {
+        const auto layout = static_cast<PixelLayout>(h.layout);
+        in.converted = layout != renderer_pixel_layout(r);
+        t = SDL_GetPerformanceCounter();
+        tex = upload(r, sdl_pixel_format(layout), static_cast<int>(h.width), static_cast<int>(h.height), px);
+        in.uploadMs = ms_since(t);
+    } else {
+        Image img;
+        t = SDL_GetPerformanceCounter();
+        if (!qoi_decode(data.data(), data.size(), renderer_pixel_layout(r), img)) {
+            std::fprintf(stderr, "%s: not a .dart or .qoi image\n", path);
+            return nullptr;
+        }
+        in.decodeMs = ms_since(t);
+        t = SDL_GetPerformanceCounter();
+        tex = upload(r, sdl_pixel_format(img.layout), img.width, img.height, img.pixels.data());
+        in.uploadMs = ms_since(t);
+    }
+    if (!tex) std::fprintf(stderr, "%s: cannot create texture: %s\n", path, SDL_GetError());
+    return tex;
+}
+
+SDL_Texture* load_optional_artwork(SDL_Renderer* r, const char* base) {
+    for (const char* ext : { ".dart", ".qoi" }) {
+        const std::string path = std::string(base) + ext;
+        if (::access(path.c_str(), F_OK) == 0) return load_artwork(r, path.c_str());
+    }
+    return nullptr;
+}
@@ -0,0 +1,31 @@
+// artwork.h
+// Case and banker art as textures, from the files image_codec.h reads. A .dart made for
+// this renderer's layout (tools/art_convert) uploads as is. A .qoi is decoded straight
+// into the renderer's layout. Neither path needs SDL_image or a format conversion.
+
+#pragma once
+
+#include "image_codec.h"
+
+#include <SDL2/SDL.h>
+
+// SDL_PIXELFORMAT_* for a packed layout
+Uint32 sdl_pixel_format(PixelLayout layout);
+
+// The renderer's preferred packed 32-bit layout: the first one it lists, ARGB8888 if it
+// lists none
+PixelLayout renderer_pixel_layout(SDL_Renderer* r);
+
+struct ArtworkLoadInfo {
+    double readMs{0};
+    double decodeMs{0};   // QOI only
+    double uploadMs{0};
+    bool converted{false}; // A .dart in another layout: SDL converted it on upload
+};
+
+// Load a .dart or .qoi file as a static, blended texture. nullptr on error, with a
+// message on stderr.
+SDL_Texture* load_artwork(SDL_Renderer* r, const char* path, ArtworkLoadInfo* info = nullptr);
+
+// `base`.dart, else `base`.qoi. Returns nullptr quietly when neither exists.
+SDL_Texture* load_optional_artwork(SDL_Renderer* r, const char* base);
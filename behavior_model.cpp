@@ -0,0 +1,222 @@
+// behavior_model.cpp
+// Featurizing decision logs and fitting the logistic contestant model.
+
+#include "behavior_model.h"
+#include "game.h"
+
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+constexpr std::uint32_t kModelVersion = 1;
+constexpr std::size_t kBatch = 1024; // Rows per inner loop; z/err scratch stays in L1
+
+float sigmoid(float z) { return 1.0f / (1.0f + std::exp(-z)); }
+
+// Gradient of the mean log-loss over rows [begin, end) of standardized data
+void shard_gradient(const BehaviorDataset& d, std::size_t begin, std::size_t end,
+                    const std::array<float, kBehaviorFeatures>& mean,
+                    const std::array<float, kBehaviorFeatures>& invStd,
+                    const std::array<float, kBehaviorFeatures>& w,
+                    std::array<double, kBehaviorFeatures>& grad, double& loss) {
+    float z[kBatch], err[kBatch];
+    for (std::size_t b = begin; b < end; b += kBatch) {
+        const std::size_t n = (end - b < kBatch) ? end - b : kBatch;
+        const float* y = d.y.data() + b;
+
+        // z = w . standardize(x), one feature column at a time (contiguous, vectorizable)
+        for (std::size_t i = 0; i < n; i++) z[i] = w[0];
+        for (std::size_t f = 1; f < kBehaviorFeatures; f++) {
+            const float* col = d.x[f].data() + b;
+            const float wf = w[f] * invStd[f], shift = mean[f];
+            for (std::size_t i = 0; i < n; i++) z[i] += wf * (col[i] - shift);
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            const float p = sigmoid(z[i]);
+            err[i] = p - y[i];
+            const float pc = std::fmin(std::fmax(p, 1e-7f), 1.0f - 1e-7f);
+            loss -= static_cast<double>(y[i] * std::log(pc) + (1.0f - y[i]) * std::log(1.0f - pc));
+        }
+
+        // grad_f = sum(err * standardized x_f)
+        float acc = 0.0f;
+        for (std::size_t i = 0; i < n; i++) acc += err[i];
+        grad[0] += static_cast<double>(acc);
+        for (std::size_t f = 1; f < kBehaviorFeatures; f++) {
+            const float* col = d.x[f].data() + b;
+            const float shift = mean[f];
+            acc = 0.0f;
+            for (std::size_t i = 0; i < n; i++) acc += err[i] * (col[i] - shift);
+            grad[f] += static_cast<double>(acc * invStd[f]);
+        }
+    }
+}
+
+} // namespace
+
+void BehaviorDataset::append(const BehaviorDataset& other) {
+    for (std::size_t f = 0; f < kBehaviorFeatures; f++)
+        x[f].insert(x[f].end(), other.x[f].begin(), other.x[f].end());
+    y.insert(y.end(), other.y.begin(), other.y.end());
+}
+
+std::array<float, kBehaviorFeatures> BehaviorModel::features(std::uint32_t openedMask, int round,
+                                                             std::uint32_t offerCents) {
+    // Mean and standard deviation of the unopened values
+    double sum = 0.0, sumSq = 0.0;
+    int n = 0;
+    for (int i = 0; i < kNumCases; i++) {
+        if (openedMask & (1u << i)) continue;
+        const double v = kCaseValues[static_cast<std::size_t>(i)];
+        sum += v;
+        sumSq += v * v;
+        ++n;
+    }
+    const double mean = n ? sum / n : 0.0;
+    const double var = n ? sumSq / n - mean * mean : 0.0;
+    const double spread = mean > 0.0 ? std::sqrt(var > 0.0 ? var : 0.0) / mean : 0.0;
+    const double ratio = mean > 0.0 ? offerCents / mean : 0.0;
+    return { 1.0f, static_cast<float>(ratio), static_cast<float>(round) / kNumRounds, static_cast<float>(spread) };
+}
+
+float BehaviorModel::deal_probability(std::uint32_t openedMask, int round, std::uint32_t offerCents) const {
+    const std::array<float, kBehaviorFeatures> x = features(openedMask, round, offerCents);
+    float z = 0.0f;
+    for (std::size_t f = 0; f < kBehaviorFeatures; f++) z += weights[f] * x[f];
+    return sigmoid(z);
+}
+
+bool BehaviorModel::save(const char* path) const {
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) {
+        std::fprintf(stderr, "BehaviorModel: cannot write %s\n", path);
+        return false;
+    }
+    std::fprintf(f, "dond-behavior %u\n", kModelVersion);
+    for (std::size_t i = 0; i < kBehaviorFeatures; i++)
+        std::fprintf(f, "%.9g%c", static_cast<double>(weights[i]), i + 1 < kBehaviorFeatures ? ' ' : '\n');
+    return std::fclose(f) == 0;
+}
+
+bool BehaviorModel::load(const char* path) {
+    std::FILE* f = std::fopen(path, "r");
+    if (!f) {
+        std::fprintf(stderr, "BehaviorModel: cannot open %s\n", path);
+        return false;
+    }
+    unsigned version = 0;
+    bool ok = std::fscanf(f, "dond-behavior %u", &version) == 1 && version == kModelVersion;
+    for (std::size_t i = 0; ok && i < kBehaviorFeatures; i++) ok = std::fscanf(f, "%f", &weights[i]) == 1;
+    std::fclose(f);
+    if (!ok) std::fprintf(stderr, "BehaviorModel: %s is not a behavior model\n", path);
+    return ok;
+}
+
+void append_behavior_features(const std::vector<DecisionRecord>& records, BehaviorDataset& out) {
+    for (std::size_t f = 0; f < kBehaviorFeatures; f++) out.x[f].reserve(out.x[f].size() + records.size());
+    out.y.reserve(out.y.size() + records.size());
+    for (const DecisionRecord& r : records) {
+        const std::array<float, kBehaviorFeatures> x = BehaviorModel::features(r.openedMask, r.round, r.offerCents);
+        for (std::size_t f = 0; f < kBehaviorFeatures; f++) out.x[f].push_back(x[f]);
+        out.y.push_back(r.tookDeal ? 1.0f : 0.0f);
+    }
+}
+
+bool load_behavior_dataset(const std::vector<std::string>& paths, unsigned threads, BehaviorDataset& out) {
+    if (threads == 0) threads = 1;
+    if (threads > paths.size()) threads = static_cast<unsigned>(paths.size() ? paths.size() : 1);
+
+    // Each worker owns a strided subset of files and its own dataset. Parts are merged in
+    // worker order afterwards so the result doesn't depend on scheduling.
+    std::vector<BehaviorDataset> parts(threads);
+    std::vector<char> okParts(threads, 1);
+    auto work = [&](unsigned t) {
+        std::vector<DecisionRecord> records;
+        for (std::size_t i = t; i < paths.size(); i += threads) {
+            records.clear();
+            if (!read_decision_log(paths[i].c_str(), records)) { okParts[t] = 0; continue; }
+            append_behavior_features(records, parts[t]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(work, t);
+    work(0);
+    for (std::thread& th : pool) th.join();
+
+    bool ok = true;
+    for (unsigned t = 0; t < threads; t++) {
+        out.append(parts[t]);
+        ok = ok && okParts[t];
+    }
+    return ok;
+}
+
+BehaviorFitReport fit_behavior_model(const BehaviorDataset& data, const BehaviorFitOptions& opts, BehaviorModel& model) {
+    BehaviorFitReport rep;
+    rep.samples = data.size();
+    if (data.size() == 0) return rep;
+    const unsigned threads = opts.threads ? opts.threads : 1;
+
+    // Standardize features (bias column stays 1) so one learning rate suits all weights
+    std::array<float, kBehaviorFeatures> mean{}, invStd{};
+    invStd[0] = 1.0f;
+    for (std::size_t f = 1; f < kBehaviorFeatures; f++) {
+        double s = 0.0, sq = 0.0;
+        for (float v : data.x[f]) { s += static_cast<double>(v); sq += static_cast<double>(v) * static_cast<double>(v); }
+        const double m = s / static_cast<double>(data.size());
+        const double var = sq / static_cast<double>(data.size()) - m * m;
+        mean[f] = static_cast<float>(m);
+        invStd[f] = var > 1e-12 ? static_cast<float>(1.0 / std::sqrt(var)) : 0.0f;
+    }
+
+    std::array<float, kBehaviorFeatures> w{};
+    const double invN = 1.0 / static_cast<double>(data.size());
+    double loss = 0.0;
+    for (int it = 0; it < opts.iterations; it++) {
+        // Each thread accumulates the gradient of its contiguous shard
+        std::vector<std::array<double, kBehaviorFeatures>> grads(threads, std::array<double, kBehaviorFeatures>{});
+        std::vector<double> losses(threads, 0.0);
+        const std::size_t shard = (data.size() + threads - 1) / threads;
+        auto work = [&](unsigned t) {
+            const std::size_t begin = shard * t;
+            const std::size_t end = begin + shard < data.size() ? begin + shard : data.size();
+            if (begin < end) shard_gradient(data, begin, end, mean, invStd, w, grads[t], losses[t]);
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; t++) pool.emplace_back(work, t);
+        work(0);
+        for (std::thread& th : pool) th.join();
+
+        loss = 0.0;
+        std::array<double, kBehaviorFeatures> g{};
+        for (unsigned t = 0; t < threads; t++) {
+            loss += losses[t];
+            for (std::size_t f = 0; f < kBehaviorFeatures; f++) g[f] += grads[t][f];
+        }
+        for (std::size_t f = 0; f < kBehaviorFeatures; f++) {
+            double step = g[f] * invN;
+            if (f > 0) step += static_cast<double>(opts.l2 * w[f]);
+            w[f] -= opts.learningRate * static_cast<float>(step);
+        }
+    }
+    rep.logLoss = loss * invN; // Loss of the weights going into the final step
+
+    // Fold standardization back into raw-feature weights
+    model.weights[0] = w[0];
+    for (std::size_t f = 1; f < kBehaviorFeatures; f++) {
+        model.weights[f] = w[f] * invStd[f];
+        model.weights[0] -= w[f] * invStd[f] * mean[f];
+    }
+
+    // Training accuracy of the final model
+    std::size_t correct = 0;
+    for (std::size_t i = 0; i < data.size(); i++) {
+        float z = 0.0f;
+        for (std::size_t f = 0; f < kBehaviorFeatures; f++) z += model.weights[f] * data.x[f][i];
+        if ((z >= 0.0f) == (data.y[i] > 0.5f)) ++correct;
+    }
+    rep.accuracy = static_cast<double>(correct) / static_cast<double>(data.size());
+    return rep;
+}
@@ -0,0 +1,77 @@
+// behavior_model.h
+// Parametric model of how real contestants answer the banker, fitted from decision logs.
+//
+//     P(deal) = sigmoid(w0 + w1 * offer/EV + w2 * round/9 + w3 * spread)
+//
+// where spread is the coefficient of variation (stddev / mean) of the unopened values.
+// A fitted model doubles as a simulator policy (see simulator.h), so economics runs can
+// use realistic contestants at full speed.
+
+#pragma once
+
+#include "game_log.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr std::size_t kBehaviorFeatures = 4; // bias, offer/EV, round, spread
+
+// Feature columns stored as structure-of-arrays so the fitting loops vectorize
+struct BehaviorDataset {
+    std::array<std::vector<float>, kBehaviorFeatures> x;
+    std::vector<float> y; // 1 = took the deal
+
+    std::size_t size() const { return y.size(); }
+    void append(const BehaviorDataset& other);
+};
+
+class BehaviorModel {
+public:
+    std::array<float, kBehaviorFeatures> weights{};
+
+    // Feature vector for one banker call
+    static std::array<float, kBehaviorFeatures> features(std::uint32_t openedMask, int round, std::uint32_t offerCents);
+
+    float deal_probability(std::uint32_t openedMask, int round, std::uint32_t offerCents) const;
+
+    // Simulator policy: sample the decision from the fitted probability
+    template <class Rng>
+    bool take_deal(std::uint32_t openedMask, int round, std::uint32_t offerCents, Rng& rng) {
+        const float p = deal_probability(openedMask, round, offerCents);
+        const float u = static_cast<float>(rng() >> 40) * (1.0f / 16777216.0f); // 24-bit uniform in [0,1)
+        return u < p;
+    }
+
+    // Text model file ("dond-behavior 1" followed by the weights). Return false on error.
+    bool save(const char* path) const;
+    bool load(const char* path);
+};
+
+// Gradient descent settings
+struct BehaviorFitOptions {
+    int iterations{400};
+    float learningRate{0.5f};
+    float l2{1e-4f};   // Ridge penalty on non-bias weights
+    unsigned threads{1};
+};
+
+// Fit quality on the training data
+struct BehaviorFitReport {
+    std::size_t samples{0};
+    double logLoss{0.0};
+    double accuracy{0.0};
+};
+
+// Convert decision records into feature rows
+void append_behavior_features(const std::vector<DecisionRecord>& records, BehaviorDataset& out);
+
+// Read many decision logs concurrently (one file at a time per thread) and featurize them.
+// Returns false if any file could not be read; the successfully read files are still kept.
+bool load_behavior_dataset(const std::vector<std::string>& paths, unsigned threads, BehaviorDataset& out);
+
+// Batched full-gradient logistic regression. Features are standardized internally and the
+// result is folded back into raw-feature weights.
+BehaviorFitReport fit_behavior_model(const BehaviorDataset& data, const BehaviorFitOptions& opts, BehaviorModel& model);
@@ -0,0 +1,243 @@
+// broadcast_export.cpp
+
+#include "broadcast_export.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace {
+
+constexpr std::size_t kPage = 4096;
+constexpr std::size_t kStateWords = sizeof(ExportState) / 8;
+
+std::uint64_t steady_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+std::size_t round_up(std::size_t n, std::size_t to) {
+    return (n + to - 1) / to * to;
+}
+
+std::uint8_t* slot_pixels(ExportHeader* h, std::uint32_t slot) {
+    return reinterpret_cast<std::uint8_t*>(h) + h->pixelOffset + slot * h->slotBytes;
+}
+
+const std::uint8_t* slot_pixels(const ExportHeader* h, std::uint32_t slot) {
+    return reinterpret_cast<const std::uint8_t*>(h) + h->pixelOffset + slot * h->slotBytes;
+}
+
+} // namespace
+
+ExportState make_export_state(const ShowState& st, std::uint64_t tick) {
+    ExportState e;
+    e.tick = tick;
+    e.stepStartTick = st.stepStartTick;
+    e.stepTicks = st.stepTicks;
+    e.openedMask = st.openedMask;
+    e.openedCases = st.openedCases;
+    e.offerCents = st.offerCents;
+    e.winningsCents = st.winningsCents;
+    e.step = static_cast<std::uint8_t>(st.step);
+    e.phase = static_cast<std::uint8_t>(st.phase);
+    e.round = st.round;
+    e.toOpen = st.toOpen;
+    e.contestantCase = st.contestantCase;
+    e.lastOpened = st.lastOpened;
+    e.tookDeal = st.tookDeal ? 1 : 0;
+    // Unopened cases stay hidden: the truck gets no more than the audience sees
+    for (int i = 0; i < kNumCases; i++)
+        if ((st.openedCases >> i) & 1u) e.cases[i] = st.cases[static_cast<std::size_t>(i)];
+    if (st.phase == SessionPhase::Finished) e.cases[st.contestantCase] = st.cases[st.contestantCase];
+    return e;
+}
+
+// ---------------------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------------------
+
+BroadcastExport::~BroadcastExport() {
+    if (!header_) return;
+    ::munmap(header_, mapBytes_);
+    ::shm_unlink(name_); // Attached readers keep their mapping
+}
+
+bool BroadcastExport::open(const char* name, int maxWidth, int maxHeight) {
+    if (std::strlen(name) >= sizeof(name_)) {
+        std::fprintf(stderr, "export: name too long: %s\n", name);
+        return false;
+    }
+    const bool frames = maxWidth > 0 && maxHeight > 0;
+    const std::size_t slotBytes = frames ? round_up(static_cast<std::size_t>(maxWidth) * static_cast<std::size_t>(maxHeight) * 4, kPage) : 0;
+    const std::size_t pixelOffset = round_up(sizeof(ExportHeader), kPage);
+    const std::size_t bytes = pixelOffset + slotBytes * kExportFrameSlots;
+
+    ::shm_unlink(name); // A segment left by a crashed run may have another layout
+    const int fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        std::fprintf(stderr, "export: shm_open %s failed: %s\n", name, std::strerror(errno));
+        return false;
+    }
+    void* p = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+        p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        std::fprintf(stderr, "export: cannot map %zu bytes for %s: %s\n", bytes, name, std::strerror(errno));
+        ::shm_unlink(name);
+        return false;
+    }
+
+    auto* h = new (p) ExportHeader{};
+    h->version = kExportVersion;
+    h->maxWidth = frames ? static_cast<std::uint32_t>(maxWidth) : 0;
+    h->maxHeight = frames ? static_cast<std::uint32_t>(maxHeight) : 0;
+    h->pixelFormat = kExportPixelFormat;
+    h->slotBytes = slotBytes;
+    h->pixelOffset = pixelOffset;
+    // Readers check the magic first: a set magic means the layout fields are valid
+    h->magic.store(kExportMagic, std::memory_order_release);
+
+    header_ = h;
+    mapBytes_ = bytes;
+    std::strcpy(name_, name);
+    return true;
+}
+
+void BroadcastExport::publish_state(const ShowState& st, std::uint64_t tick) {
+    if (!header_) return;
+    const ExportState e = make_export_state(st, tick);
+    std::uint64_t words[kStateWords];
+    std::memcpy(words, &e, sizeof(e));
+
+    // Each word is a release store, so a reader that sees any new word also sees the odd
+    // counter when it checks again
+    const std::uint32_t seq = header_->stateSeq.load(std::memory_order_relaxed);
+    header_->stateSeq.store(seq + 1, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kStateWords; i++)
+        std::atomic_ref<std::uint64_t>(header_->stateWords[i]).store(words[i], std::memory_order_release);
+    header_->stateSeq.store(seq + 2, std::memory_order_release);
+    header_->writerNs.store(steady_ns(), std::memory_order_relaxed);
+}
+
+ExportFrame BroadcastExport::begin_frame(int width, int height) {
+    if (!exports_frames()) return {};
+    const std::uint32_t slot = static_cast<std::uint32_t>((frame_ + 1) % kExportFrameSlots);
+    ExportFrameSlot& s = header_->slots[slot];
+    // Odd: readers of the frame two back, which lived here, now fail validation. A
+    // read-modify-write, so the pixel stores that follow cannot overtake it.
+    s.seq.fetch_add(1, std::memory_order_acq_rel);
+    filling_ = &s;
+
+    ExportFrame f;
+    f.width = std::min(width, static_cast<int>(header_->maxWidth));
+    f.height = std::min(height, static_cast<int>(header_->maxHeight));
+    f.pitch = f.width * 4;
+    f.pixels = slot_pixels(header_, slot);
+    s.width.store(static_cast<std::uint32_t>(f.width), std::memory_order_relaxed);
+    s.height.store(static_cast<std::uint32_t>(f.height), std::memory_order_relaxed);
+    s.pitch.store(static_cast<std::uint32_t>(f.pitch), std::memory_order_relaxed);
+    return f;
+}
+
+void BroadcastExport::end_frame(std::uint64_t tick) {
+    if (!filling_) return;
+    ExportFrameSlot& s = *filling_;
+    filling_ = nullptr;
+    s.frame.store(++frame_, std::memory_order_relaxed);
+    s.tick.store(tick, std::memory_order_relaxed);
+    s.seq.store(s.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    header_->latestFrame.store(frame_, std::memory_order_release);
+    header_->writerNs.store(steady_ns(), std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------------------
+
+BroadcastReader::~BroadcastReader() {
+    if (header_) ::munmap(const_cast<ExportHeader*>(header_), mapBytes_);
+}
+
+bool BroadcastReader::attach(const char* name) {
+    const int fd = ::shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return false; // Not exported (yet)
+    struct stat st{};
+    void* p = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(ExportHeader))
+        p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    const auto* h = static_cast<const ExportHeader*>(p);
+    if (h->magic.load(std::memory_order_acquire) != kExportMagic || h->version != kExportVersion
+        || h->pixelOffset + h->slotBytes * kExportFrameSlots > static_cast<std::uint64_t>(st.st_size)) {
+        std::fprintf(stderr, "export: %s is not a compatible broadcast export\n", name);
+        ::munmap(p, static_cast<std::size_t>(st.st_size));
+        return false;
+    }
+    header_ = h;
+    mapBytes_ = static_cast<std::size_t>(st.st_size);
+    return true;
+}
+
+bool BroadcastReader::read_state(ExportState& out) {
+    std::uint64_t words[kStateWords];
+    for (std::uint32_t attempt = 0; attempt < kMaxRetries; attempt++) {
+        const std::uint32_t before = header_->stateSeq.load(std::memory_order_acquire);
+        if (before == 0) return false;
+        if (before & 1u) {
+            ++retries_; // Writer is mid-update
+            continue;
+        }
+        // Acquire loads: the counter check below cannot be answered before them
+        for (std::size_t i = 0; i < kStateWords; i++)
+            words[i] = std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(header_->stateWords[i])).load(std::memory_order_acquire);
+        if (header_->stateSeq.load(std::memory_order_relaxed) == before) {
+            std::memcpy(&out, words, sizeof(out));
+            return true;
+        }
+        ++retries_;
+    }
+    return false;
+}
+
+bool BroadcastReader::acquire_frame(ExportFrameView& view) {
+    if (header_->maxWidth == 0) return false;
+    for (std::uint32_t attempt = 0; attempt < kMaxRetries; attempt++) {
+        const std::uint64_t n = header_->latestFrame.load(std::memory_order_acquire);
+        if (n == 0) return false;
+        const auto slot = static_cast<std::uint32_t>(n % kExportFrameSlots);
+        const ExportFrameSlot& s = header_->slots[slot];
+        const std::uint32_t seq = s.seq.load(std::memory_order_acquire);
+        if (!(seq & 1u) && s.frame.load(std::memory_order_relaxed) == n) {
+            view.pixels = slot_pixels(header_, slot);
+            view.width = static_cast<int>(s.width.load(std::memory_order_relaxed));
+            view.height = static_cast<int>(s.height.load(std::memory_order_relaxed));
+            view.pitch = static_cast<int>(s.pitch.load(std::memory_order_relaxed));
+            view.frame = n;
+            view.tick = s.tick.load(std::memory_order_relaxed);
+            view.slot = slot;
+            view.seq = seq;
+            if (still_valid(view)) return true;
+        }
+        ++retries_; // The writer lapped us between the two loads
+    }
+    return false;
+}
+
+bool BroadcastReader::still_valid(const ExportFrameView& view) const {
+    // The slot fields are atomics read before this, so an acquire load of the counter
+    // orders the check after them. The pixel reads are plain and rely on the two-frame
+    // margin described in the header.
+    return header_->slots[view.slot].seq.load(std::memory_order_acquire) == view.seq;
+}
@@ -0,0 +1,174 @@
+// broadcast_export.h
+// Live show state and, optionally, rendered frames in POSIX shared memory for an external
+// broadcast graphics process. One writer (the game) and any number of readers; nobody
+// takes a lock and nothing waits on anybody.
+//
+// State sits behind a sequence counter (a seqlock): the writer makes the counter odd,
+// updates the fields and makes it even again; a reader copies the fields between two
+// reads of the counter and retries if it changed. Every shared field is an atomic (the
+// state words through std::atomic_ref), ordered by release stores and acquire loads
+// rather than standalone fences, so the protocol is race-free as far as the language
+// and ThreadSanitizer are concerned.
+//
+// Frames are triple-buffered: the writer fills the slot after the newest one, each slot
+// with its own sequence counter, then publishes the frame number. Readers use the pixels
+// in place, with no copy, and check the slot's counter afterwards. The pixels themselves
+// are plain memory, so that check is a safeguard rather than a guarantee: the writer only
+// comes back to a slot two frames later, and a reader that finishes within that time
+// always sees an intact frame.
+
+#pragma once
+
+#include "show_flow.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// What the broadcast graphics get to see. Size is a multiple of 8: readers copy it as words.
+struct ExportState {
+    std::uint64_t tick{0};         // Game scheduler tick
+    std::uint64_t stepStartTick{0};
+    std::uint64_t stepTicks{0};
+    std::uint32_t openedMask{0};
+    std::uint32_t openedCases{0};
+    std::uint32_t offerCents{0};
+    std::uint32_t winningsCents{0};
+    std::uint8_t step{0};          // ShowStep
+    std::uint8_t phase{0};         // SessionPhase
+    std::uint8_t round{0};
+    std::uint8_t toOpen{0};
+    std::uint8_t contestantCase{0};
+    std::uint8_t lastOpened{0};
+    std::uint8_t tookDeal{0};
+    std::uint8_t reserved{0};
+    std::uint8_t cases[kNumCases]{}; // Value index per case; only opened ones are meaningful
+    std::uint8_t pad[6]{};
+};
+static_assert(sizeof(ExportState) % 8 == 0, "ExportState is copied as 64-bit words");
+
+ExportState make_export_state(const ShowState& st, std::uint64_t tick);
+
+constexpr std::uint32_t kExportMagic = 0x444e4f44; // "DOND"
+constexpr std::uint32_t kExportVersion = 1;
+constexpr std::uint32_t kExportFrameSlots = 3;
+constexpr std::uint32_t kExportPixelFormat = 0x41524742; // "BGRA" in memory (SDL ARGB8888)
+
+// One frame buffer's bookkeeping; the pixels live at ExportHeader::pixelOffset. Fields
+// other than seq are read between two loads of seq, hence atomic too (relaxed).
+struct alignas(64) ExportFrameSlot {
+    std::atomic<std::uint32_t> seq{0}; // Odd while the writer fills the slot
+    std::atomic<std::uint32_t> width{0};
+    std::atomic<std::uint32_t> height{0};
+    std::atomic<std::uint32_t> pitch{0};
+    std::atomic<std::uint64_t> frame{0}; // Frame number held by the slot
+    std::atomic<std::uint64_t> tick{0};
+};
+
+// Start of the shared-memory region
+struct ExportHeader {
+    std::atomic<std::uint32_t> magic{0}; // Stored last (release): the fields below are valid
+    std::uint32_t version{0};
+    std::uint32_t maxWidth{0};         // 0 = state only, no frames
+    std::uint32_t maxHeight{0};
+    std::uint32_t pixelFormat{0};
+    std::uint32_t reserved{0};
+    std::uint64_t slotBytes{0};        // Pixel bytes per frame slot
+    std::uint64_t pixelOffset{0};      // From the start of the region, page aligned
+    std::atomic<std::uint64_t> writerNs{0}; // steady_clock of the last publish; readers spot a dead writer
+
+    alignas(64) std::atomic<std::uint32_t> stateSeq{0};
+    std::uint64_t stateWords[sizeof(ExportState) / 8]{};
+
+    alignas(64) std::atomic<std::uint64_t> latestFrame{0}; // 0 = none yet; lives in slot n % 3
+    ExportFrameSlot slots[kExportFrameSlots];
+};
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared-memory counters must be address-free atomics");
+
+// ---------------------------------------------------------------------------------------
+// Writer (the game)
+// ---------------------------------------------------------------------------------------
+
+// A frame slot lent to the writer
+struct ExportFrame {
+    std::uint8_t* pixels{nullptr}; // nullptr when frames are not exported
+    int width{0};
+    int height{0};
+    int pitch{0};
+};
+
+class BroadcastExport {
+public:
+    BroadcastExport() = default;
+    BroadcastExport(const BroadcastExport&) = delete;
+    BroadcastExport& operator=(const BroadcastExport&) = delete;
+    ~BroadcastExport();
+
+    // Create shared memory object `name` (e.g. "/dond-broadcast"), replacing a stale one.
+    // maxWidth/maxHeight of 0 exports state only; larger frames are cropped.
+    bool open(const char* name, int maxWidth = 0, int maxHeight = 0);
+
+    bool is_open() const { return header_ != nullptr; }
+    bool exports_frames() const { return header_ && header_->maxWidth > 0; }
+
+    void publish_state(const ShowState& st, std::uint64_t tick);
+
+    // Fill the returned slot (at most the requested size) and publish it with end_frame()
+    ExportFrame begin_frame(int width, int height);
+    void end_frame(std::uint64_t tick);
+
+private:
+    ExportHeader* header_{nullptr};
+    std::size_t mapBytes_{0};
+    char name_[64]{};
+    std::uint64_t frame_{0}; // Last published frame number
+    ExportFrameSlot* filling_{nullptr};
+};
+
+// ---------------------------------------------------------------------------------------
+// Reader (the broadcast graphics, or tools/broadcast_probe)
+// ---------------------------------------------------------------------------------------
+
+// A frame read in place from shared memory
+struct ExportFrameView {
+    const std::uint8_t* pixels{nullptr};
+    int width{0};
+    int height{0};
+    int pitch{0};
+    std::uint64_t frame{0};
+    std::uint64_t tick{0};
+    std::uint32_t slot{0};
+    std::uint32_t seq{0};
+};
+
+class BroadcastReader {
+public:
+    BroadcastReader() = default;
+    BroadcastReader(const BroadcastReader&) = delete;
+    BroadcastReader& operator=(const BroadcastReader&) = delete;
+    ~BroadcastReader();
+
+    bool attach(const char* name);
+
+    // Latest state; false until the writer published one, or if the writer stays
+    // mid-update for kMaxRetries attempts (it died while writing)
+    bool read_state(ExportState& out);
+
+    // Newest complete frame, in place. False when there is none (or frames are off), or
+    // after kMaxRetries attempts that all raced the writer.
+    bool acquire_frame(ExportFrameView& view);
+    // After using view.pixels: true if the writer did not touch the slot meanwhile
+    bool still_valid(const ExportFrameView& view) const;
+
+    const ExportHeader* header() const { return header_; }
+    std::uint64_t retries() const { return retries_; } // Reads that raced the writer
+
+    // A live writer holds a counter odd for well under a microsecond
+    static constexpr std::uint32_t kMaxRetries = 1u << 20;
+
+private:
+    const ExportHeader* header_{nullptr};
+    std::size_t mapBytes_{0};
+    std::uint64_t retries_{0};
+};
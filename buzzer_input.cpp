@@ -0,0 +1,184 @@
+// buzzer_input.cpp
+
+#include "buzzer_input.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+struct Device {
+    SDL_JoystickID id{-1};
+    SDL_Joystick* joystick{nullptr};         // Raw joystick, or the controller's
+    SDL_GameController* controller{nullptr}; // Set when SDL knows a mapping
+    std::uint32_t held{0};                   // Buzzer buttons down at the last poll
+};
+
+// Controller buttons that count, bit i of Device::held for controllers
+constexpr SDL_GameControllerButton kControllerButtons[] = {
+    SDL_CONTROLLER_BUTTON_A, SDL_CONTROLLER_BUTTON_START, SDL_CONTROLLER_BUTTON_B, SDL_CONTROLLER_BUTTON_BACK,
+};
+constexpr int kJoystickButtons = 2; // 0 = DEAL, 1 = NO DEAL
+constexpr auto kRescanPeriod = std::chrono::milliseconds(500);
+
+std::uint32_t buttons_down(const Device& d) {
+    std::uint32_t down = 0;
+    if (d.controller) {
+        for (std::size_t i = 0; i < std::size(kControllerButtons); i++)
+            if (SDL_GameControllerGetButton(d.controller, kControllerButtons[i])) down |= 1u << i;
+    } else {
+        const int n = std::min(SDL_JoystickNumButtons(d.joystick), kJoystickButtons);
+        for (int b = 0; b < n; b++)
+            if (SDL_JoystickGetButton(d.joystick, b)) down |= 1u << b;
+    }
+    return down;
+}
+
+void close_device(Device& d) {
+    if (d.controller) SDL_GameControllerClose(d.controller);
+    else if (d.joystick) SDL_JoystickClose(d.joystick);
+    d.controller = nullptr;
+    d.joystick = nullptr;
+}
+
+// Close unplugged devices and open new ones. Buttons held while a device is opened do not
+// count as presses.
+void rescan(std::vector<Device>& devices) {
+    for (Device& d : devices)
+        if (!SDL_JoystickGetAttached(d.joystick)) close_device(d);
+    devices.erase(std::remove_if(devices.begin(), devices.end(), [](const Device& d) { return !d.joystick; }),
+                  devices.end());
+
+    const int count = SDL_NumJoysticks();
+    for (int i = 0; i < count; i++) {
+        const SDL_JoystickID id = SDL_JoystickGetDeviceInstanceID(i);
+        if (std::any_of(devices.begin(), devices.end(), [id](const Device& d) { return d.id == id; })) continue;
+        Device d;
+        d.id = id;
+        if (SDL_IsGameController(i)) {
+            d.controller = SDL_GameControllerOpen(i);
+            d.joystick = d.controller ? SDL_GameControllerGetJoystick(d.controller) : nullptr;
+        } else {
+            d.joystick = SDL_JoystickOpen(i);
+        }
+        if (!d.joystick) continue;
+        d.held = buttons_down(d);
+        devices.push_back(d);
+    }
+}
+
+// Current device index of a joystick, or -1 once it is gone
+int device_index(SDL_JoystickID id) {
+    const int count = SDL_NumJoysticks();
+    for (int i = 0; i < count; i++)
+        if (SDL_JoystickGetDeviceInstanceID(i) == id) return i;
+    return -1;
+}
+
+} // namespace
+
+bool BuzzerInput::start(bool virtualBuzzer, int pollHz) {
+    if (thread_.joinable()) return true;
+    // This thread pumps the joysticks; the main loop's SDL_PollEvent must not as well.
+    // Buzzers keep working while another window (a studio display) has focus.
+    SDL_SetHint(SDL_HINT_AUTO_UPDATE_JOYSTICKS, "0");
+    SDL_SetHint(SDL_HINT_JOYSTICK_ALLOW_BACKGROUND_EVENTS, "1");
+    if (SDL_InitSubSystem(SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER) != 0) {
+        std::fprintf(stderr, "Buzzers disabled: %s\n", SDL_GetError());
+        return false;
+    }
+    SDL_JoystickEventState(SDL_IGNORE);
+    SDL_GameControllerEventState(SDL_IGNORE);
+    running_.store(true, std::memory_order_relaxed);
+    thread_ = std::thread([this, virtualBuzzer, pollHz] { run(pollHz, virtualBuzzer); });
+    return true;
+}
+
+void BuzzerInput::stop() {
+    if (!thread_.joinable()) return;
+    running_.store(false, std::memory_order_relaxed);
+    thread_.join();
+    SDL_QuitSubSystem(SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER);
+}
+
+void BuzzerInput::run(int pollHz, bool virtualBuzzer) {
+    // Real-time priority needs privileges; high usually does not
+    if (SDL_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL) != 0) SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    // The first rescan opens it like any other device
+    SDL_JoystickID virtualId = -1;
+    if (virtualBuzzer) {
+        const int index = SDL_JoystickAttachVirtual(SDL_JOYSTICK_TYPE_UNKNOWN, 0, kJoystickButtons, 0);
+        if (index < 0) std::fprintf(stderr, "Virtual buzzer unavailable: %s\n", SDL_GetError());
+        else virtualId = SDL_JoystickGetDeviceInstanceID(index);
+    }
+    std::vector<VirtualButton> pending;
+
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::nanoseconds(1000000000 / std::max(pollHz, 1));
+    std::vector<Device> devices;
+    Clock::time_point next = Clock::now();
+    Clock::time_point nextScan = next;
+    while (running_.load(std::memory_order_relaxed)) {
+        // Virtual buzzer buttons, in order. A release of a button pressed in this same
+        // poll waits for the next one, or the update below would never see the press.
+        VirtualButton cmds[16];
+        const std::size_t n = commands_.pop_batch(cmds, std::size(cmds));
+        pending.insert(pending.end(), cmds, cmds + n);
+        const auto vd = std::find_if(devices.begin(), devices.end(), [virtualId](const Device& d) { return d.id == virtualId; });
+        // Until the rescan below has opened the virtual device, its presses wait
+        const bool hold = virtualId >= 0 && vd == devices.end() && device_index(virtualId) >= 0;
+        std::size_t applied = 0;
+        std::uint32_t pressedNow = 0;
+        for (; applied < pending.size() && !hold; applied++) {
+            const VirtualButton& c = pending[applied];
+            if (c.button >= kJoystickButtons) continue;
+            if (!c.down && (pressedNow >> c.button & 1u)) break;
+            if (c.down) pressedNow |= 1u << c.button;
+            if (vd != devices.end()) SDL_JoystickSetVirtualButton(vd->joystick, c.button, c.down ? SDL_PRESSED : SDL_RELEASED);
+        }
+        pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(applied));
+
+        SDL_JoystickUpdate();
+        const Uint64 counter = SDL_GetPerformanceCounter();
+        const Clock::time_point now = Clock::now();
+        if (now >= nextScan) {
+            rescan(devices);
+            devices_.store(static_cast<std::uint32_t>(devices.size()), std::memory_order_relaxed);
+            nextScan = now + kRescanPeriod;
+        }
+
+        for (Device& d : devices) {
+            const std::uint32_t down = buttons_down(d);
+            for (std::uint32_t m = down & ~d.held; m; m &= m - 1) {
+                const int bit = std::countr_zero(m);
+                BuzzerPress press;
+                press.counter = counter;
+                press.device = d.id;
+                if (d.controller) {
+                    const SDL_GameControllerButton b = kControllerButtons[static_cast<std::size_t>(bit)];
+                    press.button = static_cast<std::uint8_t>(b);
+                    press.deal = b == SDL_CONTROLLER_BUTTON_A || b == SDL_CONTROLLER_BUTTON_START;
+                } else {
+                    press.button = static_cast<std::uint8_t>(bit);
+                    press.deal = bit == 0;
+                }
+                presses_.fetch_add(1, std::memory_order_relaxed);
+                if (!queue_.try_push(press)) dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            d.held = down;
+        }
+
+        // Fixed rate; after a stall (suspend, debugger) carry on from now
+        next += period;
+        if (next < now) next = now + period;
+        std::this_thread::sleep_until(next);
+    }
+    for (Device& d : devices) close_device(d);
+    if (virtualId >= 0 && device_index(virtualId) >= 0) SDL_JoystickDetachVirtual(device_index(virtualId));
+    devices_.store(0, std::memory_order_relaxed);
+}
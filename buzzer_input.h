@@ -0,0 +1,75 @@
+// buzzer_input.h
+// Contestant buzzers: physical DEAL / NO DEAL buttons that show up as USB joysticks or
+// game controllers. A dedicated high-priority thread polls them at 1 kHz, timestamps each
+// press with the performance counter and hands it to the main loop through a lock-free
+// queue (mpsc_queue.h). The main loop drains the queue once per turn and applies every
+// press at the tick it happened, so neither the frame rate nor SDL_PollEvent delays it.
+//
+// The thread owns the joysticks: SDL's own per-frame joystick pumping and joystick events
+// are switched off, and every device call after start(), enumeration, open and close,
+// happens on the poll thread.
+// Mapping: joystick button 0 and controller A / Start mean DEAL, joystick button 1 and
+// controller B / Back mean NO DEAL; other buttons are ignored.
+//
+// Hardware-free testing: start(true) has the poll thread attach an SDL virtual joystick,
+// and set_virtual_button() queues presses for the thread to apply to it; main
+// --virtual-buzzer drives it from the keyboard.
+
+#pragma once
+
+#include "mpsc_queue.h"
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+struct BuzzerPress {
+    Uint64 counter{0};        // SDL_GetPerformanceCounter() at the poll that saw it
+    SDL_JoystickID device{-1};
+    std::uint8_t button{0};   // Joystick button index, or SDL_GameControllerButton
+    bool deal{true};          // DEAL or NO DEAL
+};
+
+class BuzzerInput {
+public:
+    BuzzerInput() = default;
+    BuzzerInput(const BuzzerInput&) = delete;
+    BuzzerInput& operator=(const BuzzerInput&) = delete;
+    ~BuzzerInput() { stop(); }
+
+    // Main thread, after SDL_Init: bring up the joystick subsystems and start polling,
+    // with a virtual two-button buzzer if asked
+    bool start(bool virtualBuzzer = false, int pollHz = 1000);
+    void stop();
+
+    // Main thread: press or release a button of the virtual buzzer at the next poll
+    void set_virtual_button(int button, bool down) {
+        if (!commands_.try_push(VirtualButton{ static_cast<std::uint8_t>(button), down }))
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Main thread: up to `max` presses since the last call, oldest first
+    std::size_t take(BuzzerPress* out, std::size_t max) { return queue_.pop_batch(out, max); }
+
+    std::uint32_t devices() const { return devices_.load(std::memory_order_relaxed); }
+    std::uint64_t presses() const { return presses_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); } // Queue full
+
+private:
+    struct VirtualButton {
+        std::uint8_t button{0};
+        bool down{false};
+    };
+
+    void run(int pollHz, bool virtualBuzzer);
+
+    MpscQueue<BuzzerPress> queue_{256};
+    MpscQueue<VirtualButton> commands_{64}; // To the poll thread
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<std::uint32_t> devices_{0};
+    std::atomic<std::uint64_t> presses_{0};
+    std::atomic<std::uint64_t> dropped_{0}; // Either queue full
+};
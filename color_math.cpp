@@ -0,0 +1,199 @@
+// color_math.cpp
+
+#include "color_math.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+struct Tables {
+    std::array<std::uint16_t, 256> toLinear{};
+    std::array<std::uint8_t, 4096> toSrgb{};
+
+    Tables() {
+        for (int i = 0; i < 256; i++) {
+            const double s = i / 255.0;
+            const double l = s <= 0.04045 ? s / 12.92 : std::pow((s + 0.055) / 1.055, 2.4);
+            toLinear[static_cast<std::size_t>(i)] = static_cast<std::uint16_t>(std::lround(l * 65535.0));
+        }
+        for (int i = 0; i < 4096; i++) {
+            const double l = (i + 0.5) / 4096.0;
+            const double s = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+            toSrgb[static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(std::lround(std::clamp(s, 0.0, 1.0) * 255.0));
+        }
+        // The ends map back exactly, so opaque black and white survive a round trip
+        toSrgb[0] = 0;
+        toSrgb[4095] = 255;
+    }
+};
+
+const Tables& tables() {
+    static const Tables t;
+    return t;
+}
+
+// Byte offsets of alpha and the three color channels in a packed pixel
+struct Shifts {
+    int a, c0, c1, c2;
+};
+
+Shifts shifts_for(PixelLayout layout) {
+    switch (layout) {
+    case PixelLayout::ARGB8888:
+    case PixelLayout::ABGR8888: return Shifts{ 24, 16, 8, 0 };
+    case PixelLayout::RGBA8888:
+    case PixelLayout::BGRA8888: return Shifts{ 0, 24, 16, 8 };
+    }
+    return Shifts{ 24, 16, 8, 0 };
+}
+
+std::uint32_t channel(std::uint32_t v, int shift) {
+    return (v >> shift) & 0xffu;
+}
+
+std::uint32_t over_alpha(std::uint32_t as, std::uint32_t ad) {
+    return as + (ad * (255 - as) + 127) / 255;
+}
+
+std::uint32_t mulhi(std::uint32_t x, std::uint32_t y) {
+    return (x * y) >> 16;
+}
+
+// One pixel, scalar; the SIMD path produces the same values
+std::uint32_t blend_pixel(const Tables& t, std::uint32_t s, std::uint32_t d, const Shifts& sh) {
+    const std::uint32_t as = channel(s, sh.a), ad = channel(d, sh.a);
+    if (as == 0) return d;
+    if (as == 255) return s;
+    const std::uint32_t a16 = as * 257, ia16 = 65535 - a16;
+    std::uint32_t out = over_alpha(as, ad) << sh.a;
+    if (ad == 255) {
+        for (int shift : { sh.c0, sh.c1, sh.c2 }) {
+            const std::uint32_t l = mulhi(t.toLinear[channel(s, shift)], a16) + mulhi(t.toLinear[channel(d, shift)], ia16);
+            out |= std::uint32_t{t.toSrgb[l >> 4]} << shift;
+        }
+        return out;
+    }
+    // Translucent destination: weight it by its own alpha and divide by the combined
+    // coverage. wS + wD <= 65535, so the sums fit in 32 bits.
+    const std::uint32_t wD = mulhi(ad * 257, ia16), w = a16 + wD;
+    for (int shift : { sh.c0, sh.c1, sh.c2 }) {
+        const std::uint32_t l = (t.toLinear[channel(s, shift)] * a16 + t.toLinear[channel(d, shift)] * wD + w / 2) / w;
+        out |= std::uint32_t{t.toSrgb[l >> 4]} << shift;
+    }
+    return out;
+}
+
+} // namespace
+
+std::uint16_t srgb_to_linear(std::uint8_t v) {
+    return tables().toLinear[v];
+}
+
+std::uint8_t linear_to_srgb(std::uint16_t v) {
+    return tables().toSrgb[static_cast<std::size_t>(v >> 4)];
+}
+
+Rgb8 mix_srgb(Rgb8 a, Rgb8 b, float t) {
+    const auto w = static_cast<std::uint32_t>(std::clamp(t, 0.0f, 1.0f) * 65535.0f);
+    const auto mix = [w](std::uint8_t x, std::uint8_t y) {
+        const std::uint32_t l = mulhi(srgb_to_linear(x), 65535 - w) + mulhi(srgb_to_linear(y), w);
+        return linear_to_srgb(static_cast<std::uint16_t>(l));
+    };
+    return Rgb8{ mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b) };
+}
+
+void blend_over_srgb(std::uint32_t* dst, const std::uint32_t* src, std::size_t n, PixelLayout layout) {
+    const Tables& t = tables();
+    const Shifts sh = shifts_for(layout);
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    // Eight pixels at a time: decode through the table into channel planes, blend the
+    // planes with 16-bit multiplies, encode back. Blocks that are all opaque or all clear
+    // (most of any artwork) skip the math.
+    alignas(16) std::uint16_t s[3][8], d[3][8], a[8], ia[8], o[3][8];
+    for (; i + 8 <= n; i += 8) {
+        std::uint32_t minA = 255, maxA = 0;
+        for (std::size_t k = 0; k < 8; k++) {
+            const std::uint32_t as = channel(src[i + k], sh.a);
+            minA = std::min(minA, as);
+            maxA = std::max(maxA, as);
+        }
+        if (maxA == 0) continue;
+        if (minA == 255) {
+            std::copy(src + i, src + i + 8, dst + i);
+            continue;
+        }
+        for (std::size_t k = 0; k < 8; k++) {
+            const std::uint32_t sp = src[i + k], dp = dst[i + k];
+            const int cs[3] = { sh.c0, sh.c1, sh.c2 };
+            for (int c = 0; c < 3; c++) {
+                s[c][k] = t.toLinear[channel(sp, cs[c])];
+                d[c][k] = t.toLinear[channel(dp, cs[c])];
+            }
+            a[k] = static_cast<std::uint16_t>(channel(sp, sh.a) * 257);
+            ia[k] = static_cast<std::uint16_t>(65535 - a[k]);
+        }
+        const __m128i va = _mm_load_si128(reinterpret_cast<const __m128i*>(a));
+        const __m128i via = _mm_load_si128(reinterpret_cast<const __m128i*>(ia));
+        for (int c = 0; c < 3; c++) {
+            const __m128i vs = _mm_load_si128(reinterpret_cast<const __m128i*>(s[c]));
+            const __m128i vd = _mm_load_si128(reinterpret_cast<const __m128i*>(d[c]));
+            _mm_store_si128(reinterpret_cast<__m128i*>(o[c]), _mm_add_epi16(_mm_mulhi_epu16(vs, va), _mm_mulhi_epu16(vd, via)));
+        }
+        for (std::size_t k = 0; k < 8; k++) {
+            const std::uint32_t sp = src[i + k], dp = dst[i + k];
+            const std::uint32_t as = channel(sp, sh.a);
+            if (as == 0) continue;
+            if (as == 255) {
+                dst[i + k] = sp;
+                continue;
+            }
+            if (channel(dp, sh.a) != 255) {
+                dst[i + k] = blend_pixel(t, sp, dp, sh); // Needs the division
+                continue;
+            }
+            dst[i + k] = over_alpha(as, channel(dp, sh.a)) << sh.a
+                       | std::uint32_t{t.toSrgb[o[0][k] >> 4]} << sh.c0
+                       | std::uint32_t{t.toSrgb[o[1][k] >> 4]} << sh.c1
+                       | std::uint32_t{t.toSrgb[o[2][k] >> 4]} << sh.c2;
+        }
+    }
+#endif
+    for (; i < n; i++) dst[i] = blend_pixel(t, src[i], dst[i], sh);
+}
+
+void blend_over_srgb_pow(std::uint32_t* dst, const std::uint32_t* src, std::size_t n, PixelLayout layout) {
+    const Shifts sh = shifts_for(layout);
+    const auto to_linear = [](std::uint32_t v) {
+        const double s = v / 255.0;
+        return s <= 0.04045 ? s / 12.92 : std::pow((s + 0.055) / 1.055, 2.4);
+    };
+    const auto to_srgb = [](double l) {
+        const double s = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+        return static_cast<std::uint32_t>(std::lround(std::clamp(s, 0.0, 1.0) * 255.0));
+    };
+    for (std::size_t i = 0; i < n; i++) {
+        const std::uint32_t s = src[i], d = dst[i];
+        const std::uint32_t as = channel(s, sh.a), ad = channel(d, sh.a);
+        if (as == 0) continue;
+        const double a = as / 255.0, wD = ad / 255.0 * (1.0 - a), w = a + wD;
+        std::uint32_t out = over_alpha(as, ad) << sh.a;
+        for (int shift : { sh.c0, sh.c1, sh.c2 })
+            out |= to_srgb((to_linear(channel(s, shift)) * a + to_linear(channel(d, shift)) * wD) / w) << shift;
+        dst[i] = out;
+    }
+}
+
+const char* blend_kernel_name() {
+#if defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,165 @@
+// counter_text.cpp
+
+#include "counter_text.h"
+
+#include "artwork.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------
+// GlyphSet
+// ---------------------------------------------------------------------------------------
+
+bool GlyphSet::load(TTF_Font* font, const char* chars) {
+    height_ = TTF_FontHeight(font);
+    int digitAdvance = 0;
+    for (char c = '0'; c <= '9'; c++) {
+        int adv = 0;
+        if (TTF_GlyphMetrics32(font, static_cast<Uint32>(c), nullptr, nullptr, nullptr, nullptr, &adv) == 0)
+            digitAdvance = std::max(digitAdvance, adv);
+    }
+    TTF_GlyphMetrics32(font, ' ', nullptr, nullptr, nullptr, nullptr, &spaceAdvance_);
+
+    bool any = false;
+    for (const char* p = chars; *p; p++) {
+        const auto c = static_cast<unsigned char>(*p);
+        if (c >= glyphs_.size()) continue;
+        Glyph& g = glyphs_[c];
+        int adv = 0;
+        TTF_GlyphMetrics32(font, c, nullptr, nullptr, nullptr, nullptr, &adv);
+        g.advance = is_digit(*p) ? digitAdvance : adv;
+        if (c == ' ') continue;
+
+        SDL_Surface* surf = TTF_RenderGlyph32_Blended(font, c, SDL_Color{ 255, 255, 255, 255 });
+        if (surf && surf->format->format != SDL_PIXELFORMAT_ARGB8888) {
+            SDL_Surface* conv = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_ARGB8888, 0);
+            SDL_FreeSurface(surf);
+            surf = conv;
+        }
+        if (!surf) continue;
+        // Center the ink in the cell: keeps narrow digits like '1' balanced in tabular width
+        g.coverage.assign(static_cast<std::size_t>(g.advance) * static_cast<std::size_t>(height_), 0);
+        const int offset = (g.advance - surf->w) / 2;
+        SDL_LockSurface(surf);
+        for (int y = 0; y < std::min(surf->h, height_); y++) {
+            const auto* row = reinterpret_cast<const std::uint32_t*>(static_cast<const std::uint8_t*>(surf->pixels)
+                                                                     + static_cast<std::ptrdiff_t>(y) * surf->pitch);
+            for (int x = 0; x < surf->w; x++) {
+                const int cx = x + offset;
+                if (cx >= 0 && cx < g.advance)
+                    g.coverage[static_cast<std::size_t>(y * g.advance + cx)] = static_cast<std::uint8_t>(row[x] >> 24);
+            }
+        }
+        SDL_UnlockSurface(surf);
+        SDL_FreeSurface(surf);
+        any = true;
+    }
+    return any;
+}
+
+int GlyphSet::advance(char c) const {
+    const auto i = static_cast<unsigned char>(c);
+    return i < glyphs_.size() && glyphs_[i].advance ? glyphs_[i].advance : spaceAdvance_;
+}
+
+const std::uint8_t* GlyphSet::mask(char c) const {
+    const auto i = static_cast<unsigned char>(c);
+    return i < glyphs_.size() && !glyphs_[i].coverage.empty() ? glyphs_[i].coverage.data() : nullptr;
+}
+
+// ---------------------------------------------------------------------------------------
+// StreamingText
+// ---------------------------------------------------------------------------------------
+
+StreamingText::StreamingText(const GlyphSet& glyphs, int maxChars) : glyphs_(glyphs) {
+    int widest = glyphs_.advance(' ');
+    for (int c = 32; c < 127; c++) widest = std::max(widest, glyphs_.advance(static_cast<char>(c)));
+    capacity_ = std::max(widest * maxChars, 1);
+}
+
+void StreamingText::release() {
+    if (tex_) SDL_DestroyTexture(tex_);
+    tex_ = nullptr;
+    text_.clear();
+    width_ = 0;
+}
+
+bool StreamingText::create_texture(SDL_Renderer* r) {
+    // The renderer's own layout, so SDL uploads the pixels as they are
+    const PixelLayout layout = renderer_pixel_layout(r);
+    tex_ = SDL_CreateTexture(r, sdl_pixel_format(layout), SDL_TEXTUREACCESS_STREAMING, capacity_, std::max(glyphs_.height(), 1));
+    if (!tex_) return false;
+    SDL_SetTextureBlendMode(tex_, SDL_BLENDMODE_BLEND);
+    for (std::uint32_t a = 0; a < 256; a++) lut_[a] = pack_pixel(layout, 255, 255, 255, a);
+    text_.clear();
+    width_ = 0;
+    return true;
+}
+
+void StreamingText::set(SDL_Renderer* r, const char* text) {
+    if (!tex_ && !create_texture(r)) return;
+    if (text_ == text) return;
+
+    // Lay out the new text up to capacity
+    std::string next;
+    int nextWidth = 0;
+    for (const char* p = text; *p; p++) {
+        const int adv = glyphs_.advance(*p);
+        if (nextWidth + adv > capacity_) break;
+        next += *p;
+        nextWidth += adv;
+    }
+
+    // Characters before the first difference keep their pixels
+    std::size_t first = 0;
+    int x0 = 0;
+    while (first < next.size() && first < text_.size() && next[first] == text_[first]) x0 += glyphs_.advance(next[first++]);
+    const int x1 = std::max(width_, nextWidth);
+    text_ = next;
+    width_ = nextWidth;
+    ++stats_.updates;
+    if (x1 <= x0) return;
+
+    // Locked pixels are write-only: every pixel of the span gets written
+    const SDL_Rect span{ x0, 0, x1 - x0, glyphs_.height() };
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (SDL_LockTexture(tex_, &span, &pixels, &pitch) != 0) return;
+    auto* base = static_cast<std::uint8_t*>(pixels);
+    for (int y = 0; y < span.h; y++)
+        std::fill_n(reinterpret_cast<std::uint32_t*>(base + static_cast<std::ptrdiff_t>(y) * pitch),
+                    static_cast<std::size_t>(span.w), lut_[0]);
+    int x = 0;
+    for (std::size_t i = first; i < next.size(); i++) {
+        const int adv = glyphs_.advance(next[i]);
+        if (const std::uint8_t* m = glyphs_.mask(next[i])) {
+            for (int y = 0; y < span.h; y++) {
+                auto* row = reinterpret_cast<std::uint32_t*>(base + static_cast<std::ptrdiff_t>(y) * pitch) + x;
+                const std::uint8_t* cov = m + static_cast<std::ptrdiff_t>(y) * adv;
+                for (int c = 0; c < adv; c++) row[c] = lut_[cov[c]];
+            }
+            ++stats_.glyphsDrawn;
+        }
+        x += adv;
+    }
+    SDL_UnlockTexture(tex_);
+    stats_.pixelsWritten += static_cast<std::uint64_t>(span.w) * static_cast<std::uint64_t>(span.h);
+}
+
+void StreamingText::draw(SDL_Renderer* r, int x, int y, SDL_Color color, int align) const {
+    if (!tex_ || width_ == 0) return;
+    SDL_SetTextureColorMod(tex_, color.r, color.g, color.b);
+    const int left = align == 0 ? x : align == 1 ? x - width_ / 2 : x - width_;
+    const SDL_Rect src{ 0, 0, width_, glyphs_.height() };
+    const SDL_Rect dst{ left, y, width_, glyphs_.height() };
+    SDL_RenderCopy(r, tex_, &src, &dst);
+}
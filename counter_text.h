@@ -0,0 +1,83 @@
+// counter_text.h
+// Text that changes every frame: the decision clock and the offer counting up. Going
+// through SDL_ttf for those means a new surface, a format conversion and a texture per
+// frame. Here the glyphs of a small charset are rasterized once into coverage masks
+// (GlyphSet). Each counter (StreamingText) then keeps one SDL_TEXTUREACCESS_STREAMING
+// texture in a format the renderer takes natively and writes pixels straight into the
+// locked texture. Only the span from the first changed character on is locked and
+// redrawn. Digits share one advance width (tabular figures), so a ticking digit never
+// moves the characters after it.
+//
+// Glyphs are drawn white; color is a texture color mod, so changing color costs nothing.
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Coverage masks for the characters counters use, from one font. CPU only: one set can
+// serve every renderer.
+class GlyphSet {
+public:
+    static constexpr const char* kDefaultChars = "0123456789$.,:-+% sDEALNOo";
+
+    // Rasterize `chars` (ASCII) in `font`. False if SDL_ttf failed on all of them.
+    bool load(TTF_Font* font, const char* chars = kDefaultChars);
+
+    int height() const { return height_; }
+    // Advance of `c`; characters outside the set take the width of a space
+    int advance(char c) const;
+    // Coverage rows of `c` (advance(c) x height(), row-major), nullptr for blanks
+    const std::uint8_t* mask(char c) const;
+
+private:
+    struct Glyph {
+        int advance{0};
+        std::vector<std::uint8_t> coverage;
+    };
+
+    std::array<Glyph, 128> glyphs_{};
+    int height_{0};
+    int spaceAdvance_{0};
+};
+
+struct StreamingTextStats {
+    std::uint64_t updates{0};       // set() calls that changed the text
+    std::uint64_t glyphsDrawn{0};
+    std::uint64_t pixelsWritten{0};
+};
+
+class StreamingText {
+public:
+    // Room for `maxChars` of the widest glyph; longer text is cut off
+    StreamingText(const GlyphSet& glyphs, int maxChars);
+    StreamingText(const StreamingText&) = delete;
+    StreamingText& operator=(const StreamingText&) = delete;
+    ~StreamingText() { release(); }
+
+    // Change the text. Unchanged text costs a string compare.
+    void set(SDL_Renderer* r, const char* text);
+    // Draw at (x, y); `align` as in TextTextureCache::draw (0 left, 1 center, 2 right)
+    void draw(SDL_Renderer* r, int x, int y, SDL_Color color, int align = 1) const;
+
+    int width() const { return width_; }
+    const StreamingTextStats& stats() const { return stats_; }
+
+    // Destroy the texture. Must be called before the renderer goes away.
+    void release();
+
+private:
+    bool create_texture(SDL_Renderer* r);
+
+    const GlyphSet& glyphs_;
+    int capacity_{0};        // Texture width in pixels
+    SDL_Texture* tex_{nullptr};
+    std::array<std::uint32_t, 256> lut_{}; // Coverage -> white pixel in the texture's format
+    std::string text_;
+    int width_{0};
+    StreamingTextStats stats_;
+};
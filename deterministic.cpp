@@ -0,0 +1,78 @@
+// deterministic.cpp
+// Per-game seeds, transcript digests and transcript files.
+
+#include "deterministic.h"
+
+#include <cstdio>
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x54444E44u; // "DNDT"
+constexpr std::uint32_t kVersion = 1;
+
+constexpr std::uint32_t kFnvOffset = 2166136261u;
+constexpr std::uint32_t kFnvPrime = 16777619u;
+
+std::uint32_t fnv_u32(std::uint32_t h, std::uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        h ^= (v >> (8 * i)) & 0xffu;
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+} // namespace
+
+std::uint64_t game_seed(std::uint64_t runSeed, std::uint32_t gameId) {
+    // Two SplitMix rounds: neighbouring ids and seeds give unrelated streams
+    SplitMix64 mix{ runSeed };
+    mix.state = mix() ^ gameId;
+    return mix();
+}
+
+std::uint32_t transcript_digest(const DecisionRecord* calls, std::size_t n) {
+    std::uint32_t h = kFnvOffset;
+    for (std::size_t i = 0; i < n; i++) {
+        h = fnv_u32(h, calls[i].openedMask);
+        h = fnv_u32(h, calls[i].offerCents);
+        h = fnv_u32(h, static_cast<std::uint32_t>(calls[i].round) | static_cast<std::uint32_t>(calls[i].tookDeal) << 8);
+    }
+    return h;
+}
+
+bool verify_transcript(std::uint64_t runSeed, const GameTranscript& t, std::vector<DecisionRecord>& scratch) {
+    TranscriptPolicy policy{ t.dealRound };
+    const GameTranscript r = play_transcribed(runSeed, t.gameId, policy, scratch);
+    return r.winningsCents == t.winningsCents && r.dealRound == t.dealRound && r.digest == t.digest;
+}
+
+bool write_transcripts(const char* path, std::uint64_t runSeed, const std::vector<GameTranscript>& games) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) {
+        std::fprintf(stderr, "write_transcripts: cannot write %s\n", path);
+        return false;
+    }
+    const std::uint32_t header[4]{ kMagic, kVersion, static_cast<std::uint32_t>(runSeed),
+                                   static_cast<std::uint32_t>(runSeed >> 32) };
+    bool ok = std::fwrite(header, sizeof(header), 1, f) == 1
+           && std::fwrite(games.data(), sizeof(GameTranscript), games.size(), f) == games.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "write_transcripts: short write to %s\n", path);
+    return ok;
+}
+
+bool read_transcripts(const char* path, std::uint64_t& runSeed, std::vector<GameTranscript>& out) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::fprintf(stderr, "read_transcripts: cannot open %s\n", path);
+        return false;
+    }
+    std::uint32_t header[4]{};
+    if (std::fread(header, sizeof(header), 1, f) != 1 || header[0] != kMagic || header[1] != kVersion) {
+        std::fprintf(stderr, "read_transcripts: %s is not a transcript file\n", path);
+        std::fclose(f);
+        return false;
+    }
+    runSeed = header[2] | static_cast<std::uint64_t>(header[3]) << 32;
+    return read_whole_records(f, "read_transcripts", path, out);
+}
@@ -0,0 +1,89 @@
+// deterministic.h
+// Games that replay bit for bit on any build. Audits replay logged games on whatever
+// build is at hand (debug with sanitizers, release with -O3 -flto, another compiler) and
+// expect the identical outcome, so nothing in a game may depend on floating point or on
+// the standard library's distributions:
+//
+//   - randomness: SplitMix64 seeded per game from (run seed, game id), so any one game
+//     replays on its own, in any order and on any thread
+//   - shuffles and case order: sim_bounded() (integer multiply-shift)
+//   - offers: banker_offer() (integer, see game.h)
+//
+// The contestant's decisions are inputs, not outcomes: a transcript records at which
+// round (if any) the deal was taken, so policies with floating-point math still replay
+// exactly. Each transcript carries a digest of every banker call, so a replay is checked
+// on the whole course of the game, not just the payout.
+
+#pragma once
+
+#include "game_log.h"
+#include "simulator.h"
+
+#include <cstdint>
+#include <vector>
+
+// Small, fast, fully specified 64-bit engine (usable wherever simulator.h takes an Rng)
+struct SplitMix64 {
+    using result_type = std::uint64_t;
+    std::uint64_t state;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type{0}; }
+    result_type operator()() {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+};
+
+// Seed of game `gameId` in a run seeded with `runSeed`
+std::uint64_t game_seed(std::uint64_t runSeed, std::uint32_t gameId);
+
+// One game's inputs and outcome, 16 bytes on disk
+struct GameTranscript {
+    std::uint32_t gameId{0};
+    std::uint32_t winningsCents{0};
+    std::uint32_t digest{0};   // FNV-1a over each banker call's mask, offer, round, decision
+    std::uint8_t dealRound{0}; // Round the deal was taken, 0 = kept the case
+    std::uint8_t reserved[3]{};
+};
+static_assert(sizeof(GameTranscript) == 16, "GameTranscript is written to disk as-is");
+
+// Digest of a game's banker calls, as stored in GameTranscript::digest
+std::uint32_t transcript_digest(const DecisionRecord* calls, std::size_t n);
+
+// Play game `gameId` of run `runSeed` with `policy` and record it. `scratch` holds the
+// banker calls; reuse it across games to keep allocation out of the loop.
+template <class Policy>
+GameTranscript play_transcribed(std::uint64_t runSeed, std::uint32_t gameId, Policy& policy,
+                                std::vector<DecisionRecord>& scratch) {
+    SplitMix64 rng{ game_seed(runSeed, gameId) };
+    scratch.clear();
+    const GameResult r = play_game(rng, policy, gameId, &scratch);
+    GameTranscript t;
+    t.gameId = gameId;
+    t.winningsCents = r.winningsCents;
+    t.dealRound = r.dealRound;
+    t.digest = transcript_digest(scratch.data(), scratch.size());
+    return t;
+}
+
+// Contestant that repeats a transcript's decisions
+struct TranscriptPolicy {
+    int dealRound{0};
+
+    template <class Rng>
+    bool take_deal(std::uint32_t, int round, std::uint32_t, Rng&) {
+        return round == dealRound;
+    }
+};
+
+// Replay `t` and compare every field bit for bit
+bool verify_transcript(std::uint64_t runSeed, const GameTranscript& t, std::vector<DecisionRecord>& scratch);
+
+// Transcript files: a 16-byte header ("DNDT", version, run seed) followed by raw records.
+// Both return false (with a message) on I/O or format errors, including a file cut off
+// mid-record; read_transcripts still appends the whole records before the cut.
+bool write_transcripts(const char* path, std::uint64_t runSeed, const std::vector<GameTranscript>& games);
+bool read_transcripts(const char* path, std::uint64_t& runSeed, std::vector<GameTranscript>& out);
@@ -0,0 +1,86 @@
+// frame_pool.cpp
+
+#include "frame_pool.h"
+
+#include <array>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kGranule = 64;
+constexpr std::size_t kClasses = 32; // Frames up to 2 KiB
+constexpr std::size_t kSlabBytes = 64 * 1024;
+
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+struct Pool {
+    std::array<FreeFrame*, kClasses> freeLists{};
+    std::vector<std::unique_ptr<unsigned char[]>> slabs;
+    unsigned char* bump{nullptr}; // Uncarved rest of the newest slab
+    std::size_t bumpLeft{0};
+    FramePoolStats stats;
+
+    void* carve(std::size_t bytes) {
+        if (bumpLeft < bytes) {
+            // Start a new slab; the tail of the old one stays unused
+            slabs.push_back(std::make_unique<unsigned char[]>(kSlabBytes));
+            bump = slabs.back().get();
+            bumpLeft = kSlabBytes;
+            stats.slabBytes += kSlabBytes;
+        }
+        void* p = bump;
+        bump += bytes;
+        bumpLeft -= bytes;
+        return p;
+    }
+};
+
+Pool& pool() {
+    thread_local Pool p;
+    return p;
+}
+
+std::size_t class_of(std::size_t size) {
+    return (size + kGranule - 1) / kGranule - 1;
+}
+
+} // namespace
+
+void* frame_pool_alloc(std::size_t size) {
+    Pool& p = pool();
+    ++p.stats.allocations;
+    ++p.stats.live;
+    const std::size_t c = class_of(size);
+    if (size == 0 || c >= kClasses) {
+        ++p.stats.oversize;
+        return ::operator new(size);
+    }
+    if (FreeFrame* f = p.freeLists[c]) {
+        p.freeLists[c] = f->next;
+        ++p.stats.reused;
+        return f;
+    }
+    return p.carve((c + 1) * kGranule);
+}
+
+void frame_pool_free(void* ptr, std::size_t size) {
+    if (!ptr) return;
+    Pool& p = pool();
+    --p.stats.live;
+    const std::size_t c = class_of(size);
+    if (size == 0 || c >= kClasses) {
+        ::operator delete(ptr);
+        return;
+    }
+    auto* f = static_cast<FreeFrame*>(ptr);
+    f->next = p.freeLists[c];
+    p.freeLists[c] = f;
+}
+
+FramePoolStats frame_pool_stats() {
+    return pool().stats;
+}
@@ -0,0 +1,28 @@
+// frame_pool.h
+// Thread-local size-class pool for coroutine frames. Every show session suspends in a
+// coroutine for its whole life and creates short-lived child frames for each step, so a
+// server shard with thousands of sessions would otherwise hit the global allocator on every
+// step. Frames are carved from 64 KiB slabs into 64-byte size classes and recycled through
+// per-class free lists; nothing is locked because a frame is created, resumed and destroyed
+// on the thread that owns its session.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct FramePoolStats {
+    std::uint64_t allocations{0};
+    std::uint64_t reused{0};        // Served from a free list
+    std::uint64_t oversize{0};      // Too large for the pool, passed to operator new
+    std::uint64_t slabBytes{0};     // Memory held by the pool
+    std::uint64_t live{0};          // Frames currently allocated
+};
+
+// Allocate / free a frame of `size` bytes on the calling thread's pool. A frame must be
+// freed on the thread that allocated it.
+void* frame_pool_alloc(std::size_t size);
+void frame_pool_free(void* p, std::size_t size);
+
+// Counters for the calling thread's pool
+FramePoolStats frame_pool_stats();
@@ -0,0 +1,57 @@
+// game.cpp
+// Board model helpers: counting, round schedule, expected value and the banker offer.
+
+#include "game.h"
+
+int opened_count(std::uint32_t openedMask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(openedMask);
+#else
+    int n = 0;
+    while (openedMask) { openedMask &= openedMask - 1u; ++n; }
+    return n;
+#endif
+}
+
+int offer_round_for_opened(int opened) {
+    int total = 0;
+    for (int r = 0; r < kNumRounds; r++) {
+        total += kCasesPerRound[static_cast<std::size_t>(r)];
+        if (total == opened) return r + 1;
+        if (total > opened) break;
+    }
+    return -1;
+}
+
+int rounds_completed(int opened) {
+    int total = 0, rounds = 0;
+    for (int r = 0; r < kNumRounds; r++) {
+        total += kCasesPerRound[static_cast<std::size_t>(r)];
+        if (total > opened) break;
+        rounds = r + 1;
+    }
+    return rounds;
+}
+
+double expected_value(std::uint32_t openedMask) {
+    std::uint64_t sum = 0;
+    int n = 0;
+    for (int i = 0; i < kNumCases; i++) {
+        if (openedMask & (1u << i)) continue;
+        sum += kCaseValues[static_cast<std::size_t>(i)];
+        ++n;
+    }
+    return n ? static_cast<double>(sum) / n : 0.0;
+}
+
+std::uint32_t banker_offer(std::uint32_t openedMask, int round) {
+    // The banker starts stingy and approaches the expected value as the game goes on
+    std::uint64_t sum = 0;
+    std::uint32_t n = 0;
+    for (int i = 0; i < kNumCases; i++) {
+        if (openedMask & (1u << i)) continue;
+        sum += kCaseValues[static_cast<std::size_t>(i)];
+        ++n;
+    }
+    return banker_offer_for_sum(sum, n, round);
+}
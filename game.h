@@ -0,0 +1,67 @@
+// game.h
+// Core Deal or No Deal board model shared by the UI, the solver and the tools.
+// Case values are kept in integer cents so every build agrees on them exactly.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Number of briefcases on the board (US format)
+constexpr int kNumCases = 26;
+
+// Number of banker rounds in a full game
+constexpr int kNumRounds = 9;
+
+// Board values in cents, sorted ascending. Bit i of an opened-mask refers to kCaseValues[i].
+constexpr std::array<std::uint32_t, kNumCases> kCaseValues{
+    1u, 100u, 500u, 1000u, 2500u, 5000u, 7500u, 10000u, 20000u, 30000u, 40000u, 50000u, 75000u,
+    100000u, 500000u, 1000000u, 2500000u, 5000000u, 7500000u, 10000000u, 20000000u, 30000000u,
+    40000000u, 50000000u, 75000000u, 100000000u
+};
+
+// Cases opened before each banker call (cumulative: 6, 11, 15, 18, 20, 21, 22, 23, 24)
+constexpr std::array<int, kNumRounds> kCasesPerRound{ 6, 5, 4, 3, 2, 1, 1, 1, 1 };
+
+// Mask with every case value bit set
+constexpr std::uint32_t kAllCasesMask = (1u << kNumCases) - 1u;
+
+// A position in the game: which values have been revealed and which banker round we are in.
+// Packs into 30 bits (26 mask bits + 4 round bits) so it can be used directly as a hash key.
+struct StateKey {
+    std::uint32_t openedMask{0}; // Bit i set when kCaseValues[i] has been revealed
+    std::uint8_t round{0};       // Banker round reached so far (0 = before the first call)
+
+    std::uint32_t packed() const { return openedMask | (static_cast<std::uint32_t>(round) << kNumCases); }
+    static StateKey unpack(std::uint32_t p) {
+        return StateKey{ p & kAllCasesMask, static_cast<std::uint8_t>(p >> kNumCases) };
+    }
+};
+
+// Number of set bits (opened cases) in a mask
+int opened_count(std::uint32_t openedMask);
+
+// Round whose banker call happens once `opened` cases are revealed, or -1 if none does
+int offer_round_for_opened(int opened);
+
+// Banker round already completed after `opened` reveals (0..kNumRounds)
+int rounds_completed(int opened);
+
+// Mean of the unrevealed values, in cents (for display and policies; offers do not use it)
+double expected_value(std::uint32_t openedMask);
+
+// Banker offer in cents for the unrevealed values at the given round (1..kNumRounds).
+// Integer arithmetic only, so logged games replay to the cent on every build.
+std::uint32_t banker_offer(std::uint32_t openedMask, int round);
+
+// The same offer for `n` unrevealed cases summing to `sumCents`, for callers that keep the
+// sum up to date as cases open: (11 + 3r) / 40 of the mean (35% at round 1 rising to 95%
+// at round 9), rounded half up. Exact in 64 bits: the board sums to under 2^29 cents.
+inline std::uint32_t banker_offer_for_sum(std::uint64_t sumCents, std::uint32_t n, int round) {
+    static_assert(kNumRounds == 9, "offer fraction is written for nine rounds");
+    if (round < 1) round = 1;
+    if (round > kNumRounds) round = kNumRounds;
+    if (n == 0) return 0;
+    const std::uint64_t num = sumCents * static_cast<std::uint64_t>(11 + 3 * round), den = 40u * std::uint64_t{n};
+    return static_cast<std::uint32_t>((2 * num + den) / (2 * den));
+}
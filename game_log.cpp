@@ -0,0 +1,87 @@
+// game_log.cpp
+// Decision log files: an 8-byte header ("DNDL" + version) followed by raw records, or the
+// compact encoding from log_codec.h.
+
+#include "game_log.h"
+
+#include "log_codec.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x4C444E44u; // "DNDL"
+constexpr std::uint32_t kVersion = 1;
+
+bool compact_path(const char* path) {
+    const std::size_t n = std::strlen(path);
+    return n >= 5 && !std::strcmp(path + n - 5, ".dndc");
+}
+
+bool read_compact(const char* path, std::FILE* f, std::vector<DecisionRecord>& out) {
+    std::vector<std::uint8_t> bytes;
+    std::uint8_t chunk[65536];
+    std::size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+    const bool readError = std::ferror(f) != 0;
+    std::fclose(f);
+    if (readError) {
+        std::fprintf(stderr, "read_decision_log: error reading %s\n", path);
+        return false;
+    }
+    if (decode_decision_log(bytes.data(), bytes.size(), out)) return true;
+    std::fprintf(stderr, "read_decision_log: %s is damaged\n", path);
+    return false;
+}
+
+} // namespace
+
+bool write_decision_log(const char* path, const std::vector<DecisionRecord>& records) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) {
+        std::fprintf(stderr, "write_decision_log: cannot write %s\n", path);
+        return false;
+    }
+    bool ok;
+    if (compact_path(path)) {
+        std::vector<std::uint8_t> bytes;
+        encode_decision_log(records, bytes);
+        ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    } else {
+        const std::uint32_t header[2]{ kMagic, kVersion };
+        ok = std::fwrite(header, sizeof(header), 1, f) == 1
+          && std::fwrite(records.data(), sizeof(DecisionRecord), records.size(), f) == records.size();
+    }
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "write_decision_log: short write to %s\n", path);
+    return ok;
+}
+
+bool read_decision_log(const char* path, std::vector<DecisionRecord>& out) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::fprintf(stderr, "read_decision_log: cannot open %s\n", path);
+        return false;
+    }
+    std::uint32_t header[2]{};
+    const bool haveHeader = std::fread(header, sizeof(header), 1, f) == 1;
+    if (haveHeader && header[0] == kLogCodecMagic) {
+        std::rewind(f);
+        return read_compact(path, f, out);
+    }
+    if (!haveHeader || header[0] != kMagic || header[1] != kVersion) {
+        std::fprintf(stderr, "read_decision_log: %s is not a decision log\n", path);
+        std::fclose(f);
+        return false;
+    }
+    return read_whole_records(f, "read_decision_log", path, out);
+}
+
+long remaining_bytes(std::FILE* f) {
+    const long start = std::ftell(f);
+    if (start < 0 || std::fseek(f, 0, SEEK_END) != 0) return -1;
+    const long end = std::ftell(f);
+    if (std::fseek(f, start, SEEK_SET) != 0 || end < start) return -1;
+    return end - start;
+}
@@ -0,0 +1,64 @@
+// game_log.h
+// Recorded banker decisions. Every banker call a contestant faced (live or simulated)
+// becomes one fixed-size record, so logs can be split at any record boundary and
+// scanned by several threads at once.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// One banker call and what the contestant did
+struct DecisionRecord {
+    std::uint32_t gameId{0};
+    std::uint32_t openedMask{0}; // Values revealed when the offer was made (see game.h)
+    std::uint32_t offerCents{0};
+    std::uint8_t round{0};       // Banker round, 1..kNumRounds
+    std::uint8_t tookDeal{0};    // 1 = DEAL, 0 = NO DEAL
+    std::uint16_t reserved{0};
+};
+static_assert(sizeof(DecisionRecord) == 16, "DecisionRecord is written to disk as-is");
+
+// Write records to a new file (replacing any existing one). Paths ending in ".dndc" get
+// the compact encoding of log_codec.h. Returns false on I/O error.
+bool write_decision_log(const char* path, const std::vector<DecisionRecord>& records);
+
+// Append the records stored in `path` (either encoding) to `out`. Returns false if the
+// file is missing, unreadable, damaged or not a decision log; a raw log cut off mid-record
+// still appends its whole records first.
+bool read_decision_log(const char* path, std::vector<DecisionRecord>& out);
+
+// Bytes from the current position of `f` to its end, leaving the position where it was;
+// -1 if the file cannot be measured
+long remaining_bytes(std::FILE* f);
+
+// Append the rest of `f`, fixed-size records written as-is, to `out` and close `f`. `who`
+// and `path` label messages. Returns false on a seek or read error, or if the file ends
+// in a partial record; its whole records are appended first.
+template <class Record>
+bool read_whole_records(std::FILE* f, const char* who, const char* path, std::vector<Record>& out) {
+    // fread counts whole records only, so measure the body to notice a torn last one
+    const long body = remaining_bytes(f);
+    if (body < 0) {
+        std::fprintf(stderr, "%s: cannot size %s\n", who, path);
+        std::fclose(f);
+        return false;
+    }
+    // Read in 64 KiB chunks
+    Record chunk[65536 / sizeof(Record)];
+    std::size_t n;
+    while ((n = std::fread(chunk, sizeof(Record), std::size(chunk), f)) > 0)
+        out.insert(out.end(), chunk, chunk + n);
+    const bool readError = std::ferror(f) != 0;
+    std::fclose(f);
+    if (readError) {
+        std::fprintf(stderr, "%s: error reading %s\n", who, path);
+        return false;
+    }
+    if (body % static_cast<long>(sizeof(Record)) != 0) {
+        std::fprintf(stderr, "%s: %s ends in a partial record\n", who, path);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,324 @@
+// game_server.cpp
+// Replies for all frames in one received chunk are gathered into a single send(), and the
+// backend coalesces sends further until its next poll, so a client pipelining commands
+// costs roughly one write per batch rather than one per message.
+
+#include "game_server.h"
+
+#include "game_shard.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <utility>
+
+namespace {
+
+constexpr std::size_t kReplyCapacity = 16384;
+
+std::size_t slot_of(ConnId conn) {
+    return conn & 0xFFFFu;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------
+// SessionHost
+// ---------------------------------------------------------------------------------------
+
+SessionHost::SessionHost(const GameServerConfig& config, std::uint64_t seed, SessionSink& sink)
+    : config_(config), sink_(sink), sessions_(kNetMaxConns), rng_(seed) {
+    // No pacing on the server: only the decision countdown takes time
+    timing_.decisionTicks = config.decisionTicks;
+    for (Session& s : sessions_) s.host = this;
+}
+
+SessionHost::Session* SessionHost::find(ConnId conn) {
+    Session& s = sessions_[slot_of(conn)];
+    return (s.live && s.conn == conn) ? &s : nullptr;
+}
+
+void SessionHost::open(ConnId conn) {
+    Session& s = sessions_[slot_of(conn)];
+    if (s.live) end(s);
+    s.conn = conn;
+    s.live = true;
+    s.stateDirty = false;
+    s.show = ShowState{};
+    s.lastActivityTick = sched_.timers().now();
+    s.idleTimer = sched_.timers().schedule_in(config_.idleTicks, IdleTimer, conn);
+    ++live_;
+}
+
+void SessionHost::close(ConnId conn) {
+    if (Session* s = find(conn)) end(*s);
+}
+
+void SessionHost::close_all() {
+    for (Session& s : sessions_)
+        if (s.live) end(s);
+}
+
+void SessionHost::end(Session& s) {
+    if (outConn_ == s.conn) out_.clear();
+    s.fiber.stop();
+    sched_.timers().cancel(s.idleTimer);
+    s.live = false;
+    --live_;
+}
+
+void SessionHost::begin_output(ConnId conn) {
+    if (conn != outConn_) flush();
+    outConn_ = conn;
+}
+
+void SessionHost::flush() {
+    if (!out_.empty()) sink_.deliver(outConn_, out_.data(), out_.size());
+    out_.clear();
+}
+
+void SessionHost::command(ConnId conn, MsgType type, const std::uint8_t* body, std::size_t len) {
+    Session* s = find(conn);
+    if (!s) return;
+    // Activity only stamps the session; the idle timer checks the stamp when it fires
+    // instead of being rescheduled on every command
+    s->lastActivityTick = sched_.timers().now();
+    begin_output(conn);
+    switch (type) {
+    case MsgType::Ping:
+        append_frame(out_, MsgType::Pong, body, len);
+        return;
+    case MsgType::NewGame:
+        if (len < 1) return send_error(ErrorCode::BadFrame);
+        return new_game(*s, body[0]);
+    case MsgType::OpenCase:
+        if (len < 1) return send_error(ErrorCode::BadFrame);
+        return send_input(*s, ShowInput{ ShowInput::OpenCase, body[0] });
+    case MsgType::Deal:
+        return send_input(*s, ShowInput{ ShowInput::Deal, 0 });
+    case MsgType::NoDeal:
+        return send_input(*s, ShowInput{ ShowInput::NoDeal, 0 });
+    default:
+        return send_error(ErrorCode::BadFrame);
+    }
+}
+
+void SessionHost::new_game(Session& s, std::uint8_t contestantCase) {
+    if (contestantCase >= kNumCases) return send_error(ErrorCode::BadCase);
+    for (int i = 0; i < kNumCases; i++) s.show.cases[static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(i);
+    for (std::uint32_t i = kNumCases - 1; i > 0; i--) std::swap(s.show.cases[i], s.show.cases[sim_bounded(rng_, i + 1)]);
+    s.fiber.start(sched_, run_show(s.fiber, s, s.show, timing_));
+    send_input(s, ShowInput{ ShowInput::PickCase, contestantCase });
+}
+
+void SessionHost::send_input(Session& s, const ShowInput& in) {
+    // No show running (or it already ended): nothing accepts commands
+    if (!s.fiber.post(in)) return send_error(ErrorCode::NotAllowed);
+    // One State per command, however many steps the flow went through
+    if (s.stateDirty) send_state(s);
+}
+
+void SessionHost::advance(std::uint64_t tick) {
+    fired_.clear();
+    sched_.advance(tick, fired_);
+
+    // Shows that moved on by themselves (decision countdown ran out)
+    for (Session* s : dirty_)
+        if (s->live && s->stateDirty) {
+            begin_output(s->conn);
+            send_state(*s);
+        }
+    dirty_.clear();
+
+    for (const TimerEvent& ev : fired_) {
+        Session* s = find(static_cast<ConnId>(ev.payload));
+        if (!s || ev.kind != IdleTimer || ev.id != s->idleTimer) continue;
+        const std::uint64_t idleUntil = s->lastActivityTick + config_.idleTicks;
+        if (idleUntil > sched_.timers().now()) {
+            s->idleTimer = sched_.timers().schedule_at(idleUntil, IdleTimer, s->conn);
+            continue;
+        }
+        const ConnId conn = s->conn;
+        end(*s);
+        sink_.drop(conn);
+    }
+}
+
+int SessionHost::wait_ms(std::uint64_t nowMs, int maxWaitMs) const {
+    // Sleep until the next timer's tick starts (the wheel only looks one level-0 turn ahead)
+    const TimerWheel& timers = sched_.timers();
+    const std::uint64_t limit = static_cast<std::uint64_t>(maxWaitMs) / config_.tickMs + 1;
+    const std::uint64_t dueMs = (timers.now() + timers.ticks_until_next(limit)) * config_.tickMs;
+    return static_cast<int>(std::min<std::uint64_t>(dueMs > nowMs ? dueMs - nowMs : 0, static_cast<std::uint64_t>(maxWaitMs)));
+}
+
+void SessionHost::Session::on_step(const ShowState&) {
+    if (stateDirty) return;
+    stateDirty = true;
+    host->dirty_.push_back(this);
+}
+
+void SessionHost::Session::on_rejected(const ShowInput&, ErrorCode why) {
+    host->begin_output(conn);
+    host->send_error(why);
+}
+
+void SessionHost::send_state(Session& s) {
+    const ShowState& show = s.show;
+    StateMsg msg{};
+    msg.openedMask = show.openedMask;
+    msg.openedCases = show.openedCases;
+    msg.offerCents = show.offerCents;
+    msg.winningsCents = show.winningsCents;
+    msg.round = show.round;
+    msg.phase = static_cast<std::uint8_t>(show.phase);
+    msg.toOpen = show.toOpen;
+    append_frame(out_, MsgType::State, &msg, sizeof(msg));
+    s.stateDirty = false;
+}
+
+void SessionHost::send_error(ErrorCode code) {
+    const auto c = static_cast<std::uint8_t>(code);
+    append_frame(out_, MsgType::Error, &c, 1);
+}
+
+// ---------------------------------------------------------------------------------------
+// GameServer
+// ---------------------------------------------------------------------------------------
+
+GameServer::GameServer(const GameServerConfig& config)
+    : config_(config), epoch_(std::chrono::steady_clock::now()), readers_(kNetMaxConns) {}
+
+GameServer::~GameServer() {
+    for (auto& shard : shards_) shard->stop();
+}
+
+bool GameServer::start() {
+    net_ = make_net_backend(config_.backend);
+    if (!net_) {
+        std::fprintf(stderr, "game server: no network backend available\n");
+        return false;
+    }
+    if (config_.shards == 0) {
+        host_ = std::make_unique<SessionHost>(config_, config_.seed, static_cast<SessionSink&>(*this));
+    } else {
+        replies_ = std::make_unique<MpscQueue<ShardReply>>(kReplyCapacity);
+        if (!net_->watch_wakeup(replies_->wake_fd())) {
+            std::fprintf(stderr, "game server: cannot watch the shard reply queue\n");
+            return false;
+        }
+        for (std::uint32_t i = 0; i < config_.shards; i++) {
+            shards_.push_back(std::make_unique<GameShard>(config_, config_.seed + i, *replies_));
+            shards_.back()->start();
+        }
+    }
+    port_ = net_->listen(config_.host, config_.port);
+    return port_ >= 0;
+}
+
+std::uint64_t GameServer::elapsed_ms() const {
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - epoch_).count();
+    return static_cast<std::uint64_t>(ms);
+}
+
+void GameServer::run(const std::atomic<bool>& running) {
+    while (running.load(std::memory_order_relaxed)) poll_once(100);
+    // Show frames come from this thread's pool; release them here, not in the destructor
+    if (host_) host_->close_all();
+}
+
+void GameServer::poll_once(int maxWaitMs) {
+    int waitMs = maxWaitMs;
+    if (host_) waitMs = host_->wait_ms(elapsed_ms(), maxWaitMs);
+    // Shards only signal the reply queue's eventfd while this thread is marked idle
+    else if (!replies_->prepare_wait()) waitMs = 0;
+
+    events_.clear();
+    net_->poll(events_, waitMs);
+    if (replies_) replies_->finish_wait();
+
+    for (const NetEvent& ev : events_) {
+        switch (ev.type) {
+        case NetEventType::Accepted:
+            readers_[slot_of(ev.conn)] = FrameReader{};
+            if (host_) host_->open(ev.conn);
+            else post(ev.conn, ShardCommand::Open, MsgType::Ping, nullptr, 0);
+            break;
+        case NetEventType::Data:
+            on_data(ev.conn, ev.data, ev.size);
+            break;
+        case NetEventType::Closed:
+            if (host_) host_->close(ev.conn);
+            else post(ev.conn, ShardCommand::Close, MsgType::Ping, nullptr, 0);
+            break;
+        case NetEventType::Wakeup:
+            break;
+        }
+    }
+
+    if (host_) {
+        host_->flush();
+        host_->advance(elapsed_ms() / config_.tickMs);
+        host_->flush();
+    } else {
+        drain_replies();
+    }
+}
+
+void GameServer::on_data(ConnId conn, const std::uint8_t* data, std::size_t n) {
+    out_.clear();
+    const bool ok = readers_[slot_of(conn)].feed(data, n, [&](MsgType type, const std::uint8_t* body, std::size_t len) {
+        ++frames_;
+        if (host_) host_->command(conn, type, body, len);
+        // Pings need no game state: answer them here instead of round-tripping via a shard
+        else if (type == MsgType::Ping) append_frame(out_, MsgType::Pong, body, len);
+        else post(conn, ShardCommand::Command, type, body, len);
+    });
+    if (!out_.empty()) net_->send(conn, out_.data(), out_.size());
+    if (!ok) {
+        if (host_) host_->close(conn);
+        else post(conn, ShardCommand::Close, MsgType::Ping, nullptr, 0);
+        const auto code = static_cast<std::uint8_t>(ErrorCode::BadFrame);
+        out_.clear();
+        append_frame(out_, MsgType::Error, &code, 1);
+        net_->send(conn, out_.data(), out_.size());
+        net_->close(conn);
+    }
+}
+
+void GameServer::post(ConnId conn, std::uint8_t op, MsgType type, const std::uint8_t* body, std::size_t len) {
+    ShardCommand cmd;
+    cmd.conn = conn;
+    cmd.op = op;
+    cmd.type = type;
+    cmd.argLen = static_cast<std::uint8_t>(std::min<std::size_t>(len, 1));
+    cmd.arg = len ? body[0] : 0;
+    GameShard& shard = *shards_[slot_of(conn) % shards_.size()];
+    // A full inbox means the shard is behind; it may itself be waiting for reply space, so
+    // drain replies while retrying
+    while (!shard.post(cmd)) {
+        drain_replies();
+        std::this_thread::yield();
+    }
+}
+
+void GameServer::drain_replies() {
+    ShardReply batch[256];
+    std::size_t n;
+    while ((n = replies_->pop_batch(batch, 256)) > 0) {
+        for (std::size_t i = 0; i < n; i++) {
+            const ShardReply& r = batch[i];
+            if (r.len) net_->send(r.conn, r.bytes, r.len);
+            if (r.drop) net_->close(r.conn);
+        }
+    }
+}
+
+void GameServer::deliver(ConnId conn, const std::uint8_t* data, std::size_t n) {
+    net_->send(conn, data, n);
+}
+
+void GameServer::drop(ConnId conn) {
+    net_->close(conn);
+}
@@ -0,0 +1,153 @@
+// game_server.h
+// Hosted multi-session mode: each TCP connection runs its own game, driven by the commands
+// in net_protocol.h. One loop thread owns the network backend; the games themselves live
+// in SessionHosts, either on that same thread or spread over shard threads (game_shard.h)
+// that receive commands through lock-free queues. Each host runs a timer wheel for the
+// decision countdown (no answer in time = NO DEAL) and idle disconnects.
+
+#pragma once
+
+#include "game.h"
+#include "net_backend.h"
+#include "net_protocol.h"
+#include "show_flow.h"
+#include "timer_wheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+struct GameServerConfig {
+    const char* host{"127.0.0.1"};
+    std::uint16_t port{7777};          // 0 = any free port
+    NetBackendKind backend{NetBackendKind::Auto};
+    std::uint32_t shards{0};           // Game threads; 0 = play on the network thread
+    std::uint32_t tickMs{10};          // Timer wheel resolution
+    std::uint32_t decisionTicks{3000}; // Time to answer a banker offer
+    std::uint32_t idleTicks{30000};    // Disconnect after this long without a command
+    std::uint64_t seed{0x5eed};        // Case shuffles
+};
+
+// Where a SessionHost's output goes: bytes for a connection, or a connection to drop
+class SessionSink {
+public:
+    virtual ~SessionSink() = default;
+    virtual void deliver(ConnId conn, const std::uint8_t* data, std::size_t n) = 0;
+    virtual void drop(ConnId conn) = 0;
+};
+
+// Game state and timers for the sessions owned by one thread. Each session's game is a
+// show_flow.h fiber; commands become fiber inputs. Replies are buffered per connection
+// and handed to the sink in one piece when the host moves on to another connection or
+// flush() is called.
+class SessionHost {
+public:
+    SessionHost(const GameServerConfig& config, std::uint64_t seed, SessionSink& sink);
+
+    void open(ConnId conn);
+    void close(ConnId conn); // Client went away: forget the session without output
+    void close_all();        // Release every session (before the owning thread exits)
+
+    // Apply one client command
+    void command(ConnId conn, MsgType type, const std::uint8_t* body, std::size_t len);
+    void flush();
+
+    // Fire every timer due up to `tick`
+    void advance(std::uint64_t tick);
+
+    // Milliseconds until the next timer is due (at `nowMs` since the host's epoch), capped
+    // at `maxWaitMs`
+    int wait_ms(std::uint64_t nowMs, int maxWaitMs) const;
+
+    std::size_t live() const { return live_; }
+
+private:
+    enum TimerKind : std::uint32_t { IdleTimer = 1 };
+
+    struct Session final : ShowStage {
+        SessionHost* host{nullptr};
+        ConnId conn{0};
+        bool live{false};
+        bool stateDirty{false};
+        ShowFiber fiber;
+        ShowState show;
+        TimerId idleTimer{kInvalidTimer};
+        std::uint64_t lastActivityTick{0};
+
+        void on_step(const ShowState&) override;
+        void on_rejected(const ShowInput&, ErrorCode why) override;
+    };
+
+    Session* find(ConnId conn);
+    void end(Session& s);
+    void begin_output(ConnId conn);
+    void new_game(Session& s, std::uint8_t contestantCase);
+    void send_input(Session& s, const ShowInput& in);
+    void send_state(Session& s);
+    void send_error(ErrorCode code);
+
+    GameServerConfig config_;
+    ShowTiming timing_;
+    SessionSink& sink_;
+    std::vector<Session> sessions_; // Indexed by connection slot
+    std::size_t live_{0};
+    ShowScheduler sched_;
+    std::mt19937_64 rng_;
+    std::vector<TimerEvent> fired_;
+    std::vector<Session*> dirty_;   // Sessions whose show changed during advance()
+    std::vector<std::uint8_t> out_; // Buffered replies for outConn_
+    ConnId outConn_{0};
+};
+
+class GameShard;
+struct ShardReply;
+template <class T> class MpscQueue;
+
+class GameServer final : private SessionSink {
+public:
+    explicit GameServer(const GameServerConfig& config);
+    ~GameServer() override;
+
+    // Create the backend, start shard threads and listen. False (with a message on stderr)
+    // on failure.
+    bool start();
+
+    // Port actually bound (useful with port 0)
+    int port() const { return port_; }
+
+    // One loop iteration: wait for network activity (at most `maxWaitMs`, less when a timer
+    // is due), handle every received command and fire expired timers
+    void poll_once(int maxWaitMs);
+
+    // Loop until `running` is cleared, then end every inline session. A server driven by
+    // poll_once() directly must be destroyed on the thread that polled it.
+    void run(const std::atomic<bool>& running);
+
+    const NetBackend& backend() const { return *net_; }
+    std::uint64_t frames_handled() const { return frames_; }
+
+private:
+    void deliver(ConnId conn, const std::uint8_t* data, std::size_t n) override;
+    void drop(ConnId conn) override;
+
+    void on_data(ConnId conn, const std::uint8_t* data, std::size_t n);
+    void post(ConnId conn, std::uint8_t op, MsgType type, const std::uint8_t* body, std::size_t len);
+    void drain_replies();
+    std::uint64_t elapsed_ms() const;
+
+    GameServerConfig config_;
+    std::unique_ptr<NetBackend> net_;
+    int port_{-1};
+    std::chrono::steady_clock::time_point epoch_;
+    std::vector<FrameReader> readers_; // Indexed by connection slot
+    std::vector<NetEvent> events_;
+    std::vector<std::uint8_t> out_;
+    std::uint64_t frames_{0};
+
+    std::unique_ptr<SessionHost> host_;              // Inline mode
+    std::vector<std::unique_ptr<GameShard>> shards_; // Sharded mode
+    std::unique_ptr<MpscQueue<ShardReply>> replies_; // Shards -> network thread
+};
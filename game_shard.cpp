@@ -0,0 +1,93 @@
+// game_shard.cpp
+
+#include "game_shard.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr std::size_t kInboxCapacity = 8192;
+constexpr std::size_t kBatch = 256;
+
+} // namespace
+
+GameShard::GameShard(const GameServerConfig& config, std::uint64_t seed, MpscQueue<ShardReply>& replies)
+    : config_(config), inbox_(kInboxCapacity), replies_(replies), host_(config, seed, *this),
+      epoch_(std::chrono::steady_clock::now()) {}
+
+GameShard::~GameShard() {
+    stop();
+}
+
+void GameShard::start() {
+    thread_ = std::thread([this] { run(); });
+}
+
+void GameShard::stop() {
+    if (!thread_.joinable()) return;
+    // Nobody drains replies once the server shuts down
+    discardReplies_.store(true, std::memory_order_relaxed);
+    ShardCommand cmd;
+    cmd.op = ShardCommand::Stop;
+    while (!post(cmd)) std::this_thread::yield();
+    thread_.join();
+}
+
+std::uint64_t GameShard::elapsed_ms() const {
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - epoch_).count();
+    return static_cast<std::uint64_t>(ms);
+}
+
+void GameShard::run() {
+    ShardCommand batch[kBatch];
+    for (;;) {
+        const std::size_t n = inbox_.pop_batch(batch, kBatch);
+        for (std::size_t i = 0; i < n; i++) {
+            const ShardCommand& c = batch[i];
+            switch (c.op) {
+            case ShardCommand::Open: host_.open(c.conn); break;
+            case ShardCommand::Close: host_.close(c.conn); break;
+            case ShardCommand::Command: host_.command(c.conn, c.type, &c.arg, c.argLen); break;
+            case ShardCommand::Stop: host_.close_all(); return; // Show frames belong to this thread
+            default: break;
+            }
+        }
+        host_.flush();
+
+        const std::uint64_t nowMs = elapsed_ms();
+        host_.advance(nowMs / config_.tickMs);
+        host_.flush();
+        // Only an empty inbox puts the shard to sleep; a full batch means more is waiting
+        if (n == 0) inbox_.wait(host_.wait_ms(elapsed_ms(), 100));
+    }
+}
+
+void GameShard::push_reply(const ShardReply& reply) {
+    // The network thread drains replies whenever the inbox it feeds is full, so this only
+    // spins while it catches up
+    while (!replies_.try_push(reply)) {
+        if (discardReplies_.load(std::memory_order_relaxed)) return;
+        std::this_thread::yield();
+    }
+}
+
+void GameShard::deliver(ConnId conn, const std::uint8_t* data, std::size_t n) {
+    ShardReply r;
+    r.conn = conn;
+    while (n > 0) {
+        const std::size_t len = std::min(n, ShardReply::kBytes);
+        std::memcpy(r.bytes, data, len);
+        r.len = static_cast<std::uint8_t>(len);
+        push_reply(r);
+        data += len;
+        n -= len;
+    }
+}
+
+void GameShard::drop(ConnId conn) {
+    ShardReply r;
+    r.conn = conn;
+    r.drop = 1;
+    push_reply(r);
+}
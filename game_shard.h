@@ -0,0 +1,68 @@
+// game_shard.h
+// A game shard: one thread owning the sessions of every connection mapped to it. The
+// network thread posts decoded commands into the shard's MPSC inbox; the shard applies them
+// in batches and pushes reply chunks into a queue shared by all shards, which the network
+// thread drains. Neither direction takes a lock, and the shard sleeps on its inbox's
+// eventfd only when it has nothing queued and no timer due.
+
+#pragma once
+
+#include "game_server.h"
+#include "mpsc_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// Command for a shard. Game commands carry at most one argument byte.
+struct ShardCommand {
+    enum Op : std::uint8_t { Open, Close, Command, Stop };
+    ConnId conn{0};
+    std::uint8_t op{Command};
+    MsgType type{MsgType::Ping};
+    std::uint8_t argLen{0};
+    std::uint8_t arg{0};
+};
+
+// Fixed-size reply chunk from a shard to the network thread. Chunks for one connection
+// arrive in order (a connection always maps to the same shard).
+struct ShardReply {
+    static constexpr std::size_t kBytes = 52;
+    ConnId conn{0};
+    std::uint8_t drop{0}; // Close the connection after sending `bytes`
+    std::uint8_t len{0};
+    std::uint8_t bytes[kBytes]{};
+};
+
+class GameShard final : private SessionSink {
+public:
+    GameShard(const GameServerConfig& config, std::uint64_t seed, MpscQueue<ShardReply>& replies);
+    ~GameShard() override;
+
+    GameShard(const GameShard&) = delete;
+    GameShard& operator=(const GameShard&) = delete;
+
+    void start();
+
+    // Any thread; false when the inbox is full
+    bool post(const ShardCommand& cmd) { return inbox_.try_push(cmd); }
+
+    // Apply queued commands (dropping their replies) and join the thread
+    void stop();
+
+private:
+    void run();
+    void deliver(ConnId conn, const std::uint8_t* data, std::size_t n) override;
+    void drop(ConnId conn) override;
+    void push_reply(const ShardReply& reply);
+    std::uint64_t elapsed_ms() const;
+
+    GameServerConfig config_;
+    MpscQueue<ShardCommand> inbox_;
+    MpscQueue<ShardReply>& replies_;
+    SessionHost host_;
+    std::chrono::steady_clock::time_point epoch_;
+    std::atomic<bool> discardReplies_{false};
+    std::thread thread_;
+};
@@ -0,0 +1,357 @@
+// image_codec.cpp
+// QOI follows the published specification (qoiformat.org) byte for byte, so files from
+// any QOI encoder load and ours open in any QOI viewer.
+
+#include "image_codec.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+namespace {
+
+constexpr std::uint8_t kOpIndex = 0x00; // 00xxxxxx
+constexpr std::uint8_t kOpDiff = 0x40;  // 01xxxxxx
+constexpr std::uint8_t kOpLuma = 0x80;  // 10xxxxxx
+constexpr std::uint8_t kOpRun = 0xc0;   // 11xxxxxx
+constexpr std::uint8_t kOpRgb = 0xfe;
+constexpr std::uint8_t kOpRgba = 0xff;
+constexpr std::uint8_t kMask2 = 0xc0;
+constexpr std::size_t kHeaderBytes = 14;
+constexpr std::uint8_t kEndMarker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+constexpr std::uint64_t kMaxPixels = 64u << 20;
+
+struct Rgba {
+    std::uint8_t r, g, b, a;
+};
+
+unsigned hash(const Rgba& p) {
+    return (p.r * 3u + p.g * 5u + p.b * 7u + p.a * 11u) % 64u;
+}
+
+bool same(const Rgba& x, const Rgba& y) {
+    return x.r == y.r && x.g == y.g && x.b == y.b && x.a == y.a;
+}
+
+std::uint32_t read_be32(const std::uint8_t* p) {
+    return std::uint32_t{p[0]} << 24 | std::uint32_t{p[1]} << 16 | std::uint32_t{p[2]} << 8 | p[3];
+}
+
+void write_be32(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    out.push_back(static_cast<std::uint8_t>(v >> 24));
+    out.push_back(static_cast<std::uint8_t>(v >> 16));
+    out.push_back(static_cast<std::uint8_t>(v >> 8));
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+// Channels of a packed pixel, the inverse of pack_pixel()
+Rgba unpack_pixel(PixelLayout layout, std::uint32_t v) {
+    const auto byte = [v](int shift) { return static_cast<std::uint8_t>(v >> shift); };
+    switch (layout) {
+    case PixelLayout::ARGB8888: return Rgba{ byte(16), byte(8), byte(0), byte(24) };
+    case PixelLayout::ABGR8888: return Rgba{ byte(0), byte(8), byte(16), byte(24) };
+    case PixelLayout::RGBA8888: return Rgba{ byte(24), byte(16), byte(8), byte(0) };
+    case PixelLayout::BGRA8888: return Rgba{ byte(8), byte(16), byte(24), byte(0) };
+    }
+    return Rgba{ 0, 0, 0, 0 };
+}
+
+// The decode loop, specialized per layout so packing is a few shifts with no branch
+template <PixelLayout L>
+bool qoi_decode_pixels(const std::uint8_t* data, std::size_t size, std::uint32_t* out, std::size_t count) {
+    Rgba index[64] = {};
+    Rgba px{ 0, 0, 0, 255 };
+    std::size_t p = kHeaderBytes;
+    const std::size_t end = size - sizeof(kEndMarker);
+    std::uint32_t run = 0;
+    std::uint32_t packed = pack_pixel(L, px.r, px.g, px.b, px.a);
+    for (std::size_t i = 0; i < count; i++) {
+        if (run > 0) {
+            --run;
+        } else {
+            if (p >= end) return false; // Truncated
+            const std::uint8_t b1 = data[p++];
+            if (b1 == kOpRgb) {
+                if (p + 3 > end) return false;
+                px.r = data[p];
+                px.g = data[p + 1];
+                px.b = data[p + 2];
+                p += 3;
+            } else if (b1 == kOpRgba) {
+                if (p + 4 > end) return false;
+                px = Rgba{ data[p], data[p + 1], data[p + 2], data[p + 3] };
+                p += 4;
+            } else if ((b1 & kMask2) == kOpIndex) {
+                px = index[b1];
+            } else if ((b1 & kMask2) == kOpDiff) {
+                px.r = static_cast<std::uint8_t>(px.r + ((b1 >> 4) & 3) - 2);
+                px.g = static_cast<std::uint8_t>(px.g + ((b1 >> 2) & 3) - 2);
+                px.b = static_cast<std::uint8_t>(px.b + (b1 & 3) - 2);
+            } else if ((b1 & kMask2) == kOpLuma) {
+                if (p >= end) return false;
+                const std::uint8_t b2 = data[p++];
+                const int vg = (b1 & 0x3f) - 32;
+                px.r = static_cast<std::uint8_t>(px.r + vg - 8 + ((b2 >> 4) & 0x0f));
+                px.g = static_cast<std::uint8_t>(px.g + vg);
+                px.b = static_cast<std::uint8_t>(px.b + vg - 8 + (b2 & 0x0f));
+            } else {
+                run = b1 & 0x3f; // Run of run + 1: this pixel and `run` more
+            }
+            index[hash(px)] = px;
+            packed = pack_pixel(L, px.r, px.g, px.b, px.a);
+        }
+        out[i] = packed;
+    }
+    return true;
+}
+
+// Next whitespace/comment-separated token of a PNM header
+bool pnm_token(const std::uint8_t* data, std::size_t size, std::size_t& p, char* tok, std::size_t n) {
+    while (p < size) {
+        if (data[p] == '#') {
+            while (p < size && data[p] != '\n') p++;
+        } else if (data[p] == ' ' || data[p] == '\t' || data[p] == '\r' || data[p] == '\n') {
+            p++;
+        } else {
+            break;
+        }
+    }
+    std::size_t len = 0;
+    while (p < size && len + 1 < n && data[p] > ' ') tok[len++] = static_cast<char>(data[p++]);
+    tok[len] = '\0';
+    return len > 0;
+}
+
+// Binary PPM (P6, RGB) or PAM (P7, RGB or RGB_ALPHA), 8 bits per channel
+bool pnm_decode(const std::uint8_t* data, std::size_t size, PixelLayout layout, Image& out) {
+    char tok[32];
+    std::size_t p = 0;
+    long w = 0, h = 0, depth = 3, maxval = 0;
+    if (!pnm_token(data, size, p, tok, sizeof(tok))) return false;
+    if (!std::strcmp(tok, "P6")) {
+        char a[32], b[32], c[32];
+        if (!pnm_token(data, size, p, a, sizeof(a)) || !pnm_token(data, size, p, b, sizeof(b))
+            || !pnm_token(data, size, p, c, sizeof(c)))
+            return false;
+        w = std::atol(a);
+        h = std::atol(b);
+        maxval = std::atol(c);
+        p++; // The single whitespace byte before the raster
+    } else if (!std::strcmp(tok, "P7")) {
+        char val[32];
+        while (pnm_token(data, size, p, tok, sizeof(tok)) && std::strcmp(tok, "ENDHDR")) {
+            if (!pnm_token(data, size, p, val, sizeof(val))) return false;
+            if (!std::strcmp(tok, "WIDTH")) w = std::atol(val);
+            else if (!std::strcmp(tok, "HEIGHT")) h = std::atol(val);
+            else if (!std::strcmp(tok, "DEPTH")) depth = std::atol(val);
+            else if (!std::strcmp(tok, "MAXVAL")) maxval = std::atol(val);
+        }
+        p++;
+    } else {
+        return false;
+    }
+    if (w <= 0 || h <= 0 || maxval != 255 || (depth != 3 && depth != 4)
+        || static_cast<std::uint64_t>(w) * static_cast<std::uint64_t>(h) > kMaxPixels)
+        return false;
+    const std::size_t count = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+    const auto stride = static_cast<std::size_t>(depth);
+    if (p > size || size - p < count * stride) return false;
+    out.width = static_cast<int>(w);
+    out.height = static_cast<int>(h);
+    out.layout = layout;
+    out.pixels.resize(count);
+    const std::uint8_t* s = data + p;
+    for (std::size_t i = 0; i < count; i++, s += stride)
+        out.pixels[i] = pack_pixel(layout, s[0], s[1], s[2], depth == 4 ? s[3] : 255u);
+    return true;
+}
+
+} // namespace
+
+const char* pixel_layout_name(PixelLayout layout) {
+    switch (layout) {
+    case PixelLayout::ARGB8888: return "argb8888";
+    case PixelLayout::ABGR8888: return "abgr8888";
+    case PixelLayout::RGBA8888: return "rgba8888";
+    case PixelLayout::BGRA8888: return "bgra8888";
+    }
+    return "?";
+}
+
+bool parse_pixel_layout(const char* name, PixelLayout& layout) {
+    for (PixelLayout l : { PixelLayout::ARGB8888, PixelLayout::ABGR8888, PixelLayout::RGBA8888, PixelLayout::BGRA8888 }) {
+        if (!::strcasecmp(name, pixel_layout_name(l))) {
+            layout = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+void convert_image(Image& img, PixelLayout layout) {
+    if (img.layout == layout) return;
+    for (std::uint32_t& v : img.pixels) {
+        const Rgba c = unpack_pixel(img.layout, v);
+        v = pack_pixel(layout, c.r, c.g, c.b, c.a);
+    }
+    img.layout = layout;
+}
+
+bool qoi_decode(const std::uint8_t* data, std::size_t size, PixelLayout layout, Image& out) {
+    if (size < kHeaderBytes + sizeof(kEndMarker) || std::memcmp(data, "qoif", 4) != 0) return false;
+    const std::uint32_t w = read_be32(data + 4), h = read_be32(data + 8);
+    const std::uint8_t channels = data[12];
+    if (w == 0 || h == 0 || (channels != 3 && channels != 4)
+        || static_cast<std::uint64_t>(w) * h > kMaxPixels)
+        return false;
+    const std::size_t count = static_cast<std::size_t>(w) * h;
+    out.width = static_cast<int>(w);
+    out.height = static_cast<int>(h);
+    out.layout = layout;
+    out.pixels.resize(count);
+    switch (layout) {
+    case PixelLayout::ARGB8888: return qoi_decode_pixels<PixelLayout::ARGB8888>(data, size, out.pixels.data(), count);
+    case PixelLayout::ABGR8888: return qoi_decode_pixels<PixelLayout::ABGR8888>(data, size, out.pixels.data(), count);
+    case PixelLayout::RGBA8888: return qoi_decode_pixels<PixelLayout::RGBA8888>(data, size, out.pixels.data(), count);
+    case PixelLayout::BGRA8888: return qoi_decode_pixels<PixelLayout::BGRA8888>(data, size, out.pixels.data(), count);
+    }
+    return false;
+}
+
+void qoi_encode(const Image& img, std::vector<std::uint8_t>& out) {
+    out.clear();
+    out.reserve(kHeaderBytes + img.pixels.size() * 2 + sizeof(kEndMarker));
+    bool alpha = false;
+    for (std::uint32_t v : img.pixels)
+        if (unpack_pixel(img.layout, v).a != 255) {
+            alpha = true;
+            break;
+        }
+    out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+    write_be32(out, static_cast<std::uint32_t>(img.width));
+    write_be32(out, static_cast<std::uint32_t>(img.height));
+    out.push_back(alpha ? 4 : 3);
+    out.push_back(0); // sRGB with linear alpha
+
+    Rgba index[64] = {};
+    Rgba prev{ 0, 0, 0, 255 };
+    unsigned run = 0;
+    const std::size_t count = img.pixels.size();
+    for (std::size_t i = 0; i < count; i++) {
+        const Rgba px = unpack_pixel(img.layout, img.pixels[i]);
+        if (same(px, prev)) {
+            if (++run == 62 || i + 1 == count) {
+                out.push_back(static_cast<std::uint8_t>(kOpRun | (run - 1)));
+                run = 0;
+            }
+            continue;
+        }
+        if (run) {
+            out.push_back(static_cast<std::uint8_t>(kOpRun | (run - 1)));
+            run = 0;
+        }
+        const unsigned h = hash(px);
+        if (same(index[h], px)) {
+            out.push_back(static_cast<std::uint8_t>(kOpIndex | h));
+        } else {
+            index[h] = px;
+            if (px.a == prev.a) {
+                const int vr = static_cast<std::int8_t>(px.r - prev.r);
+                const int vg = static_cast<std::int8_t>(px.g - prev.g);
+                const int vb = static_cast<std::int8_t>(px.b - prev.b);
+                const int vgr = vr - vg, vgb = vb - vg;
+                if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                    out.push_back(static_cast<std::uint8_t>(kOpDiff | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+                } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                    out.push_back(static_cast<std::uint8_t>(kOpLuma | (vg + 32)));
+                    out.push_back(static_cast<std::uint8_t>((vgr + 8) << 4 | (vgb + 8)));
+                } else {
+                    out.insert(out.end(), { kOpRgb, px.r, px.g, px.b });
+                }
+            } else {
+                out.insert(out.end(), { kOpRgba, px.r, px.g, px.b, px.a });
+            }
+        }
+        prev = px;
+    }
+    out.insert(out.end(), std::begin(kEndMarker), std::end(kEndMarker));
+}
+
+bool art_parse(const std::uint8_t* data, std::size_t size, ArtHeader& header, const std::uint32_t*& pixels) {
+    if (size < sizeof(ArtHeader)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != kArtMagic || header.version != kArtVersion || header.layout > 3 || header.width == 0
+        || header.height == 0 || static_cast<std::uint64_t>(header.width) * header.height > kMaxPixels)
+        return false;
+    const std::size_t bytes = static_cast<std::size_t>(header.width) * header.height * 4;
+    if (size - sizeof(ArtHeader) < bytes) return false;
+    // The header is 24 bytes, so the rows stay 4-byte aligned in any malloc'd buffer
+    pixels = reinterpret_cast<const std::uint32_t*>(data + sizeof(ArtHeader));
+    return true;
+}
+
+void art_encode(const Image& img, std::vector<std::uint8_t>& out) {
+    ArtHeader h;
+    h.width = static_cast<std::uint32_t>(img.width);
+    h.height = static_cast<std::uint32_t>(img.height);
+    h.layout = static_cast<std::uint32_t>(img.layout);
+    out.resize(sizeof(h) + img.pixels.size() * 4);
+    std::memcpy(out.data(), &h, sizeof(h));
+    std::memcpy(out.data() + sizeof(h), img.pixels.data(), img.pixels.size() * 4);
+}
+
+bool read_file(const char* path, std::vector<std::uint8_t>& out) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::fprintf(stderr, "cannot open %s: %s\n", path, std::strerror(errno));
+        return false;
+    }
+    bool ok = std::fseek(f, 0, SEEK_END) == 0;
+    const long size = ok ? std::ftell(f) : -1;
+    ok = size >= 0 && std::fseek(f, 0, SEEK_SET) == 0;
+    if (ok) {
+        out.resize(static_cast<std::size_t>(size));
+        ok = std::fread(out.data(), 1, out.size(), f) == out.size();
+    }
+    std::fclose(f);
+    if (!ok) std::fprintf(stderr, "cannot read %s\n", path);
+    return ok;
+}
+
+bool write_file(const char* path, const std::vector<std::uint8_t>& data) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) {
+        std::fprintf(stderr, "cannot create %s: %s\n", path, std::strerror(errno));
+        return false;
+    }
+    const bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+    if (std::fclose(f) != 0 || !ok) {
+        std::fprintf(stderr, "cannot write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+bool load_image(const char* path, PixelLayout layout, Image& out) {
+    std::vector<std::uint8_t> data;
+    if (!read_file(path, data)) return false;
+    ArtHeader h;
+    const std::uint32_t* px = nullptr;
+    bool ok = false;
+    if (data.size() >= 4 && !std::memcmp(data.data(), "qoif", 4)) {
+        ok = qoi_decode(data.data(), data.size(), layout, out);
+    } else if (art_parse(data.data(), data.size(), h, px)) {
+        out.width = static_cast<int>(h.width);
+        out.height = static_cast<int>(h.height);
+        out.layout = static_cast<PixelLayout>(h.layout);
+        out.pixels.assign(px, px + static_cast<std::size_t>(h.width) * h.height);
+        convert_image(out, layout);
+        ok = true;
+    } else {
+        ok = pnm_decode(data.data(), data.size(), layout, out);
+    }
+    if (!ok) std::fprintf(stderr, "%s: not a valid .qoi, .dart, .ppm or .pam image\n", path);
+    return ok;
+}
@@ -0,0 +1,75 @@
+// image_codec.h
+// Artwork without SDL_image. Two file formats:
+//
+//   .qoi   The "Quite OK Image" format: lossless, decodes in one pass with a 64-entry
+//          color cache and no entropy coding. About as small as PNG for flat show
+//          graphics. The decoder writes straight into the pixel layout the renderer
+//          wants, so loading it takes one pass and no conversion.
+//   .dart  Pre-converted artwork: a 24-byte header and then rows already in the texture's
+//          packed 32-bit layout. Loading is a file read and one SDL_UpdateTexture.
+//
+// Pixels are packed 32-bit values in SDL's sense: ARGB8888 means alpha in the top byte
+// of a native-endian std::uint32_t. No SDL here, so offline tools can use it.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// SDL's four packed 32-bit layouts (SDL_PIXELFORMAT_<name>)
+enum class PixelLayout : std::uint8_t { ARGB8888, ABGR8888, RGBA8888, BGRA8888 };
+
+const char* pixel_layout_name(PixelLayout layout);
+// Case-insensitive layout name; false if unknown
+bool parse_pixel_layout(const char* name, PixelLayout& layout);
+
+struct Image {
+    int width{0};
+    int height{0};
+    PixelLayout layout{PixelLayout::ARGB8888};
+    std::vector<std::uint32_t> pixels; // width * height, rows top to bottom, no padding
+};
+
+// Pack straight-alpha RGBA into `layout`
+inline std::uint32_t pack_pixel(PixelLayout layout, std::uint32_t r, std::uint32_t g, std::uint32_t b, std::uint32_t a) {
+    switch (layout) {
+    case PixelLayout::ARGB8888: return a << 24 | r << 16 | g << 8 | b;
+    case PixelLayout::ABGR8888: return a << 24 | b << 16 | g << 8 | r;
+    case PixelLayout::RGBA8888: return r << 24 | g << 16 | b << 8 | a;
+    case PixelLayout::BGRA8888: return b << 24 | g << 16 | r << 8 | a;
+    }
+    return 0;
+}
+
+// Repack `img` into `layout` in place
+void convert_image(Image& img, PixelLayout layout);
+
+// QOI. Decoding rejects truncated streams and images over 64 Mpixel.
+bool qoi_decode(const std::uint8_t* data, std::size_t size, PixelLayout layout, Image& out);
+void qoi_encode(const Image& img, std::vector<std::uint8_t>& out);
+
+// Pre-converted artwork
+constexpr std::uint32_t kArtMagic = 0x54524144; // "DART"
+constexpr std::uint32_t kArtVersion = 1;
+
+struct ArtHeader {
+    std::uint32_t magic{kArtMagic};
+    std::uint32_t version{kArtVersion};
+    std::uint32_t width{0};
+    std::uint32_t height{0};
+    std::uint32_t layout{0};   // PixelLayout
+    std::uint32_t reserved{0};
+};
+static_assert(sizeof(ArtHeader) == 24);
+
+// Parse a .dart buffer: the header and a pointer to its rows (inside `data`)
+bool art_parse(const std::uint8_t* data, std::size_t size, ArtHeader& header, const std::uint32_t*& pixels);
+void art_encode(const Image& img, std::vector<std::uint8_t>& out);
+
+// Read a whole file (false on error, with a message on stderr)
+bool read_file(const char* path, std::vector<std::uint8_t>& out);
+bool write_file(const char* path, const std::vector<std::uint8_t>& data);
+
+// Decode any supported file (.qoi, .dart, binary .ppm / .pam) into `layout`
+bool load_image(const char* path, PixelLayout layout, Image& out);
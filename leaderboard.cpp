@@ -0,0 +1,222 @@
+// leaderboard.cpp
+// Persistent treap with subtree sizes. Every modifying operation returns a new root and
+// copies only the nodes on the search path; untouched subtrees are shared between versions.
+// Node priorities are a hash of the player id, which keeps the trees balanced in
+// expectation without needing a random generator on the writer.
+
+#include "leaderboard.h"
+
+#include <atomic>
+
+struct LeaderboardNode {
+    LeaderboardEntry entry;
+    std::uint32_t priority;
+    std::size_t size;
+    LeaderboardNodePtr left, right;
+};
+
+namespace {
+
+using NodePtr = LeaderboardNodePtr;
+
+std::size_t size_of(const NodePtr& n) { return n ? n->size : 0; }
+
+std::uint32_t priority_for(std::uint32_t playerId) {
+    // Murmur3 finalizer: cheap and well mixed
+    std::uint32_t h = playerId;
+    h ^= h >> 16; h *= 0x85EBCA6Bu;
+    h ^= h >> 13; h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+NodePtr make_node(const LeaderboardEntry& e, std::uint32_t prio, NodePtr l, NodePtr r) {
+    const std::size_t sz = 1 + size_of(l) + size_of(r);
+    return std::make_shared<const LeaderboardNode>(LeaderboardNode{ e, prio, sz, std::move(l), std::move(r) });
+}
+
+// Orderings
+struct ByRank {
+    bool operator()(const LeaderboardEntry& a, const LeaderboardEntry& b) const {
+        if (a.winningsCents != b.winningsCents) return a.winningsCents > b.winningsCents;
+        return a.playerId < b.playerId;
+    }
+};
+struct ById {
+    bool operator()(const LeaderboardEntry& a, const LeaderboardEntry& b) const { return a.playerId < b.playerId; }
+};
+
+// Split into keys < key (l) and keys >= key (r)
+template <class Less>
+void split(const NodePtr& n, const LeaderboardEntry& key, Less less, NodePtr& l, NodePtr& r) {
+    if (!n) { l = r = nullptr; return; }
+    if (less(n->entry, key)) {
+        NodePtr rl;
+        split(n->right, key, less, rl, r);
+        l = make_node(n->entry, n->priority, n->left, std::move(rl));
+    } else {
+        NodePtr lr;
+        split(n->left, key, less, l, lr);
+        r = make_node(n->entry, n->priority, std::move(lr), n->right);
+    }
+}
+
+// Concatenate two trees where every key in l orders before every key in r
+NodePtr merge(const NodePtr& l, const NodePtr& r) {
+    if (!l) return r;
+    if (!r) return l;
+    if (l->priority > r->priority) return make_node(l->entry, l->priority, l->left, merge(l->right, r));
+    return make_node(r->entry, r->priority, merge(l, r->left), r->right);
+}
+
+template <class Less>
+NodePtr insert(const NodePtr& root, const LeaderboardEntry& e, Less less) {
+    NodePtr l, r;
+    split(root, e, less, l, r);
+    return merge(merge(l, make_node(e, priority_for(e.playerId), nullptr, nullptr)), r);
+}
+
+template <class Less>
+NodePtr erase(const NodePtr& n, const LeaderboardEntry& e, Less less) {
+    if (!n) return n;
+    if (less(e, n->entry)) return make_node(n->entry, n->priority, erase(n->left, e, less), n->right);
+    if (less(n->entry, e)) return make_node(n->entry, n->priority, n->left, erase(n->right, e, less));
+    return merge(n->left, n->right);
+}
+
+const LeaderboardNode* find_id(const NodePtr& root, std::uint32_t playerId) {
+    const LeaderboardNode* n = root.get();
+    while (n) {
+        if (playerId < n->entry.playerId) n = n->left.get();
+        else if (n->entry.playerId < playerId) n = n->right.get();
+        else return n;
+    }
+    return nullptr;
+}
+
+// In-order collection of positions [from, to) of the subtree
+void collect(const LeaderboardNode* n, std::size_t from, std::size_t to, std::vector<LeaderboardEntry>& out) {
+    while (n && from < to) {
+        const std::size_t ls = size_of(n->left);
+        if (from < ls) collect(n->left.get(), from, to < ls ? to : ls, out);
+        if (from <= ls && ls < to) out.push_back(n->entry);
+        if (to <= ls + 1) return;
+        // Continue into the right subtree iteratively (tail position)
+        from = from > ls + 1 ? from - ls - 1 : 0;
+        to -= ls + 1;
+        n = n->right.get();
+    }
+}
+
+} // namespace
+
+std::size_t LeaderboardSnapshot::size() const { return size_of(byId_); }
+
+bool LeaderboardSnapshot::winnings_of(std::uint32_t playerId, std::uint64_t& out) const {
+    const LeaderboardNode* n = find_id(byId_, playerId);
+    if (!n) return false;
+    out = n->entry.winningsCents;
+    return true;
+}
+
+long LeaderboardSnapshot::rank_of(std::uint32_t playerId) const {
+    const LeaderboardNode* idNode = find_id(byId_, playerId);
+    if (!idNode) return -1;
+    const LeaderboardEntry key = idNode->entry;
+
+    // Count entries ordering strictly before the player's entry
+    const ByRank less;
+    std::size_t rank = 0;
+    const LeaderboardNode* n = byRank_.get();
+    while (n) {
+        if (less(key, n->entry)) n = n->left.get();
+        else if (less(n->entry, key)) { rank += size_of(n->left) + 1; n = n->right.get(); }
+        else return static_cast<long>(rank + size_of(n->left));
+    }
+    return -1; // Unreachable while both trees agree
+}
+
+void LeaderboardSnapshot::range(std::size_t first, std::size_t count, std::vector<LeaderboardEntry>& out) const {
+    const std::size_t total = size();
+    if (first >= total) return;
+    const std::size_t last = total - first < count ? total : first + count;
+    out.reserve(out.size() + (last - first));
+    collect(byRank_.get(), first, last, out);
+}
+
+Leaderboard::Leaderboard() : current_(new Published{ std::make_shared<const LeaderboardSnapshot>() }) {}
+
+Leaderboard::~Leaderboard() {
+    delete current_.load(std::memory_order_relaxed);
+    for (const Published* p : retired_) delete p;
+}
+
+std::shared_ptr<const LeaderboardSnapshot> Leaderboard::snapshot() const {
+    // Start the slot search where this thread last found one free
+    thread_local std::size_t hint = 0;
+    for (;;) {
+        const Published* p = current_.load(std::memory_order_acquire);
+        for (std::size_t n = 0; n < kReaderSlots; n++, hint = (hint + 1) % kReaderSlots) {
+            const Published* expected = nullptr;
+            if (!hazards_[hint].compare_exchange_strong(expected, p, std::memory_order_seq_cst)) continue;
+            // Still current after the announcement: the writer's scan will see it
+            std::shared_ptr<const LeaderboardSnapshot> pinned;
+            if (current_.load(std::memory_order_seq_cst) == p) pinned = p->version;
+            hazards_[hint].store(nullptr, std::memory_order_release);
+            if (pinned) return pinned;
+            break; // Replaced meanwhile: pin the newer one
+        }
+    }
+}
+
+void Leaderboard::publish(std::shared_ptr<const LeaderboardSnapshot> next) {
+    // Called with writeMutex_ held, so retired_ is the writer's alone
+    const Published* old = current_.exchange(new Published{ std::move(next) }, std::memory_order_seq_cst);
+    retired_.push_back(old);
+    // Free every holder no reader is copying from; the versions themselves live on in
+    // the readers' shared_ptrs
+    const auto announced = [this](const Published* p) {
+        for (const auto& h : hazards_)
+            if (h.load(std::memory_order_seq_cst) == p) return true;
+        return false;
+    };
+    std::size_t kept = 0;
+    for (const Published* p : retired_) {
+        if (announced(p)) retired_[kept++] = p;
+        else delete p;
+    }
+    retired_.resize(kept);
+}
+
+void Leaderboard::apply(LeaderboardSnapshot& s, std::uint32_t playerId, std::uint64_t winningsCents) const {
+    if (const LeaderboardNode* old = find_id(s.byId_, playerId)) {
+        const LeaderboardEntry prev = old->entry;
+        s.byRank_ = erase(s.byRank_, prev, ByRank{});
+        s.byId_ = erase(s.byId_, prev, ById{});
+    }
+    const LeaderboardEntry e{ playerId, winningsCents };
+    s.byRank_ = insert(s.byRank_, e, ByRank{});
+    s.byId_ = insert(s.byId_, e, ById{});
+}
+
+void Leaderboard::set_winnings(std::uint32_t playerId, std::uint64_t winningsCents) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto next = std::make_shared<LeaderboardSnapshot>(latest()); // Only writers replace current_
+    apply(*next, playerId, winningsCents);
+    publish(std::move(next));
+}
+
+void Leaderboard::add_winnings(std::uint32_t playerId, std::uint64_t deltaCents) {
+    add_winnings_batch({ LeaderboardEntry{ playerId, deltaCents } });
+}
+
+void Leaderboard::add_winnings_batch(const std::vector<LeaderboardEntry>& deltas) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto next = std::make_shared<LeaderboardSnapshot>(latest()); // Only writers replace current_
+    for (const LeaderboardEntry& d : deltas) {
+        std::uint64_t total = 0;
+        next->winnings_of(d.playerId, total);
+        apply(*next, d.playerId, total + d.winningsCents);
+    }
+    publish(std::move(next));
+}
@@ -0,0 +1,90 @@
+// leaderboard.h
+// Venue-wide leaderboard ranking players by total winnings.
+//
+// Rankings live in a persistent (path-copying) treap annotated with subtree sizes, so an
+// update copies O(log n) nodes and produces a new immutable version while older versions
+// stay valid. Readers pin the current version (RCU style) and run rank/top-K/range
+// queries on it for as long as they like; writers never wait for readers, and readers
+// never see a half-applied update. Old versions are freed when the last reader drops them.
+//
+// Publishing is a single atomic pointer swap, and pinning takes no lock either: a reader
+// announces the version it is about to pin in one of a fixed set of hazard slots,
+// re-checks that it is still current and copies its shared_ptr. The writer frees a
+// retired version's holder only once no slot names it. (libstdc++'s
+// std::atomic<std::shared_ptr> is not lock-free, so it is not used here.)
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct LeaderboardEntry {
+    std::uint32_t playerId{0};
+    std::uint64_t winningsCents{0};
+};
+
+struct LeaderboardNode;
+using LeaderboardNodePtr = std::shared_ptr<const LeaderboardNode>;
+
+// Immutable view of the leaderboard at one point in time
+class LeaderboardSnapshot {
+public:
+    std::size_t size() const;
+
+    // 0-based rank of a player (0 = leader), or -1 if they have no result yet
+    long rank_of(std::uint32_t playerId) const;
+
+    // Total winnings of a player; false if unknown
+    bool winnings_of(std::uint32_t playerId, std::uint64_t& out) const;
+
+    // Entries at ranks [first, first + count), best first. O(log n + count).
+    void range(std::size_t first, std::size_t count, std::vector<LeaderboardEntry>& out) const;
+
+    void top_k(std::size_t k, std::vector<LeaderboardEntry>& out) const { range(0, k, out); }
+
+private:
+    friend class Leaderboard;
+    LeaderboardNodePtr byRank_; // Ordered by winnings (desc), then player id
+    LeaderboardNodePtr byId_;   // Ordered by player id, for player lookups
+};
+
+class Leaderboard {
+public:
+    Leaderboard();
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+    ~Leaderboard();
+
+    // Set or add to a player's total. Each call publishes a new version.
+    void set_winnings(std::uint32_t playerId, std::uint64_t winningsCents);
+    void add_winnings(std::uint32_t playerId, std::uint64_t deltaCents);
+
+    // Apply many results and publish once (cheaper for bursty venue feeds)
+    void add_winnings_batch(const std::vector<LeaderboardEntry>& deltas);
+
+    // Current version. Lock-free: never waits for a writer or for other readers.
+    std::shared_ptr<const LeaderboardSnapshot> snapshot() const;
+
+    // Concurrent snapshot() calls beyond this many retry until a slot frees up
+    static constexpr std::size_t kReaderSlots = 64;
+
+private:
+    // What current_ points to; readers copy `version` out of it under a hazard slot
+    struct Published {
+        std::shared_ptr<const LeaderboardSnapshot> version;
+    };
+
+    // Writer-side helpers operating on a private working copy
+    void apply(LeaderboardSnapshot& s, std::uint32_t playerId, std::uint64_t winningsCents) const;
+    void publish(std::shared_ptr<const LeaderboardSnapshot> next);
+    const LeaderboardSnapshot& latest() const { return *current_.load(std::memory_order_relaxed)->version; }
+
+    std::mutex writeMutex_; // Serializes writers only; readers never take it
+    std::atomic<const Published*> current_{nullptr};
+    mutable std::atomic<const Published*> hazards_[kReaderSlots]{};
+    std::vector<const Published*> retired_; // Swapped out, maybe still being copied from
+};
@@ -0,0 +1,53 @@
+// leaderboard_panel.cpp
+// Drawing the leaderboard: panel frame plus a virtualized rank/player/winnings list.
+
+#include "leaderboard_panel.h"
+
+#include <cstdio>
+#include <vector>
+
+LeaderboardPanel::LeaderboardPanel() {
+    list.rowHeight = 30;
+}
+
+void LeaderboardPanel::set_rect(const SDL_Rect& rect) {
+    list.rect = rect;
+    list.columns = {
+        ListColumn{ 10, SDL_Color{ 180, 180, 180, 255 }, false },          // rank
+        ListColumn{ 60, SDL_Color{ 235, 235, 235, 255 }, false },          // player
+        ListColumn{ rect.w - 12, SDL_Color{ 240, 200, 80, 255 }, true },   // winnings
+    };
+}
+
+void leaderboard_panel_scroll(LeaderboardPanel& p, int wheelY, std::size_t rows) {
+    p.list.set_row_count(rows);
+    p.list.scroll_by(wheelY);
+}
+
+void render_leaderboard_panel(SDL_Renderer* r, TTF_Font* font, LeaderboardPanel& p,
+                              const LeaderboardSnapshot& snap) {
+    // Panel background and border
+    const SDL_Rect& rect = p.rect();
+    SDL_SetRenderDrawColor(r, 16, 18, 22, 255);
+    SDL_RenderFillRect(r, &rect);
+    SDL_SetRenderDrawColor(r, 200, 170, 60, 255);
+    SDL_RenderDrawRect(r, &rect);
+
+    // Only fetch and format the rows that intersect the panel
+    p.list.set_row_count(snap.size());
+    std::vector<LeaderboardEntry> entries;
+    snap.range(p.list.first_visible(), p.list.visible_count(), entries);
+
+    std::vector<ListRowContent> rows(entries.size());
+    char buf[32];
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        std::snprintf(buf, sizeof(buf), "%zu", p.list.first_visible() + i + 1);
+        rows[i].cells[0] = buf;
+        std::snprintf(buf, sizeof(buf), "Player %u", entries[i].playerId);
+        rows[i].cells[1] = buf;
+        std::snprintf(buf, sizeof(buf), "$%llu", static_cast<unsigned long long>(entries[i].winningsCents / 100));
+        rows[i].cells[2] = buf;
+        rows[i].highlight = entries[i].playerId == p.highlightPlayer;
+    }
+    p.list.render(r, font, rows);
+}
@@ -0,0 +1,30 @@
+// leaderboard_panel.h
+// Scrolling leaderboard panel built on ListView. Rows come from a pinned
+// LeaderboardSnapshot so the list never changes halfway through a frame.
+
+#pragma once
+
+#include "leaderboard.h"
+#include "list_view.h"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstddef>
+#include <cstdint>
+
+struct LeaderboardPanel {
+    ListView list;
+    std::uint32_t highlightPlayer{0xFFFFFFFFu}; // Player drawn highlighted (the local contestant)
+
+    LeaderboardPanel();
+
+    // Position the panel (sets up the column layout for the new width)
+    void set_rect(const SDL_Rect& rect);
+    const SDL_Rect& rect() const { return list.rect; }
+};
+
+// Apply a mouse wheel step (positive = up)
+void leaderboard_panel_scroll(LeaderboardPanel& p, int wheelY, std::size_t rows);
+
+void render_leaderboard_panel(SDL_Renderer* r, TTF_Font* font, LeaderboardPanel& p,
+                              const LeaderboardSnapshot& snap);
@@ -0,0 +1,107 @@
+// list_view.cpp
+// Virtualized list: row slot recycling and in-place texture updates.
+
+#include "list_view.h"
+
+ListView::~ListView() {
+    release();
+}
+
+void ListView::release() {
+    for (RowSlot& s : slots_)
+        for (Cell& c : s.cells)
+            if (c.tex) SDL_DestroyTexture(c.tex);
+    slots_.clear();
+}
+
+std::size_t ListView::visible_count() const {
+    // One extra row for the partially visible row at the bottom when scrolled mid-row
+    return static_cast<std::size_t>(rect.h / rowHeight + 2);
+}
+
+void ListView::clamp_scroll() {
+    const int contentPx = static_cast<int>(rowCount_) * rowHeight;
+    const int maxScroll = contentPx > rect.h ? contentPx - rect.h : 0;
+    if (scrollPx_ > maxScroll) scrollPx_ = maxScroll;
+    if (scrollPx_ < 0) scrollPx_ = 0;
+}
+
+void ListView::set_row_count(std::size_t rows) {
+    rowCount_ = rows;
+    clamp_scroll();
+}
+
+void ListView::scroll_by(int wheelY) {
+    scrollPx_ -= wheelY * rowHeight * 3; // three rows per wheel notch
+    clamp_scroll();
+}
+
+void ListView::update_cell(SDL_Renderer* r, TTF_Font* font, Cell& c, const std::string& text) {
+    if (c.tex && c.text == text) return; // Unchanged: reuse as-is
+    c.text = text;
+    c.w = c.h = 0;
+    if (text.empty()) return;
+
+    // Rasterize in white; the column colour is applied with a colour mod at draw time so
+    // restyling never forces a re-render
+    SDL_Surface* surf = TTF_RenderUTF8_Blended(font, text.c_str(), SDL_Color{ 255, 255, 255, 255 });
+    if (!surf) return;
+    ++stats_.cellsRasterized;
+
+    // Refill the existing texture when the text fits, otherwise grow it (rounded up so
+    // slightly longer labels later don't reallocate again)
+    if (!c.tex || surf->w > c.capW || surf->h > c.capH) {
+        if (c.tex) SDL_DestroyTexture(c.tex);
+        c.capW = (surf->w + 63) & ~63;
+        c.capH = surf->h;
+        c.tex = SDL_CreateTexture(r, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, c.capW, c.capH);
+        if (c.tex) SDL_SetTextureBlendMode(c.tex, SDL_BLENDMODE_BLEND);
+        ++stats_.texturesCreated;
+    }
+    if (c.tex) {
+        // TTF_RenderUTF8_Blended always produces ARGB8888, matching the texture
+        SDL_Rect area{ 0, 0, surf->w, surf->h };
+        SDL_UpdateTexture(c.tex, &area, surf->pixels, surf->pitch);
+        c.w = surf->w;
+        c.h = surf->h;
+    }
+    SDL_FreeSurface(surf);
+}
+
+void ListView::render(SDL_Renderer* r, TTF_Font* font, const std::vector<ListRowContent>& rows) {
+    stats_ = ListViewStats{};
+    const std::size_t slotCount = visible_count();
+    if (slots_.size() != slotCount) {
+        // Viewport height changed: start over with the right number of slots
+        release();
+        slots_.resize(slotCount);
+    }
+
+    const std::size_t first = first_visible();
+    SDL_RenderSetClipRect(r, &rect);
+    for (std::size_t i = 0; i < rows.size() && i < slotCount; i++) {
+        const std::size_t row = first + i;
+        RowSlot& slot = slots_[row % slotCount];
+
+        const int y = rect.y + static_cast<int>(row) * rowHeight - scrollPx_;
+        SDL_Rect rowRect{ rect.x + 1, y, rect.w - 2, rowHeight };
+        if (rows[i].highlight) SDL_SetRenderDrawColor(r, 90, 75, 20, 255);
+        else if (row % 2) SDL_SetRenderDrawColor(r, 26, 28, 34, 255);
+        else SDL_SetRenderDrawColor(r, 20, 22, 27, 255);
+        SDL_RenderFillRect(r, &rowRect);
+
+        for (std::size_t c = 0; c < columns.size() && c < kListMaxColumns; c++) {
+            Cell& cell = slot.cells[c];
+            update_cell(r, font, cell, rows[i].cells[c]);
+            if (!cell.tex || cell.w == 0) continue;
+            const ListColumn& col = columns[c];
+            SDL_SetTextureColorMod(cell.tex, col.color.r, col.color.g, col.color.b);
+            const int x = col.alignRight ? rect.x + col.x - cell.w : rect.x + col.x;
+            SDL_Rect src{ 0, 0, cell.w, cell.h };
+            SDL_Rect dst{ x, y + (rowHeight - cell.h) / 2, cell.w, cell.h };
+            SDL_RenderCopy(r, cell.tex, &src, &dst);
+        }
+        ++stats_.rowsDrawn;
+    }
+    SDL_RenderSetClipRect(r, nullptr);
+}
@@ -0,0 +1,89 @@
+// list_view.h
+// Virtualized list widget for long lists (leaderboards, offer history).
+//
+// Only rows intersecting the viewport are laid out and drawn. Each visible position owns a
+// row slot (slot = row index % slot count) whose cell textures are kept between frames:
+// a cell is re-rasterized only when its text changes, and a texture is refilled in place
+// (SDL_UpdateTexture) while the new text still fits. Scrolling therefore costs at most one
+// new row per row scrolled, and frame time depends on the viewport height, not list size.
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+constexpr std::size_t kListMaxColumns = 4;
+
+// Where and how a column's text is drawn inside a row
+struct ListColumn {
+    int x{0};                       // Offset from the row's left edge
+    SDL_Color color{255, 255, 255, 255};
+    bool alignRight{false};         // If true, `x` is the right edge of the text
+};
+
+// Text and style of one row as supplied by the owner of the data
+struct ListRowContent {
+    std::array<std::string, kListMaxColumns> cells;
+    bool highlight{false};
+};
+
+// Per-frame counters, handy for checking that scrolling stays cheap
+struct ListViewStats {
+    int rowsDrawn{0};
+    int cellsRasterized{0}; // Cells whose text changed and were re-rendered with SDL_ttf
+    int texturesCreated{0}; // Cells that needed a new (larger) texture
+};
+
+class ListView {
+public:
+    SDL_Rect rect{};
+    int rowHeight{30};
+    std::vector<ListColumn> columns;
+
+    ListView() = default;
+    ~ListView();
+    ListView(const ListView&) = delete;
+    ListView& operator=(const ListView&) = delete;
+
+    // Update the total number of rows (clamps the scroll position)
+    void set_row_count(std::size_t rows);
+    std::size_t row_count() const { return rowCount_; }
+
+    // Mouse wheel step (positive = up)
+    void scroll_by(int wheelY);
+
+    // Rows the owner must supply to render(): [first_visible(), first_visible() + visible_count())
+    std::size_t first_visible() const { return static_cast<std::size_t>(scrollPx_ / rowHeight); }
+    std::size_t visible_count() const;
+
+    // Draw the visible rows; rows[i] is the content of row first_visible() + i
+    void render(SDL_Renderer* r, TTF_Font* font, const std::vector<ListRowContent>& rows);
+
+    const ListViewStats& last_frame_stats() const { return stats_; }
+
+    // Destroy cached textures. Must be called before the renderer that created them goes away.
+    void release();
+
+private:
+    struct Cell {
+        std::string text;
+        SDL_Texture* tex{nullptr};
+        int capW{0}, capH{0}; // Texture size
+        int w{0}, h{0};       // Size of the text currently in the texture
+    };
+    struct RowSlot {
+        std::array<Cell, kListMaxColumns> cells;
+    };
+
+    void update_cell(SDL_Renderer* r, TTF_Font* font, Cell& c, const std::string& text);
+    void clamp_scroll();
+
+    std::vector<RowSlot> slots_;
+    std::size_t rowCount_{0};
+    int scrollPx_{0};
+    ListViewStats stats_;
+};
@@ -0,0 +1,318 @@
+// log_codec.cpp
+
+#include "log_codec.h"
+
+#include "game.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint64_t kBoardSum = [] {
+    std::uint64_t s = 0;
+    for (std::uint32_t v : kCaseValues) s += v;
+    return s;
+}();
+
+std::uint64_t zigzag(std::int64_t v) {
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t v) {
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+void start_game(LogCodecState& st, std::uint32_t gameId) {
+    st.inGame = true;
+    st.gameId = gameId;
+    st.mask = 0;
+    st.round = 0;
+    st.sum = kBoardSum;
+    st.unopened = kNumCases;
+}
+
+// banker_offer_for_sum() without a division: the codec predicts an offer per record, and
+// a 64-bit divide by the case count was the biggest single cost of both directions.
+// Division by n <= 26 is a multiply by floor(2^34 / n) + 1, exact for anything under
+// 2^34 / 26. The offer (2x + 40n) / 80n, with x = sum * (11 + 3r), equals (x / n + 20) / 40,
+// and x / n splits into (sum / n) * f + (sum % n) * f / n so no product gets too large.
+constexpr int kRecipShift = 34;
+static_assert(kBoardSum < (std::uint64_t{1} << kRecipShift) / kNumCases, "reciprocal division would be inexact");
+
+constexpr std::array<std::uint64_t, kNumCases + 1> kRecip = [] {
+    std::array<std::uint64_t, kNumCases + 1> r{};
+    for (std::uint64_t n = 1; n <= kNumCases; n++) r[n] = (std::uint64_t{1} << kRecipShift) / n + 1;
+    return r;
+}();
+
+std::uint32_t predicted_offer(const LogCodecState& st) {
+    const std::uint32_t n = st.unopened;
+    if (n == 0 || n > kNumCases) return 0;
+    const std::uint64_t f = 11 + 3 * std::uint64_t{std::clamp<std::uint8_t>(st.round, 1, kNumRounds)};
+    const std::uint64_t recip = kRecip[n];
+    const std::uint64_t q = (st.sum * recip) >> kRecipShift;
+    const std::uint64_t rem = st.sum - q * n;
+    const std::uint64_t perCase = q * f + ((rem * f * recip) >> kRecipShift);
+    return static_cast<std::uint32_t>((perCase + 20) / 40);
+}
+
+// put_varint() into a caller's buffer; the encoder assembles each record on the stack
+std::uint8_t* write_varint(std::uint8_t* q, std::uint64_t v) {
+    while (v >= 0x80) {
+        *q++ = static_cast<std::uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    *q++ = static_cast<std::uint8_t>(v);
+    return q;
+}
+
+void set_mask(LogCodecState& st, std::uint32_t mask) {
+    st.mask = mask;
+    st.sum = 0;
+    st.unopened = 0;
+    for (int i = 0; i < kNumCases; i++) {
+        if (mask & (1u << i)) continue;
+        st.sum += kCaseValues[static_cast<std::size_t>(i)];
+        ++st.unopened;
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------
+// LogEncoder
+// ---------------------------------------------------------------------------------------
+
+LogEncoder::LogEncoder(std::uint32_t keyframeInterval) : interval_(keyframeInterval ? keyframeInterval : 1) {
+    out_.resize(kHeaderBytes);
+}
+
+void LogEncoder::add(const DecisionRecord& r) {
+    if (count_ == nextKeyframe_) {
+        keyframes_.push_back(out_.size() - kHeaderBytes);
+        st_ = LogCodecState{};
+        nextKeyframe_ += interval_;
+    }
+    ++count_;
+
+    // Longest case: 5 + 2 + 1 + 4 + 5 bytes
+    std::uint8_t buf[24];
+    std::uint8_t* q = buf;
+    const std::int64_t gameDelta = static_cast<std::int64_t>(r.gameId) - static_cast<std::int64_t>(st_.gameId);
+    q = write_varint(q, zigzag(gameDelta) << 1 | (r.tookDeal ? 1u : 0u));
+    if (!st_.inGame || gameDelta != 0) start_game(st_, r.gameId);
+
+    q = write_varint(q, zigzag(static_cast<std::int64_t>(r.round) - st_.round - 1));
+    st_.round = r.round;
+
+    // Newly opened cases as 5-bit indices while that is smaller than the raw mask
+    const std::uint32_t added = r.openedMask & ~st_.mask;
+    const auto count = static_cast<std::uint32_t>(opened_count(added));
+    if ((r.openedMask & st_.mask) == st_.mask && count * 5 <= 32 && (r.openedMask >> kNumCases) == 0) {
+        q = write_varint(q, count << 1);
+        std::uint32_t acc = 0;
+        int bits = 0;
+        for (std::uint32_t m = added; m; m &= m - 1) {
+            const int i = std::countr_zero(m);
+            acc |= static_cast<std::uint32_t>(i) << bits;
+            bits += 5;
+            st_.sum -= kCaseValues[static_cast<std::size_t>(i)];
+            --st_.unopened;
+            while (bits >= 8) {
+                *q++ = static_cast<std::uint8_t>(acc);
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+        if (bits > 0) *q++ = static_cast<std::uint8_t>(acc);
+        st_.mask = r.openedMask;
+    } else {
+        *q++ = 1;
+        for (int i = 0; i < 4; i++) *q++ = static_cast<std::uint8_t>(r.openedMask >> (8 * i));
+        set_mask(st_, r.openedMask);
+    }
+
+    q = write_varint(q, zigzag(static_cast<std::int64_t>(r.offerCents) - static_cast<std::int64_t>(predicted_offer(st_))));
+    out_.insert(out_.end(), buf, q);
+}
+
+std::vector<std::uint8_t> LogEncoder::finish() {
+    std::vector<std::uint8_t> out;
+    out.swap(out_);
+    const std::uint64_t indexOffset = out.size();
+    for (std::uint64_t k : keyframes_) put_u64(out, k);
+    put_u64(out, indexOffset);
+
+    std::vector<std::uint8_t> header;
+    put_u32(header, kLogCodecMagic);
+    put_u32(header, kVersion);
+    put_u64(header, count_);
+    put_u32(header, interval_);
+    put_u32(header, 0);
+    std::memcpy(out.data(), header.data(), kHeaderBytes);
+
+    out_.resize(kHeaderBytes);
+    keyframes_.clear();
+    count_ = 0;
+    nextKeyframe_ = 0;
+    st_ = LogCodecState{};
+    return out;
+}
+
+// ---------------------------------------------------------------------------------------
+// LogDecoder
+// ---------------------------------------------------------------------------------------
+
+bool LogDecoder::fail() {
+    failed_ = true;
+    return false;
+}
+
+bool LogDecoder::open(const std::uint8_t* data, std::size_t size) {
+    *this = LogDecoder{};
+    constexpr std::size_t kHeader = LogEncoder::kHeaderBytes;
+    if (size < kHeader + 8 || get_u32(data) != kLogCodecMagic || get_u32(data + 4) != kVersion) return fail();
+    count_ = get_u64(data + 8);
+    interval_ = get_u32(data + 16);
+    if (interval_ == 0) return fail();
+    keyframes_ = count_ == 0 ? 0 : (count_ - 1) / interval_ + 1;
+    const std::uint64_t indexOffset = get_u64(data + size - 8);
+    if (indexOffset < kHeader || indexOffset > size - 8 || (size - 8 - indexOffset) / 8 != keyframes_) return fail();
+    payload_ = data + kHeader;
+    index_ = data + indexOffset;
+    p_ = payload_;
+    end_ = data + indexOffset;
+    return true;
+}
+
+bool LogDecoder::seek(std::uint64_t index) {
+    if (!payload_ || index > count_) return false;
+    if (index == count_) {
+        pos_ = count_;
+        p_ = end_;
+        return true;
+    }
+    const std::uint64_t k = index / interval_;
+    const std::uint64_t offset = get_u64(index_ + 8 * k);
+    if (offset > static_cast<std::uint64_t>(end_ - payload_)) return fail();
+    p_ = payload_ + offset;
+    pos_ = k * interval_;
+    nextKeyframe_ = pos_;
+    failed_ = false;
+    DecisionRecord skip;
+    while (pos_ < index)
+        if (!next(skip)) return false;
+    return true;
+}
+
+bool LogDecoder::next(DecisionRecord& out) {
+    if (pos_ >= count_ || failed_) return false;
+    if (pos_ == nextKeyframe_) {
+        st_ = LogCodecState{};
+        nextKeyframe_ += interval_;
+    }
+
+    // Head, round and opened-count are one byte each in nearly every record: with eight
+    // bytes left, take all three from one load when none has its continuation bit set
+    std::uint64_t head, roundZ, opened, offerZ;
+    std::uint64_t lead = 0;
+    if (end_ - p_ >= 8) std::memcpy(&lead, p_, sizeof(lead)); // little-endian stream
+    if (end_ - p_ >= 8 && (lead & 0x808080u) == 0) {
+        head = lead & 0xff;
+        roundZ = (lead >> 8) & 0xff;
+        opened = (lead >> 16) & 0xff;
+        p_ += 3;
+    } else if (!get_varint(p_, end_, head) || !get_varint(p_, end_, roundZ) || !get_varint(p_, end_, opened)) {
+        return fail();
+    }
+    const std::int64_t gameDelta = unzigzag(head >> 1);
+    const std::int64_t gameId = static_cast<std::int64_t>(st_.gameId) + gameDelta;
+    if (gameId < 0 || gameId > 0xffffffffll) return fail();
+    if (!st_.inGame || gameDelta != 0) start_game(st_, static_cast<std::uint32_t>(gameId));
+
+    const std::int64_t round = st_.round + 1 + unzigzag(roundZ);
+    if (round < 0 || round > 255) return fail();
+    st_.round = static_cast<std::uint8_t>(round);
+
+    if (opened & 1) {
+        if (opened != 1 || end_ - p_ < 4) return fail();
+        set_mask(st_, get_u32(p_));
+        p_ += 4;
+    } else {
+        const std::uint64_t count = opened >> 1;
+        const std::uint64_t bytes = (count * 5 + 7) / 8;
+        if (count > kNumCases || static_cast<std::uint64_t>(end_ - p_) < bytes) return fail();
+        // At most 26 indices (17 bytes), each read with one unaligned load: in place when
+        // 24 bytes remain, else from a padded copy
+        std::uint8_t buf[24] = {};
+        const std::uint8_t* src = p_;
+        if (end_ - p_ < 24) {
+            std::memcpy(buf, p_, bytes);
+            src = buf;
+        }
+        for (std::uint64_t k = 0; k < count; k++) {
+            std::uint64_t word;
+            std::memcpy(&word, src + k * 5 / 8, sizeof(word)); // little-endian stream
+            const auto i = static_cast<std::uint32_t>((word >> (k * 5 % 8)) & 0x1f);
+            if (i >= static_cast<std::uint32_t>(kNumCases) || (st_.mask & (1u << i))) return fail();
+            st_.mask |= 1u << i;
+            st_.sum -= kCaseValues[i];
+            --st_.unopened;
+        }
+        p_ += bytes;
+    }
+
+    if (!get_varint(p_, end_, offerZ)) return fail();
+    const std::int64_t offer = static_cast<std::int64_t>(predicted_offer(st_)) + unzigzag(offerZ);
+    if (offer < 0 || offer > 0xffffffffll) return fail();
+
+    out.gameId = st_.gameId;
+    out.openedMask = st_.mask;
+    out.offerCents = static_cast<std::uint32_t>(offer);
+    out.round = st_.round;
+    out.tookDeal = static_cast<std::uint8_t>(head & 1);
+    out.reserved = 0;
+    ++pos_;
+    return true;
+}
+
+std::size_t LogDecoder::read(DecisionRecord* out, std::size_t max) {
+    std::size_t n = 0;
+    while (n < max && next(out[n])) ++n;
+    return n;
+}
+
+// ---------------------------------------------------------------------------------------
+// Whole files
+// ---------------------------------------------------------------------------------------
+
+void encode_decision_log(const std::vector<DecisionRecord>& records, std::vector<std::uint8_t>& out,
+                         std::uint32_t keyframeInterval) {
+    LogEncoder enc(keyframeInterval);
+    enc.reserve(records.size());
+    enc.add(records.data(), records.size());
+    out = enc.finish();
+}
+
+bool decode_decision_log(const std::uint8_t* data, std::size_t size, std::vector<DecisionRecord>& out) {
+    LogDecoder dec;
+    if (!dec.open(data, size)) {
+        std::fprintf(stderr, "decode_decision_log: not a compact decision log\n");
+        return false;
+    }
+    const std::size_t base = out.size();
+    out.resize(base + dec.count());
+    const std::size_t n = dec.read(out.data() + base, dec.count());
+    if (n != dec.count()) {
+        std::fprintf(stderr, "decode_decision_log: corrupt record %zu of %llu\n", n,
+                     static_cast<unsigned long long>(dec.count()));
+        out.resize(base + n);
+        return false;
+    }
+    return true;
+}
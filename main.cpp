@@ -1,12 +1,39 @@
 // main.cpp
-// A simple SDL2 program demonstrating a button that changes the background color
-// and plays a sound when clicked. Includes hover and pressed states with comments
-// explaining each step for learning purposes.
+// The Deal or No Deal show app: runs live shows on the deterministic show flow and drives
+// the operator window plus the optional studio displays (host, podium, audience). Optional
+// extras hang off flags: buzzer input, leaderboard, broadcast export, video capture,
+// replay recording and a hot standby.
+
+#include "artwork.h"
+#include "broadcast_export.h"
+#include "buzzer_input.h"
+#include "color_math.h"
+#include "deterministic.h"
+#include "leaderboard.h"
+#include "leaderboard_panel.h"
+#include "render_pacer.h"
+#include "render_probe.h"
+#include "replay_file.h"
+#include "replication.h"
+#include "show_displays.h"
+#include "show_flow.h"
+#include "simulator.h"
+#include "text_layout.h"
+#include "timer_wheel.h"
+#include "video_capture.h"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
 #include <random>
+#include <thread>
 #include <vector>
 #include <cmath>
 
@@ -19,7 +46,7 @@ struct Button {
 };
 
 // Draw the button with visual states (idle, hover, pressed)
-static void render_button(SDL_Renderer* r, const Button& b, TTF_Font* font, const char* label) {
+static void render_button(SDL_Renderer* r, TextTextureCache& text, const Button& b, TTF_Font* font, const char* label) {
     // Background fill color depends on state
     if (b.pressed) {
         SDL_SetRenderDrawColor(r, 30, 30, 30, 255);   // pressed: darkest
@@ -37,17 +64,8 @@ static void render_button(SDL_Renderer* r, const Button& b, TTF_Font* font, cons
     SDL_RenderDrawRect(r, &b.rect);
 
     // Render the button label text centered inside
-    SDL_Color labelCol{255,255,255,255};
-    SDL_Surface* surf = TTF_RenderText_Blended(font, label, labelCol);
-    if (!surf) return;
-    SDL_Texture* tex = SDL_CreateTextureFromSurface(r, surf);
-    SDL_FreeSurface(surf);
-    if (!tex) return;
-
-    int tw=0, th=0; SDL_QueryTexture(tex, nullptr, nullptr, &tw, &th);
-    SDL_Rect dst{ b.rect.x + (b.rect.w - tw)/2, b.rect.y + (b.rect.h - th)/2, tw, th };
-    SDL_RenderCopy(r, tex, nullptr, &dst);
-    SDL_DestroyTexture(tex);
+    const int th = TTF_FontHeight(font);
+    text.draw(font, label, b.rect.x + b.rect.w / 2, b.rect.y + (b.rect.h - th) / 2, SDL_Color{255,255,255,255});
 }
 
 // Utility: check if point (x,y) is inside a rect
@@ -55,7 +73,72 @@ static bool point_in_rect(int x, int y, const SDL_Rect& r) {
     return (x >= r.x && x < r.x + r.w && y >= r.y && y < r.y + r.h);
 }
 
-int main(int, char**) {
+// The local show reports to the UI: state is read directly each frame, rejected input
+// gets an audible cue
+struct LocalStage final : ShowStage {
+    std::function<void()> onRejected;
+    std::function<void(const ShowState&)> onFinished;
+    void on_step(const ShowState& st) override { if (st.step == ShowStep::Finished && onFinished) onFinished(st); }
+    void on_rejected(const ShowInput&, ErrorCode) override { if (onRejected) onRejected(); }
+};
+
+int main(int argc, char** argv) {
+    // --primary PATH: serve a hot standby on that Unix socket
+    // --standby PATH: follow the primary there and take over if it dies
+    // --export NAME: publish live state in shared memory for broadcast graphics
+    // --export-frames: publish the rendered frames there as well
+    // --capture FILE: archive the show as video (.dcap = compressed, anything else = Y4M)
+    // --capture-fps N: archive frame rate (default 30)
+    // --displays LIST: extra studio outputs, e.g. host,podium,audience (one window each,
+    //                  on monitors 1, 2, ... when present)
+    // --render-driver NAME: render with this SDL driver (opengl, opengles2, software, ...)
+    // --render-probe: benchmark the render drivers again instead of using the cached pick
+    // --seed S: seed every random choice (shuffles, picks, colors, the demo feed) from S
+    //           instead of the clock, so a show can be run again exactly
+    // --record FILE: record the shows as a replay file (.dndr)
+    // --replay FILE: play a recording back instead of running a show; Left/Right seek
+    //                10 s, Page Up/Down a minute, Home/End to either end
+    // --virtual-buzzer: attach an SDL virtual joystick as a test buzzer; keys 1 and 2 press
+    //                   its DEAL and NO DEAL buttons
+    // --demo-feed: fill the leaderboard with simulated contestants (demos only)
+    const char* primaryPath = nullptr;
+    const char* standbyPath = nullptr;
+    const char* exportName = nullptr;
+    bool exportFrames = false;
+    const char* capturePath = nullptr;
+    int captureFps = 30;
+    const char* displayList = nullptr;
+    const char* renderDriver = nullptr;
+    bool reprobe = false;
+    std::uint64_t seed = 0;
+    bool seeded = false;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    bool virtualBuzzer = false;
+    bool demoFeed = false;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--primary") && hasValue) primaryPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--standby") && hasValue) standbyPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--export") && hasValue) exportName = argv[++i];
+        else if (!std::strcmp(argv[i], "--export-frames")) exportFrames = true;
+        else if (!std::strcmp(argv[i], "--capture") && hasValue) capturePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--capture-fps") && hasValue) captureFps = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--displays") && hasValue) displayList = argv[++i];
+        else if (!std::strcmp(argv[i], "--render-driver") && hasValue) renderDriver = argv[++i];
+        else if (!std::strcmp(argv[i], "--render-probe")) reprobe = true;
+        else if (!std::strcmp(argv[i], "--record") && hasValue) recordPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--replay") && hasValue) replayPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--virtual-buzzer")) virtualBuzzer = true;
+        else if (!std::strcmp(argv[i], "--demo-feed")) demoFeed = true;
+        else if (!std::strcmp(argv[i], "--seed") && hasValue) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+            seeded = true;
+        }
+    }
+    if (!seeded) seed = static_cast<std::uint64_t>(std::random_device{}()) << 32 | std::random_device{}();
+    std::printf("Seed %llu\n", static_cast<unsigned long long>(seed));
+
     // Initialize SDL video and audio subsystems
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
         std::fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError());
@@ -69,28 +152,54 @@ int main(int, char**) {
     }
 
     // Create window
-    SDL_Window* window = SDL_CreateWindow("SDL2 Button",
+    SDL_Window* window = SDL_CreateWindow("Deal or No Deal",
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 900, 600, SDL_WINDOW_RESIZABLE);
     if (!window) {
         std::fprintf(stderr, "SDL_CreateWindow failed: %s\n", SDL_GetError());
         TTF_Quit(); SDL_Quit(); return 1;
     }
 
-    // Create renderer (accelerated with vsync)
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1,
-        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    if (!renderer) {
-        std::fprintf(stderr, "SDL_CreateRenderer failed: %s\n", SDL_GetError());
-        SDL_DestroyWindow(window); TTF_Quit(); SDL_Quit(); return 1;
-    }
-
     // Load font (path may need adjusting per system)
     TTF_Font* font = TTF_OpenFont("./assets/fonts/MotivaSansBold.woff.ttf", 28);
     if (!font) {
         std::fprintf(stderr, "TTF_OpenFont failed: %s\n", TTF_GetError());
-        SDL_DestroyRenderer(renderer); SDL_DestroyWindow(window);
+        SDL_DestroyWindow(window);
+        TTF_Quit(); SDL_Quit(); return 1;
+    }
+    // Smaller font for list rows
+    TTF_Font* smallFont = TTF_OpenFont("./assets/fonts/MotivaSansRegular.woff.ttf", 18);
+    if (!smallFont) {
+        std::fprintf(stderr, "TTF_OpenFont failed: %s\n", TTF_GetError());
+        TTF_CloseFont(font); SDL_DestroyWindow(window);
+        TTF_Quit(); SDL_Quit(); return 1;
+    }
+
+    // Create renderer (vsync) on the driver that did best on this machine: benchmarked on
+    // first start, then cached, unless --render-driver names one
+    RenderProbeOptions probe;
+    probe.forceDriver = renderDriver;
+    probe.reprobe = reprobe;
+    SDL_GetWindowSize(window, &probe.width, &probe.height);
+    probe.font = smallFont;
+    const RenderDriverChoice driver = choose_render_driver(probe);
+    print_render_driver_choice(stdout, driver);
+    int rendererIndex = driver.index; // What the studio displays use too
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, rendererIndex, driver.flags | SDL_RENDERER_PRESENTVSYNC);
+    if (!renderer && driver.index >= 0) {
+        std::fprintf(stderr, "SDL_CreateRenderer failed on %s: %s; trying the default\n", driver.name.c_str(), SDL_GetError());
+        rendererIndex = -1;
+        renderer = SDL_CreateRenderer(window, rendererIndex, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    }
+    if (!renderer) {
+        std::fprintf(stderr, "SDL_CreateRenderer failed: %s\n", SDL_GetError());
+        TTF_CloseFont(smallFont); TTF_CloseFont(font); SDL_DestroyWindow(window);
         TTF_Quit(); SDL_Quit(); return 1;
     }
+    // .dart artwork converted to this layout uploads without conversion (tools/art_convert)
+    std::printf("Artwork layout: %s\n", pixel_layout_name(renderer_pixel_layout(renderer)));
+
+    // Optional artwork: drawn when present, skipped otherwise
+    SDL_Texture* bankerArt = load_optional_artwork(renderer, "./assets/art/banker");
 
     // Setup audio: 48kHz, stereo, float format
     SDL_AudioSpec want{}, have{};
@@ -123,22 +232,201 @@ int main(int, char**) {
     };
 
     // Random number generator for background colors
-    std::mt19937 rng{std::random_device{}()};
+    std::mt19937 rng{static_cast<std::mt19937::result_type>(game_seed(seed, 0))};
     std::uniform_int_distribution<int> dist(40, 220);
 
-    // Initial background color (dark gray)
-    Uint8 bgR = 20, bgG = 24, bgB = 28;
+    // Background color (dark gray at first). Changes fade in linear light, so the
+    // in-between colors stay as bright as the ends instead of dipping through mud.
+    constexpr Rgb8 kIdleBg{ 20, 24, 28 };
+    constexpr Uint64 kBgFadeMs = 400;
+    Rgb8 bg = kIdleBg, bgFrom = kIdleBg, bgTo = kIdleBg;
+    Uint64 bgFadeStartMs = 0;
+    auto fade_background_to = [&](Rgb8 to) {
+        bgFrom = bg;
+        bgTo = to;
+        bgFadeStartMs = SDL_GetTicks64();
+    };
+
+    // Venue leaderboard: every show finished here posts its contestant's winnings. With
+    // --demo-feed a background thread also plays simulated contestants (ids from
+    // kDemoPlayerBase), for demos without a venue server.
+    constexpr std::uint32_t kDemoPlayerBase = 1000000;
+    Leaderboard leaderboard;
+    std::uint32_t nextContestant = 1;
+    std::atomic<bool> feedRunning{true};
+    std::thread venueFeed;
+    if (demoFeed) venueFeed = std::thread([&]{
+        std::mt19937_64 feedRng{game_seed(seed, 1)};
+        ThresholdPolicy policy;
+        std::uint32_t gameId = 0;
+        while (feedRunning.load(std::memory_order_relaxed)) {
+            policy.ratio = 0.6 + 0.4 * static_cast<double>(feedRng() >> 11) * 0x1.0p-53;
+            const GameResult res = play_game(feedRng, policy, gameId++, nullptr);
+            leaderboard.add_winnings(kDemoPlayerBase + sim_bounded(feedRng, 5000), res.winningsCents);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
 
     // Button setup
     Button button;
+    LeaderboardPanel board;
     auto layout = [&](){
-        // Center button in window
+        // Leaderboard along the right edge, button centered in the remaining space
         int ww, wh; SDL_GetWindowSize(window, &ww, &wh);
+        const int panelW = 320, margin = 16;
+        board.set_rect({ ww - panelW - margin, margin, panelW, wh - 2 * margin });
         int bw = 200, bh = 60;
-        button.rect = { (ww - bw)/2, (wh - bh)/2, bw, bh };
+        const int areaW = board.rect().x;
+        button.rect = { (areaW - bw)/2, (wh - bh)/2, bw, bh };
     };
     layout();
 
+    // Fixed-step clock: timers (and game logic) advance in 10 ms ticks independent of the
+    // render frame rate. Expired timers are collected per frame and handled in one batch.
+    // The show flow sleeps on the same wheel through the scheduler.
+    constexpr Uint64 kStepMs = 10;
+    constexpr std::uint64_t kIdleTimeoutTicks = 60000 / kStepMs; // back to attract colors after 60 s
+    enum ClientTimer : std::uint32_t { kIdleTimeout };
+    Uint64 clockStartMs = SDL_GetTicks64();
+    ShowScheduler scheduler;
+    TimerWheel& timers = scheduler.timers();
+    std::vector<TimerEvent> expired;
+    TimerId idleTimer = timers.schedule_in(kIdleTimeoutTicks, kIdleTimeout, 0);
+    auto note_activity = [&](){
+        timers.cancel(idleTimer);
+        idleTimer = timers.schedule_in(kIdleTimeoutTicks, kIdleTimeout, 0);
+    };
+
+    // The show itself: same flow code as the server, paced for an audience
+    ShowTiming showTiming;
+    showTiming.introTicks = 1500 / kStepMs;
+    showTiming.revealTicks = 800 / kStepMs;
+    showTiming.bankerCallTicks = 2000 / kStepMs;
+    showTiming.finaleTicks = 3000 / kStepMs;
+    ShowFiber showFiber;
+    ShowState showState;
+    LocalStage stage;
+    stage.onRejected = [&](){ play_beep(220.0f, 0.15f); };
+    std::mt19937_64 showRng{game_seed(seed, 2)};
+
+    // Hot standby: a primary logs every show start and accepted input; a standby replays
+    // them into the same fiber until the primary goes away, then runs the show itself
+    ReplicationPrimary replication;
+    if (primaryPath && !replication.listen(primaryPath, showTiming, kStepMs)) primaryPath = nullptr;
+    ReplicationStandby standby(scheduler, showTiming, [&](std::uint32_t show) {
+        return show == 0 ? ReplicaSlot{ &showFiber, &showState, &stage } : ReplicaSlot{};
+    });
+    bool following = standbyPath != nullptr; // Showing the primary's show, input disabled
+
+    // Replays: the recorder logs what the primary ships; the player drives the show from a
+    // file on a scheduler of its own. Seeks run headless, so only the frame they land on
+    // is drawn.
+    ReplayWriter recorder;
+    if (recordPath) recorder.open(recordPath, showTiming, kStepMs);
+    ReplayPlayer player(ReplicaSlot{ &showFiber, &showState, &stage });
+    const bool replaying = replayPath && player.open(replayPath);
+    std::uint64_t replayTick = replaying ? player.now() : 0; // Playback position at replayMs
+
+    // A finished show leaves the replication history and, unless it is a recording being
+    // played back (seeks replay the same finish again), posts its result
+    stage.onFinished = [&](const ShowState& st) {
+        replication.show_ended(0);
+        if (!replaying) leaderboard.add_winnings(nextContestant++, st.winningsCents);
+    };
+    Uint64 replayMs = SDL_GetTicks64();
+    auto replay_seek = [&](std::int64_t deltaMs, bool toStart, bool toEnd){
+        const std::int64_t ticks = deltaMs / static_cast<std::int64_t>(std::max(player.tick_ms(), 1u));
+        std::uint64_t target = player.now();
+        if (toStart) target = player.start_tick();
+        else if (toEnd) target = player.end_tick();
+        else if (ticks < 0) target = target - player.start_tick() > static_cast<std::uint64_t>(-ticks) ? target - static_cast<std::uint64_t>(-ticks) : player.start_tick();
+        else target += static_cast<std::uint64_t>(ticks);
+        player.seek(target);
+        replayTick = player.now();
+        replayMs = SDL_GetTicks64();
+    };
+
+    auto start_show = [&](){
+        for (int i = 0; i < kNumCases; i++) showState.cases[static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(i);
+        for (std::uint32_t i = kNumCases - 1; i > 0; i--) std::swap(showState.cases[i], showState.cases[sim_bounded(showRng, i + 1)]);
+        showFiber.start(scheduler, run_show(showFiber, stage, showState, showTiming));
+        replication.show_started(0, timers.now(), showState);
+        recorder.show_started(timers.now(), showState);
+    };
+    auto post_input = [&](const ShowInput& in){
+        if (!showFiber.post(in)) return;
+        replication.input(0, timers.now(), in, showState);
+        recorder.input(timers.now(), in, showState);
+    };
+    // Button: the contestant's next move (cases are chosen at random until the board UI lands)
+    auto show_action = [&](){
+        std::uint8_t pick = 0;
+        do pick = static_cast<std::uint8_t>(sim_bounded(showRng, kNumCases));
+        while (pick == showState.contestantCase || (showState.openedCases & (1u << pick)));
+        if (following || replaying) return;
+        switch (showState.step) {
+        case ShowStep::PickCase: post_input(ShowInput{ ShowInput::PickCase, pick }); break;
+        case ShowStep::OpenCases: post_input(ShowInput{ ShowInput::OpenCase, pick }); break;
+        case ShowStep::Offer: post_input(ShowInput{ ShowInput::NoDeal, 0 }); break;
+        case ShowStep::Finished: start_show(); break;
+        default: break; // Mid-animation: ignore
+        }
+    };
+    if (!following && !replaying) start_show();
+
+    // Buzzers are polled on a thread of their own. The virtual one exists only inside SDL,
+    // for trying the whole buzzer path without hardware; that thread creates it too.
+    BuzzerInput buzzers;
+    buzzers.start(virtualBuzzer);
+    std::uint64_t buzzerApplied = 0;
+    double buzzerLagSumMs = 0, buzzerLagMaxMs = 0;
+
+    // Broadcast export: state every frame, frames read back from the renderer on request
+    BroadcastExport broadcast;
+    if (exportName && !broadcast.open(exportName, exportFrames ? 1920 : 0, exportFrames ? 1080 : 0))
+        std::fprintf(stderr, "Broadcast export disabled\n");
+
+    // Archive capture at the window's starting size; encoding and disk I/O run on worker
+    // threads, the loop only pays for the readback
+    VideoCapture capture;
+    if (capturePath) {
+        int ow = 0, oh = 0;
+        SDL_GetRendererOutputSize(renderer, &ow, &oh);
+        CaptureOptions opt;
+        opt.fps = captureFps;
+        const std::size_t len = std::strlen(capturePath);
+        opt.compress = len > 5 && !std::strcmp(capturePath + len - 5, ".dcap");
+        if (!capture.open(capturePath, ow, oh, opt)) std::fprintf(stderr, "Capture disabled\n");
+    }
+
+    // Studio displays. Text is rasterized once for all windows; each renderer keeps its
+    // own textures.
+    TextRasterCache textRaster;
+    TextTextureCache mainText(renderer, textRaster);
+    TextLayoutCache textLayouts;
+    GlyphAtlas mainAtlas(renderer);
+    std::vector<std::unique_ptr<ShowDisplay>> displays;
+    for (const char* p = displayList; p && *p;) {
+        const char* end = std::strchr(p, ',');
+        const std::size_t len = end ? static_cast<std::size_t>(end - p) : std::strlen(p);
+        DisplayRole role{};
+        if (!parse_display_role(p, len, role)) {
+            std::fprintf(stderr, "Unknown display '%.*s' (host, podium or audience)\n", static_cast<int>(len), p);
+        } else {
+            auto d = std::make_unique<ShowDisplay>(role, textRaster, textLayouts);
+            if (d->open(static_cast<int>(displays.size()) + 1, rendererIndex)) displays.push_back(std::move(d));
+        }
+        p = end ? end + 1 : nullptr;
+    }
+    GlyphSet counterGlyphs;
+    const bool haveCounters = !displays.empty() && counterGlyphs.load(font);
+    const DisplayFonts displayFonts{ font, smallFont, haveCounters ? &counterGlyphs : nullptr };
+
+    // Draw the main window only while someone can see it: full rate with focus, 20 fps
+    // without, not at all when hidden or minimized. The loop itself keeps the game's tick.
+    const Uint32 mainWindowId = SDL_GetWindowID(window);
+    RenderPacer pacer(window, 20, static_cast<int>(kStepMs));
+
     // Main loop variables
     bool running = true;
     bool mouseDown = false;
@@ -155,9 +443,19 @@ int main(int, char**) {
 
         // Process events
         while (SDL_PollEvent(&e)) {
+            if (e.type == SDL_WINDOWEVENT && e.window.windowID == mainWindowId) pacer.on_window_event(e.window);
             if (e.type == SDL_QUIT) running = false;
+            else if (e.type == SDL_WINDOWEVENT && e.window.windowID != mainWindowId) {
+                // A studio display: closing it only closes that output
+                if (e.window.event == SDL_WINDOWEVENT_CLOSE)
+                    for (auto& d : displays)
+                        if (d->window_id() == e.window.windowID) d->close();
+            }
             else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_RESIZED) layout();
+            // Studio displays take no mouse input
+            else if ((e.type == SDL_MOUSEBUTTONDOWN || e.type == SDL_MOUSEBUTTONUP) && e.button.windowID != mainWindowId) continue;
             else if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
+                note_activity();
                 mouseDown = true;
                 // Only start click if mouse down inside button
                 button.activePress = point_in_rect(e.button.x, e.button.y, button.rect);
@@ -168,10 +466,10 @@ int main(int, char**) {
                 bool releaseOver = point_in_rect(e.button.x, e.button.y, button.rect);
                 if (button.activePress && releaseOver) {
                     // Change background to random color + play beep
-                    bgR = static_cast<Uint8>(dist(rng));
-                    bgG = static_cast<Uint8>(dist(rng));
-                    bgB = static_cast<Uint8>(dist(rng));
+                    fade_background_to(Rgb8{ static_cast<std::uint8_t>(dist(rng)), static_cast<std::uint8_t>(dist(rng)),
+                                             static_cast<std::uint8_t>(dist(rng)) });
                     play_beep();
+                    show_action();
                 }
                 // Reset press state regardless
                 mouseDown = false;
@@ -183,21 +481,223 @@ int main(int, char**) {
                 button.hovered = point_in_rect(e.motion.x, e.motion.y, button.rect);
                 button.pressed = (button.activePress && mouseDown && button.hovered);
             }
+            else if ((e.type == SDL_KEYDOWN || e.type == SDL_KEYUP) && virtualBuzzer && !e.key.repeat
+                     && (e.key.keysym.sym == SDLK_1 || e.key.keysym.sym == SDLK_2)) {
+                buzzers.set_virtual_button(e.key.keysym.sym == SDLK_1 ? 0 : 1, e.type == SDL_KEYDOWN);
+            }
+            else if (e.type == SDL_KEYDOWN && replaying) {
+                switch (e.key.keysym.sym) {
+                case SDLK_LEFT: replay_seek(-10000, false, false); break;
+                case SDLK_RIGHT: replay_seek(10000, false, false); break;
+                case SDLK_PAGEUP: replay_seek(-60000, false, false); break;
+                case SDLK_PAGEDOWN: replay_seek(60000, false, false); break;
+                case SDLK_HOME: replay_seek(0, true, false); break;
+                case SDLK_END: replay_seek(0, false, true); break;
+                default: break;
+                }
+            }
+            else if (e.type == SDL_KEYDOWN && !following && showState.step == ShowStep::Offer
+                     && (e.key.keysym.sym == SDLK_d || e.key.keysym.sym == SDLK_n)) {
+                note_activity();
+                post_input(ShowInput{ e.key.keysym.sym == SDLK_d ? ShowInput::Deal : ShowInput::NoDeal, 0 });
+            }
+            else if (e.type == SDL_MOUSEWHEEL && point_in_rect(mouseX, mouseY, board.rect())) {
+                note_activity();
+                leaderboard_panel_scroll(board, e.wheel.y, leaderboard.snapshot()->size());
+            }
+        }
+
+        // Standby: the primary's log drives the scheduler until the primary is gone. On
+        // takeover the local clock resumes at the primary's tick.
+        if (following && standby.poll(standbyPath, 0) == ReplicationStandby::Status::FailedOver) {
+            following = false;
+            clockStartMs = SDL_GetTicks64() - standby.tick_at(repl_now_ns()) * kStepMs;
+            timers.cancel(idleTimer);
+            idleTimer = timers.schedule_in(kIdleTimeoutTicks, kIdleTimeout, 0);
+            if (!showFiber.running()) start_show(); // Primary died before the first show
+        }
+
+        // Fixed-step update: run every tick elapsed since the last frame. While following,
+        // the primary's log moved the clock, and our own timers fired along the way.
+        expired.clear();
+        standby.take_timers(expired);
+        // Buzzer presses first, each at the tick it happened, so the flow sees them in
+        // order with its own timers however late in the frame they are read. Presses come
+        // oldest first; the scheduler advances once per distinct tick, not once per press.
+        BuzzerPress presses[32];
+        if (const std::size_t pressCount = buzzers.take(presses, std::size(presses))) {
+            note_activity();
+            const Uint64 counter = SDL_GetPerformanceCounter();
+            const double countsPerMs = static_cast<double>(SDL_GetPerformanceFrequency()) / 1000.0;
+            const Uint64 nowMs = SDL_GetTicks64();
+            std::uint64_t advancedTo = 0;
+            for (std::size_t i = 0; i < pressCount && !following && !replaying; i++) {
+                const double ageMs = static_cast<double>(counter - presses[i].counter) / countsPerMs;
+                const Uint64 pressMs = nowMs - std::min(nowMs, static_cast<Uint64>(ageMs));
+                const std::uint64_t pressTick = pressMs > clockStartMs ? (pressMs - clockStartMs) / kStepMs : 0;
+                if (pressTick > advancedTo) {
+                    if (pressTick > timers.now()) scheduler.advance(pressTick - 1, expired);
+                    advancedTo = pressTick;
+                }
+                if (showState.step != ShowStep::Offer) continue;
+                post_input(ShowInput{ presses[i].deal ? ShowInput::Deal : ShowInput::NoDeal, 0 });
+                ++buzzerApplied;
+                buzzerLagSumMs += ageMs;
+                buzzerLagMaxMs = std::max(buzzerLagMaxMs, ageMs);
+            }
+        }
+        if (!following) scheduler.advance((SDL_GetTicks64() - clockStartMs) / kStepMs, expired);
+        if (replaying) player.play_to(std::min(replayTick + (SDL_GetTicks64() - replayMs) / std::max(player.tick_ms(), 1u), player.end_tick()));
+        const std::uint64_t showTick = replaying ? player.now() : timers.now();
+        for (const TimerEvent& t : expired) {
+            if (t.kind == kIdleTimeout) {
+                // Nobody touched the game for a while: return to the idle look
+                fade_background_to(kIdleBg);
+                idleTimer = timers.schedule_in(kIdleTimeoutTicks, kIdleTimeout, 0);
+            }
+        }
+        // Ship this frame's inputs (and a heartbeat) before rendering can block on vsync
+        replication.flush(timers.now());
+        recorder.flush();
+        broadcast.publish_state(showState, showTick);
+
+        // Studio displays present without vsync, each when its monitor is due, before the
+        // main window blocks on its own vsync
+        const std::uint64_t nowNs = static_cast<std::uint64_t>(SDL_GetTicks64()) * 1000000u;
+        for (auto& d : displays)
+            if (d->due(nowNs)) d->render(showState, showTick, replaying ? player.tick_ms() : kStepMs, displayFonts, nowNs);
+
+        // Main window not visible (or not due): game, replication and audio carry on, the
+        // frame is skipped
+        if (!pacer.frame_due(nowNs)) {
+            textRaster.end_frame();
+            textLayouts.end_frame();
+            pacer.wait(nowNs);
+            continue;
         }
 
         // Draw background
-        SDL_SetRenderDrawColor(renderer, bgR, bgG, bgB, 255);
+        const Uint64 fadeMs = SDL_GetTicks64() - bgFadeStartMs;
+        bg = fadeMs >= kBgFadeMs ? bgTo : mix_srgb(bgFrom, bgTo, static_cast<float>(fadeMs) / static_cast<float>(kBgFadeMs));
+        SDL_SetRenderDrawColor(renderer, bg.r, bg.g, bg.b, 255);
         SDL_RenderClear(renderer);
 
-        // Draw button
-        render_button(renderer, button, font, "Click me!");
+        // Draw the show caption above the button, labelled with the next move
+        char caption[128];
+        const char* action = nullptr;
+        show_caption(showState, caption, sizeof(caption), action);
+        const SDL_Color white{ 255, 255, 255, 255 };
+        mainText.draw(font, caption, button.rect.x + button.rect.w / 2, button.rect.y - 80, white);
+        if (following) {
+            const bool live = standby.status() == ReplicationStandby::Status::Following;
+            mainText.draw(smallFont, live ? "STANDBY - following the primary" : "STANDBY - no primary",
+                          button.rect.x + button.rect.w / 2, button.rect.y - 120, white);
+        }
+        if (replaying) {
+            const std::uint64_t tickMs = player.tick_ms();
+            const std::uint64_t at = (player.now() - std::min(player.now(), player.start_tick())) * tickMs / 1000;
+            const std::uint64_t total = (player.end_tick() - player.start_tick()) * tickMs / 1000;
+            char label[96];
+            std::snprintf(label, sizeof(label), "REPLAY %llu:%02llu:%02llu / %llu:%02llu:%02llu",
+                          static_cast<unsigned long long>(at / 3600), static_cast<unsigned long long>(at / 60 % 60),
+                          static_cast<unsigned long long>(at % 60), static_cast<unsigned long long>(total / 3600),
+                          static_cast<unsigned long long>(total / 60 % 60), static_cast<unsigned long long>(total % 60));
+            mainText.draw(smallFont, label, button.rect.x + button.rect.w / 2, button.rect.y - 120, white);
+        }
+        render_button(renderer, mainText, button, font, action);
+        if (bankerArt && showState.step == ShowStep::BankerCall) {
+            int aw = 0, ah = 0;
+            SDL_QueryTexture(bankerArt, nullptr, nullptr, &aw, &ah);
+            const int side = 160;
+            const int dw = aw >= ah ? side : side * aw / std::max(ah, 1);
+            const int dh = aw >= ah ? side * ah / std::max(aw, 1) : side;
+            const SDL_Rect dst{ button.rect.x + (button.rect.w - dw) / 2, button.rect.y + button.rect.h + 24, dw, dh };
+            SDL_RenderCopy(renderer, bankerArt, nullptr, &dst);
+        }
+
+        // Rules, the banker's words or the next prompt, wrapped under the button
+        char prompt[512];
+        show_prompt(showState, prompt, sizeof(prompt));
+        const int promptW = board.rect().x - 80;
+        if (prompt[0] && promptW > 0) {
+            const TextLayout& run = textLayouts.get(smallFont, prompt, promptW, TextAlign::Center);
+            const int artH = bankerArt && showState.step == ShowStep::BankerCall ? 160 + 24 : 0;
+            mainAtlas.draw(smallFont, run, board.rect().x / 2 - run.width / 2, button.rect.y + button.rect.h + 24 + artH, white);
+        }
+
+        // Draw leaderboard from one pinned snapshot
+        const auto snap = leaderboard.snapshot();
+        render_leaderboard_panel(renderer, smallFont, board, *snap);
+
+        // Copy the finished frame into the broadcast slot before presenting; the backbuffer
+        // is undefined afterwards
+        if (broadcast.exports_frames()) {
+            int ow = 0, oh = 0;
+            SDL_GetRendererOutputSize(renderer, &ow, &oh);
+            const ExportFrame frame = broadcast.begin_frame(ow, oh);
+            const SDL_Rect area{ 0, 0, frame.width, frame.height };
+            SDL_RenderReadPixels(renderer, &area, SDL_PIXELFORMAT_ARGB8888, frame.pixels, frame.pitch);
+            broadcast.end_frame(showTick);
+        }
+        if (capture.frame_due(static_cast<std::uint64_t>(SDL_GetTicks64()) * 1000000u)) {
+            int ow = 0, oh = 0;
+            SDL_GetRendererOutputSize(renderer, &ow, &oh);
+            const CaptureBuffer buf = capture.begin_frame(ow, oh);
+            if (buf.pixels) {
+                const SDL_Rect area{ 0, 0, buf.width, buf.height };
+                SDL_RenderReadPixels(renderer, &area, SDL_PIXELFORMAT_ARGB8888, buf.pixels, buf.pitch);
+                capture.submit();
+            }
+        }
 
         // Present frame
         SDL_RenderPresent(renderer);
+        mainText.end_frame();
+        mainAtlas.end_frame();
+        textRaster.end_frame();
+        textLayouts.end_frame();
+        pacer.presented(nowNs);
+        pacer.wait(static_cast<std::uint64_t>(SDL_GetTicks64()) * 1000000u);
     }
 
     // Cleanup
+    pacer.report(stdout);
+    if (capture.is_open()) {
+        capture.close();
+        const CaptureStats cs = capture.stats();
+        std::printf("Captured %llu frames (%llu dropped), %.1f MB, readback %.2f ms/frame on the main loop\n",
+                    static_cast<unsigned long long>(cs.frames), static_cast<unsigned long long>(cs.dropped),
+                    static_cast<double>(cs.bytes) / 1e6,
+                    cs.frames ? static_cast<double>(cs.mainNs) / static_cast<double>(cs.frames) / 1e6 : 0.0);
+    }
+    recorder.close(timers.now());
+    if (player.mismatches())
+        std::printf("Replay: %llu records played out differently than recorded\n",
+                    static_cast<unsigned long long>(player.mismatches()));
+    buzzers.stop();
+    if (buzzers.presses())
+        std::printf("Buzzers: %llu presses (%llu dropped), %llu decisions; poll to game %.2f ms mean, %.2f ms max\n",
+                    static_cast<unsigned long long>(buzzers.presses()), static_cast<unsigned long long>(buzzers.dropped()),
+                    static_cast<unsigned long long>(buzzerApplied),
+                    buzzerApplied ? buzzerLagSumMs / static_cast<double>(buzzerApplied) : 0.0, buzzerLagMaxMs);
+    showFiber.stop();
+    feedRunning = false;
+    if (venueFeed.joinable()) venueFeed.join();
     if (dev) SDL_CloseAudioDevice(dev);
+    board.list.release();
+    if (bankerArt) SDL_DestroyTexture(bankerArt);
+    for (const auto& d : displays) {
+        const CullStats& c = d->culler().totals();
+        const double frames = static_cast<double>(std::max<std::uint64_t>(d->frames(), 1));
+        std::printf("%s display: %llu frames, widgets per frame %.1f drawn, %.1f offscreen, %.1f occluded\n",
+                    display_role_name(d->role()), static_cast<unsigned long long>(d->frames()), c.drawn / frames,
+                    c.offscreen / frames, c.occluded / frames);
+    }
+    displays.clear();
+    mainText.release();
+    mainAtlas.release();
+    textRaster.clear();
+    TTF_CloseFont(smallFont);
     TTF_CloseFont(font);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
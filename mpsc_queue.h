@@ -0,0 +1,157 @@
+// mpsc_queue.h
+// Bounded lock-free multi-producer / single-consumer queue used to hand commands to the
+// thread that owns a game shard (and replies back to the network thread).
+//
+// Ring of cells with per-cell sequence numbers: producers claim a position with one CAS on
+// the tail and publish by bumping the cell's sequence, so they never wait for each other;
+// the single consumer takes whole runs of published cells per call. Tail, head and the idle
+// flag sit on separate cache lines so producers and the consumer don't share a line.
+//
+// Waking the consumer goes through an eventfd, but only when the consumer has announced it
+// is idle: while it is busy draining, pushes cost no syscall at all.
+
+#pragma once
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+template <class T>
+class MpscQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "queue items are copied in and out of cells");
+
+public:
+    // Capacity is rounded up to a power of two
+    explicit MpscQueue(std::size_t capacity) {
+        std::size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        cells_ = std::make_unique<Cell[]>(cap);
+        for (std::size_t i = 0; i < cap; i++) cells_[i].seq.store(i, std::memory_order_relaxed);
+        wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    ~MpscQueue() {
+        if (wakeFd_ >= 0) ::close(wakeFd_);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread. Returns false when the queue is full.
+    bool try_push(const T& item) {
+        Cell* cell;
+        std::size_t pos = tail_.value.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (tail_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // The consumer hasn't freed this cell yet
+            } else {
+                pos = tail_.value.load(std::memory_order_relaxed);
+            }
+        }
+        cell->item = item;
+        // Publish. Sequentially consistent together with the idle flag: either the consumer
+        // sees this item when it re-checks before sleeping, or we see it idle and wake it.
+        cell->seq.store(pos + 1, std::memory_order_seq_cst);
+        if (idle_.value.load(std::memory_order_seq_cst) && idle_.value.exchange(false, std::memory_order_acq_rel)) wake();
+        return true;
+    }
+
+    // Consumer only. Moves up to `max` items to `out`; returns how many.
+    std::size_t pop_batch(T* out, std::size_t max) {
+        std::size_t n = 0;
+        std::size_t pos = head_.value;
+        while (n < max) {
+            Cell& cell = cells_[pos & mask_];
+            if (cell.seq.load(std::memory_order_acquire) != pos + 1) break;
+            out[n++] = cell.item;
+            cell.seq.store(pos + mask_ + 1, std::memory_order_release); // Free for the next lap
+            ++pos;
+        }
+        head_.value = pos;
+        return n;
+    }
+
+    // Consumer only: announce that the consumer is about to block on wake_fd(). Returns
+    // false (and stays busy) if an item is already available, in which case don't block.
+    bool prepare_wait() {
+        idle_.value.store(true, std::memory_order_seq_cst);
+        if (cells_[head_.value & mask_].seq.load(std::memory_order_seq_cst) == head_.value + 1) {
+            idle_.value.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    // Consumer only: back to busy after a wait (whether or not it was woken)
+    void finish_wait() { idle_.value.store(false, std::memory_order_relaxed); }
+
+    // Consumer only: block until an item is pushed or `timeoutMs` passes (-1 = forever).
+    // Yields a few times first: producers that are mid-burst refill the queue without the
+    // consumer paying for a sleep/wake round trip, and the next batch comes out larger.
+    // For consumers that wait on something else, use prepare_wait()/finish_wait() around
+    // their own poll on wake_fd() instead.
+    void wait(int timeoutMs) {
+        for (int i = 0; i < kSpinYields; i++) {
+            if (available()) return;
+            std::this_thread::yield();
+        }
+        if (!prepare_wait()) return;
+        pollfd pfd{ wakeFd_, POLLIN, 0 };
+        if (::poll(&pfd, 1, timeoutMs) > 0) drain_wake_fd();
+        finish_wait();
+    }
+
+    // Wake the consumer regardless of its state (shutdown, configuration changes)
+    void wake() {
+        const std::uint64_t one = 1;
+        wakeups_.value.fetch_add(1, std::memory_order_relaxed);
+        [[maybe_unused]] const ssize_t w = ::write(wakeFd_, &one, sizeof(one));
+    }
+
+    // Reset the eventfd counter after it signalled
+    void drain_wake_fd() {
+        std::uint64_t v;
+        [[maybe_unused]] const ssize_t r = ::read(wakeFd_, &v, sizeof(v));
+    }
+
+    // Consumer only: an item is ready to pop
+    bool available() const {
+        return cells_[head_.value & mask_].seq.load(std::memory_order_acquire) == head_.value + 1;
+    }
+
+    int wake_fd() const { return wakeFd_; }
+    std::size_t capacity() const { return mask_ + 1; }
+    std::uint64_t wakeups() const { return wakeups_.value.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int kSpinYields = 16;
+
+    struct Cell {
+        std::atomic<std::size_t> seq{0}; // pos + 1 once published, pos + capacity once consumed
+        T item{};
+    };
+    template <class V>
+    struct alignas(64) Padded {
+        V value{};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_{0};
+    int wakeFd_{-1};
+    Padded<std::atomic<std::size_t>> tail_;     // Next position producers claim
+    Padded<std::size_t> head_;                  // Next position the consumer reads
+    Padded<std::atomic<bool>> idle_;            // Consumer is (about to be) blocked
+    Padded<std::atomic<std::uint64_t>> wakeups_; // eventfd writes, for benchmarks
+};
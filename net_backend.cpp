@@ -0,0 +1,712 @@
+// net_backend.cpp
+// epoll and io_uring transports. io_uring is driven through the raw syscalls and the
+// <linux/io_uring.h> ABI so the server has no dependency beyond the kernel headers.
+
+#include "net_backend.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// ---------------------------------------------------------------------------------------
+// Shared helpers
+// ---------------------------------------------------------------------------------------
+
+int open_listen_socket(const char* host, std::uint16_t port, int flags) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | flags, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host, &addr.sin_addr) != 1
+        || ::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0
+        || ::listen(fd, 512) != 0) {
+        std::fprintf(stderr, "net: cannot listen on %s:%u: %s\n", host, port, std::strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int bound_port(int fd) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    if (::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) return -1;
+    return ntohs(addr.sin_port);
+}
+
+// accept() failures that persist until some connection closes
+bool out_of_fds(int err) {
+    return err == EMFILE || err == ENFILE || err == ENOBUFS || err == ENOMEM;
+}
+
+// How long to stop accepting after running out of descriptors
+constexpr std::chrono::milliseconds kAcceptBackoff{100};
+
+void set_nodelay(int fd) {
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+// Slot/generation bookkeeping shared by both backends
+template <class Conn>
+class ConnTable {
+public:
+    ConnTable() : conns_(kNetMaxConns) {
+        for (std::size_t i = kNetMaxConns; i-- > 0;) free_.push_back(static_cast<std::uint16_t>(i));
+    }
+
+    // Returns the slot, or -1 when full
+    int alloc() {
+        if (free_.empty()) return -1;
+        const std::uint16_t slot = free_.back();
+        free_.pop_back();
+        return slot;
+    }
+    // Releasing a slot that is already free is a no-op, so it can never be handed out twice
+    void release(std::size_t slot) {
+        if (conns_[slot].fd < 0) return;
+        Conn fresh{};
+        fresh.gen = static_cast<std::uint16_t>(conns_[slot].gen + 1);
+        if (fresh.gen == 0) fresh.gen = 1;
+        conns_[slot] = std::move(fresh);
+        free_.push_back(static_cast<std::uint16_t>(slot));
+    }
+
+    static std::size_t slot_of(ConnId id) { return id & 0xFFFFu; }
+    ConnId id_of(std::size_t slot) const { return (static_cast<ConnId>(conns_[slot].gen) << 16) | static_cast<ConnId>(slot); }
+
+    // Live connection for a handle, or nullptr if stale
+    Conn* find(ConnId id) {
+        const std::size_t slot = slot_of(id);
+        if (slot >= conns_.size()) return nullptr;
+        Conn& c = conns_[slot];
+        return (c.fd >= 0 && c.gen == (id >> 16)) ? &c : nullptr;
+    }
+    Conn& at(std::size_t slot) { return conns_[slot]; }
+    std::size_t size() const { return conns_.size(); }
+
+private:
+    std::vector<Conn> conns_;
+    std::vector<std::uint16_t> free_;
+};
+
+// ---------------------------------------------------------------------------------------
+// epoll backend
+// ---------------------------------------------------------------------------------------
+
+class EpollBackend final : public NetBackend {
+public:
+    ~EpollBackend() override {
+        for (std::size_t i = 0; i < table_.size(); i++)
+            if (table_.at(i).fd >= 0) ::close(table_.at(i).fd);
+        if (listenFd_ >= 0) ::close(listenFd_);
+        if (epfd_ >= 0) ::close(epfd_);
+    }
+
+    bool init() {
+        epfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        return epfd_ >= 0;
+    }
+
+    const char* name() const override { return "epoll"; }
+
+    int listen(const char* host, std::uint16_t port) override {
+        listenFd_ = open_listen_socket(host, port, SOCK_NONBLOCK);
+        if (listenFd_ < 0) return -1;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = kListenTag;
+        ::epoll_ctl(epfd_, EPOLL_CTL_ADD, listenFd_, &ev);
+        return bound_port(listenFd_);
+    }
+
+    void poll(std::vector<NetEvent>& out, int timeoutMs) override {
+        retiredBufs_.clear(); // The caller is done with the last poll's Data events
+        for (ConnId id : lagging_) out.push_back(NetEvent{ NetEventType::Closed, id, nullptr, 0 });
+        lagging_.clear();
+        flush(out);
+        timeoutMs = resume_accepting(timeoutMs);
+
+        epoll_event events[256];
+        const int n = ::epoll_wait(epfd_, events, 256, timeoutMs);
+        ++stats_.syscalls;
+        for (int i = 0; i < n; i++) {
+            const epoll_event& ev = events[i];
+            if (ev.data.u64 == kListenTag) { accept_all(out); continue; }
+            if (ev.data.u64 == kWakeTag) {
+                std::uint64_t v;
+                [[maybe_unused]] const ssize_t r = ::read(wakeFd_, &v, sizeof(v));
+                ++stats_.syscalls;
+                out.push_back(NetEvent{ NetEventType::Wakeup, 0, nullptr, 0 });
+                continue;
+            }
+
+            const std::size_t slot = static_cast<std::size_t>(ev.data.u64);
+            Conn& c = table_.at(slot);
+            if (c.fd < 0) continue;
+            const ConnId id = table_.id_of(slot);
+            if ((ev.events & EPOLLOUT) && !write_some(c, slot, out)) continue; // Dropped
+            if (ev.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                // One read per readiness report; level-triggered epoll reports again if more
+                // is queued. The buffer stays untouched until the next poll().
+                const ssize_t r = ::read(c.fd, c.rbuf.data(), c.rbuf.size());
+                ++stats_.syscalls;
+                if (r > 0) {
+                    stats_.bytesIn += static_cast<std::uint64_t>(r);
+                    out.push_back(NetEvent{ NetEventType::Data, id, c.rbuf.data(), static_cast<std::size_t>(r) });
+                } else if (r == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    drop(slot);
+                    out.push_back(NetEvent{ NetEventType::Closed, id, nullptr, 0 });
+                }
+            }
+        }
+    }
+
+    bool send(ConnId id, const void* data, std::size_t n) override {
+        Conn* c = table_.find(id);
+        if (!c) return false;
+        if (c->out.size() - c->outOff + n > kNetMaxPending) {
+            // Slow consumer: drop it rather than buffer without bound
+            drop(table_.slot_of(id));
+            lagging_.push_back(id);
+            return false;
+        }
+        if (c->out.empty()) dirty_.push_back(id);
+        const auto* p = static_cast<const std::uint8_t*>(data);
+        c->out.insert(c->out.end(), p, p + n);
+        return true;
+    }
+
+    void close(ConnId id) override {
+        if (table_.find(id)) drop(table_.slot_of(id));
+    }
+
+    bool watch_wakeup(int eventFd) override {
+        wakeFd_ = eventFd;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = kWakeTag;
+        return ::epoll_ctl(epfd_, EPOLL_CTL_ADD, eventFd, &ev) == 0;
+    }
+
+private:
+    static constexpr std::uint64_t kListenTag = ~std::uint64_t{0};
+    static constexpr std::uint64_t kWakeTag = kListenTag - 1;
+
+    struct Conn {
+        std::uint16_t gen{1};
+        int fd{-1};
+        bool wantOut{false};
+        std::vector<std::uint8_t> rbuf;
+        std::vector<std::uint8_t> out; // Queued bytes; [outOff, size) not yet written
+        std::size_t outOff{0};
+    };
+
+    void accept_all(std::vector<NetEvent>& out) {
+        for (;;) {
+            const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            ++stats_.syscalls;
+            if (fd < 0) {
+                if (out_of_fds(errno)) pause_accepting();
+                return;
+            }
+            const int slot = table_.alloc();
+            if (slot < 0) { ::close(fd); continue; }
+            set_nodelay(fd);
+            Conn& c = table_.at(static_cast<std::size_t>(slot));
+            c.fd = fd;
+            c.rbuf.resize(kNetRecvBuf);
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.u64 = static_cast<std::uint64_t>(slot);
+            ::epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev);
+            stats_.syscalls += 2; // setsockopt + epoll_ctl
+            ++stats_.accepted;
+            out.push_back(NetEvent{ NetEventType::Accepted, table_.id_of(static_cast<std::size_t>(slot)), nullptr, 0 });
+        }
+    }
+
+    // False if the connection failed and was dropped (reported as Closed)
+    bool write_some(Conn& c, std::size_t slot, std::vector<NetEvent>& out) {
+        while (c.outOff < c.out.size()) {
+            const ssize_t w = ::write(c.fd, c.out.data() + c.outOff, c.out.size() - c.outOff);
+            ++stats_.syscalls;
+            if (w > 0) { c.outOff += static_cast<std::size_t>(w); stats_.bytesOut += static_cast<std::uint64_t>(w); continue; }
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0 && errno == EAGAIN) break;
+            out.push_back(NetEvent{ NetEventType::Closed, table_.id_of(slot), nullptr, 0 });
+            drop(slot);
+            return false;
+        }
+        const bool pending = c.outOff < c.out.size();
+        if (!pending) { c.out.clear(); c.outOff = 0; }
+        if (pending != c.wantOut) {
+            // Ask for writability only while the socket buffer is full
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP | (pending ? EPOLLOUT : 0u);
+            ev.data.u64 = slot;
+            ::epoll_ctl(epfd_, EPOLL_CTL_MOD, c.fd, &ev);
+            ++stats_.syscalls;
+            c.wantOut = pending;
+        }
+        return true;
+    }
+
+    void flush(std::vector<NetEvent>& out) {
+        for (ConnId id : dirty_)
+            if (Conn* c = table_.find(id)) write_some(*c, table_.slot_of(id), out);
+        dirty_.clear();
+    }
+
+    void drop(std::size_t slot) {
+        Conn& c = table_.at(slot);
+        if (c.fd < 0) return;
+        ::close(c.fd); // Also removes it from the epoll set
+        ++stats_.syscalls;
+        // Data events from this poll may still point into the receive buffer, and the slot
+        // can be reused straight away, so the buffer outlives the slot until the next poll()
+        retiredBufs_.push_back(std::move(c.rbuf));
+        table_.release(slot);
+    }
+
+    // Out of descriptors: the listen socket stays readable, so stop watching it for a
+    // while instead of spinning on accept
+    void pause_accepting() {
+        epoll_event ev{};
+        ev.data.u64 = kListenTag;
+        ::epoll_ctl(epfd_, EPOLL_CTL_MOD, listenFd_, &ev);
+        ++stats_.syscalls;
+        acceptPaused_ = true;
+        acceptRetry_ = std::chrono::steady_clock::now() + kAcceptBackoff;
+    }
+
+    // Re-arm the listen socket once the backoff is over; returns the timeout to wait with
+    int resume_accepting(int timeoutMs) {
+        if (!acceptPaused_) return timeoutMs;
+        const auto now = std::chrono::steady_clock::now();
+        if (now < acceptRetry_) {
+            const auto left = std::chrono::ceil<std::chrono::milliseconds>(acceptRetry_ - now).count();
+            return timeoutMs < 0 || left < timeoutMs ? static_cast<int>(left) : timeoutMs;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = kListenTag;
+        ::epoll_ctl(epfd_, EPOLL_CTL_MOD, listenFd_, &ev);
+        ++stats_.syscalls;
+        acceptPaused_ = false;
+        return timeoutMs;
+    }
+
+    int epfd_{-1};
+    int listenFd_{-1};
+    int wakeFd_{-1};
+    bool acceptPaused_{false};
+    std::chrono::steady_clock::time_point acceptRetry_;
+    ConnTable<Conn> table_;
+    std::vector<ConnId> dirty_;
+    std::vector<ConnId> lagging_; // Dropped for falling behind; Closed on the next poll
+    std::vector<std::vector<std::uint8_t>> retiredBufs_; // Receive buffers of dropped connections
+};
+
+// ---------------------------------------------------------------------------------------
+// io_uring backend
+// ---------------------------------------------------------------------------------------
+
+class UringBackend final : public NetBackend {
+public:
+    ~UringBackend() override {
+        for (std::size_t i = 0; i < table_.size(); i++)
+            if (table_.at(i).fd >= 0) ::close(table_.at(i).fd);
+        if (listenFd_ >= 0) ::close(listenFd_);
+        if (sqes_) ::munmap(sqes_, sqesBytes_);
+        if (ring_) ::munmap(ring_, ringBytes_);
+        if (ringFd_ >= 0) ::close(ringFd_);
+        if (arena_) ::munmap(arena_, arenaBytes_);
+    }
+
+    // Set up the rings and register the buffer arena. False if io_uring is unusable.
+    bool init() {
+        io_uring_params p{};
+        ringFd_ = static_cast<int>(::syscall(__NR_io_uring_setup, kRingEntries, &p));
+        if (ringFd_ < 0) return false;
+        // Needed: one mmap for both rings, waits with a timeout argument, no dropped CQEs
+        const unsigned need = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_EXT_ARG | IORING_FEAT_NODROP;
+        if ((p.features & need) != need) return false;
+
+        const std::size_t sqBytes = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        const std::size_t cqBytes = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        ringBytes_ = sqBytes > cqBytes ? sqBytes : cqBytes;
+        void* ring = ::mmap(nullptr, ringBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+        if (ring == MAP_FAILED) return false;
+        ring_ = static_cast<std::uint8_t*>(ring);
+        sqesBytes_ = p.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqesBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        sqHead_ = reinterpret_cast<unsigned*>(ring_ + p.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(ring_ + p.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(ring_ + p.sq_off.ring_mask);
+        sqEntries_ = p.sq_entries;
+        sqArray_ = reinterpret_cast<unsigned*>(ring_ + p.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned*>(ring_ + p.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(ring_ + p.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(ring_ + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(ring_ + p.cq_off.cqes);
+        localTail_ = *sqTail_;
+
+        // One arena holds every connection's receive and send buffers; registering it as a
+        // single fixed buffer lets READ_FIXED/WRITE_FIXED skip per-call page pinning.
+        arenaBytes_ = kNetMaxConns * (kNetRecvBuf + kNetSendBuf);
+        void* arena = ::mmap(nullptr, arenaBytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (arena == MAP_FAILED) { arena_ = nullptr; return false; }
+        arena_ = static_cast<std::uint8_t*>(arena);
+        iovec iov{ arena_, arenaBytes_ };
+        fixed_ = ::syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+        if (!fixed_) std::fprintf(stderr, "net: io_uring buffer registration failed (%s), using plain recv/send\n", std::strerror(errno));
+        return true;
+    }
+
+    const char* name() const override { return fixed_ ? "io_uring (registered buffers)" : "io_uring"; }
+
+    int listen(const char* host, std::uint16_t port) override {
+        listenFd_ = open_listen_socket(host, port, 0);
+        if (listenFd_ < 0) return -1;
+        arm_accept();
+        return bound_port(listenFd_);
+    }
+
+    void poll(std::vector<NetEvent>& out, int timeoutMs) override {
+        for (ConnId id : lagging_) out.push_back(NetEvent{ NetEventType::Closed, id, nullptr, 0 });
+        lagging_.clear();
+        // Re-arm receives whose data the caller has now consumed, queue pending writes,
+        // then submit everything and wait in a single kernel entry
+        for (ConnId id : rearm_)
+            if (Conn* c = table_.find(id)) { if (!c->closing) arm_read(table_.slot_of(id)); }
+        rearm_.clear();
+        for (ConnId id : dirty_)
+            if (table_.find(id)) arm_write(table_.slot_of(id));
+        dirty_.clear();
+
+        submit_and_wait(timeoutMs);
+        reap(out);
+    }
+
+    bool send(ConnId id, const void* data, std::size_t n) override {
+        Conn* c = table_.find(id);
+        if (!c || c->closing) return false;
+        if (c->sendLen - c->sendOff + c->overflow.size() + n > kNetMaxPending) {
+            // Slow consumer: drop it rather than buffer without bound
+            begin_close(table_.slot_of(id), *c);
+            lagging_.push_back(id);
+            return false;
+        }
+        const auto* p = static_cast<const std::uint8_t*>(data);
+        // Stage straight into the registered send buffer when possible
+        if (!c->writing && c->overflow.empty() && c->sendLen + n <= kNetSendBuf) {
+            std::memcpy(send_buf(table_.slot_of(id)) + c->sendLen, p, n);
+            c->sendLen += n;
+        } else {
+            c->overflow.insert(c->overflow.end(), p, p + n);
+        }
+        if (!c->dirty) { c->dirty = true; dirty_.push_back(id); }
+        return true;
+    }
+
+    void close(ConnId id) override {
+        if (Conn* c = table_.find(id)) begin_close(table_.slot_of(id), *c);
+    }
+
+    bool watch_wakeup(int eventFd) override {
+        wakeFd_ = eventFd;
+        arm_wakeup();
+        return true;
+    }
+
+private:
+    static constexpr unsigned kRingEntries = 4096;
+    enum Op : std::uint8_t { OpAccept = 1, OpRead = 2, OpWrite = 3, OpWakeup = 4, OpAcceptRetry = 5 };
+
+    struct Conn {
+        std::uint16_t gen{1};
+        int fd{-1};
+        bool reading{false}, writing{false}, closing{false}, dirty{false};
+        std::size_t sendLen{0}, sendOff{0};   // Staged bytes in the send buffer / written so far
+        std::vector<std::uint8_t> overflow;    // Bytes that didn't fit while a write was in flight
+    };
+
+    std::uint8_t* recv_buf(std::size_t slot) { return arena_ + slot * kNetRecvBuf; }
+    std::uint8_t* send_buf(std::size_t slot) { return arena_ + kNetMaxConns * kNetRecvBuf + slot * kNetSendBuf; }
+
+    static std::uint64_t tag(Op op, std::size_t slot, std::uint16_t gen) {
+        return (static_cast<std::uint64_t>(op) << 32) | (static_cast<std::uint64_t>(gen) << 16) | slot;
+    }
+
+    // At most an accept, a wakeup and one read and one write per connection are in flight,
+    // well under the ring size, so a full ring only needs a submit to drain
+    io_uring_sqe* get_sqe() {
+        while (localTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_)
+            if (!submit_and_wait(-1, false)) std::this_thread::yield();
+        const unsigned idx = localTail_ & sqMask_;
+        io_uring_sqe* sqe = &sqes_[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray_[idx] = idx;
+        ++localTail_;
+        return sqe;
+    }
+
+    // False if the kernel took nothing (EAGAIN/EBUSY); entries it hasn't consumed stay
+    // queued and go with the next call
+    bool submit_and_wait(int timeoutMs, bool wait = true) {
+        __atomic_store_n(sqTail_, localTail_, __ATOMIC_RELEASE);
+        const unsigned toSubmit = localTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        const bool haveCqes = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) != *cqHead_;
+        if (toSubmit == 0 && (!wait || haveCqes)) return true;
+
+        __kernel_timespec ts{};
+        ts.tv_sec = timeoutMs / 1000;
+        ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+        io_uring_getevents_arg arg{};
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+        unsigned flags = IORING_ENTER_EXT_ARG;
+        unsigned waitNr = 0;
+        if (wait && !haveCqes && timeoutMs != 0) {
+            flags |= IORING_ENTER_GETEVENTS;
+            waitNr = 1;
+            if (timeoutMs < 0) arg.ts = 0;
+        }
+        for (;;) {
+            const long r = ::syscall(__NR_io_uring_enter, ringFd_, toSubmit, waitNr, flags, &arg, sizeof(arg));
+            ++stats_.syscalls;
+            if (r >= 0 || errno == ETIME) return true; // ETIME: the wait timed out
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EBUSY) return false; // Reap, then try again
+            std::fprintf(stderr, "net: io_uring_enter failed: %s\n", std::strerror(errno));
+            return false;
+        }
+    }
+
+    // Transient failures that leave the connection usable
+    static bool retryable(int res) { return res == -EAGAIN || res == -EINTR || res == -ENOBUFS; }
+
+    void arm_accept() {
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = listenFd_;
+        sqe->accept_flags = SOCK_CLOEXEC;
+        sqe->user_data = tag(OpAccept, 0, 0);
+    }
+
+    // Out of descriptors: re-arming the accept at once would fail again straight away, so
+    // wait out the backoff on a ring timeout first
+    void arm_accept_retry() {
+        acceptBackoff_.tv_sec = 0;
+        acceptBackoff_.tv_nsec = std::chrono::nanoseconds(kAcceptBackoff).count();
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = IORING_OP_TIMEOUT;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<std::uint64_t>(&acceptBackoff_);
+        sqe->len = 1;
+        sqe->user_data = tag(OpAcceptRetry, 0, 0);
+    }
+
+    // An eventfd read completes once the counter is non-zero and resets it
+    void arm_wakeup() {
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = wakeFd_;
+        sqe->addr = reinterpret_cast<std::uint64_t>(&wakeValue_);
+        sqe->len = sizeof(wakeValue_);
+        sqe->user_data = tag(OpWakeup, 0, 0);
+    }
+
+    void arm_read(std::size_t slot) {
+        Conn& c = table_.at(slot);
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = fixed_ ? IORING_OP_READ_FIXED : IORING_OP_RECV;
+        sqe->fd = c.fd;
+        sqe->addr = reinterpret_cast<std::uint64_t>(recv_buf(slot));
+        sqe->len = static_cast<std::uint32_t>(kNetRecvBuf);
+        sqe->buf_index = 0;
+        sqe->user_data = tag(OpRead, slot, c.gen);
+        c.reading = true;
+    }
+
+    void arm_write(std::size_t slot) {
+        Conn& c = table_.at(slot);
+        c.dirty = false;
+        if (c.writing || c.closing) return;
+        if (c.sendOff == c.sendLen) {
+            // Previous write finished: restage overflow bytes into the registered buffer
+            c.sendOff = c.sendLen = 0;
+            const std::size_t n = c.overflow.size() < kNetSendBuf ? c.overflow.size() : kNetSendBuf;
+            if (n == 0) return;
+            std::memcpy(send_buf(slot), c.overflow.data(), n);
+            c.overflow.erase(c.overflow.begin(), c.overflow.begin() + static_cast<std::ptrdiff_t>(n));
+            c.sendLen = n;
+        }
+        io_uring_sqe* sqe = get_sqe();
+        sqe->opcode = fixed_ ? IORING_OP_WRITE_FIXED : IORING_OP_SEND;
+        sqe->fd = c.fd;
+        sqe->addr = reinterpret_cast<std::uint64_t>(send_buf(slot) + c.sendOff);
+        sqe->len = static_cast<std::uint32_t>(c.sendLen - c.sendOff);
+        sqe->buf_index = 0;
+        sqe->user_data = tag(OpWrite, slot, c.gen);
+        c.writing = true;
+    }
+
+    void begin_close(std::size_t slot, Conn& c) {
+        if (!c.closing) {
+            c.closing = true;
+            // Wakes any in-flight receive/send with an error or EOF
+            ::shutdown(c.fd, SHUT_RDWR);
+            ++stats_.syscalls;
+        }
+        maybe_release(slot, c);
+    }
+
+    void maybe_release(std::size_t slot, Conn& c) {
+        if (!c.closing || c.reading || c.writing) return;
+        ::close(c.fd);
+        ++stats_.syscalls;
+        table_.release(slot);
+    }
+
+    void reap(std::vector<NetEvent>& out) {
+        unsigned head = *cqHead_;
+        const unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const io_uring_cqe& cqe = cqes_[head & cqMask_];
+            const auto op = static_cast<Op>(cqe.user_data >> 32);
+            const auto gen = static_cast<std::uint16_t>(cqe.user_data >> 16);
+            const auto slot = static_cast<std::size_t>(cqe.user_data & 0xFFFFu);
+            const int res = cqe.res;
+
+            if (op == OpAccept) {
+                if (res >= 0) on_accept(res, out);
+                if (res < 0 && out_of_fds(-res)) arm_accept_retry();
+                else arm_accept();
+                continue;
+            }
+            if (op == OpAcceptRetry) {
+                arm_accept();
+                continue;
+            }
+            if (op == OpWakeup) {
+                out.push_back(NetEvent{ NetEventType::Wakeup, 0, nullptr, 0 });
+                arm_wakeup();
+                continue;
+            }
+            Conn& c = table_.at(slot);
+            if (c.fd < 0 || c.gen != gen) continue; // Stale completion
+            const ConnId id = table_.id_of(slot);
+
+            if (op == OpRead) {
+                c.reading = false;
+                if (res > 0 && !c.closing) {
+                    stats_.bytesIn += static_cast<std::uint64_t>(res);
+                    out.push_back(NetEvent{ NetEventType::Data, id, recv_buf(slot), static_cast<std::size_t>(res) });
+                    rearm_.push_back(id); // After the caller has consumed the buffer
+                } else if (retryable(res) && !c.closing) {
+                    rearm_.push_back(id);
+                } else if (!c.closing) {
+                    out.push_back(NetEvent{ NetEventType::Closed, id, nullptr, 0 });
+                    begin_close(slot, c);
+                } else {
+                    maybe_release(slot, c);
+                }
+            } else if (op == OpWrite) {
+                c.writing = false;
+                if (retryable(res) && !c.closing) {
+                    if (!c.dirty) { c.dirty = true; dirty_.push_back(id); }
+                    continue;
+                }
+                if (res < 0 || c.closing) {
+                    if (!c.closing) out.push_back(NetEvent{ NetEventType::Closed, id, nullptr, 0 });
+                    begin_close(slot, c);
+                    continue;
+                }
+                stats_.bytesOut += static_cast<std::uint64_t>(res);
+                c.sendOff += static_cast<std::size_t>(res);
+                // Short write or more queued: continue on the next poll
+                if ((c.sendOff < c.sendLen || !c.overflow.empty()) && !c.dirty) { c.dirty = true; dirty_.push_back(id); }
+                if (c.sendOff == c.sendLen && c.overflow.empty()) c.sendOff = c.sendLen = 0;
+            }
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    }
+
+    void on_accept(int fd, std::vector<NetEvent>& out) {
+        const int slot = table_.alloc();
+        if (slot < 0) { ::close(fd); return; }
+        set_nodelay(fd);
+        stats_.syscalls += 1;
+        Conn& c = table_.at(static_cast<std::size_t>(slot));
+        c.fd = fd;
+        ++stats_.accepted;
+        out.push_back(NetEvent{ NetEventType::Accepted, table_.id_of(static_cast<std::size_t>(slot)), nullptr, 0 });
+        arm_read(static_cast<std::size_t>(slot));
+    }
+
+    int ringFd_{-1};
+    int listenFd_{-1};
+    int wakeFd_{-1};
+    std::uint64_t wakeValue_{0};
+    __kernel_timespec acceptBackoff_{};
+    std::uint8_t* ring_{nullptr};
+    std::size_t ringBytes_{0};
+    io_uring_sqe* sqes_{nullptr};
+    std::size_t sqesBytes_{0};
+    unsigned* sqHead_{nullptr};
+    unsigned* sqTail_{nullptr};
+    unsigned* sqArray_{nullptr};
+    unsigned sqMask_{0}, sqEntries_{0}, localTail_{0};
+    unsigned* cqHead_{nullptr};
+    unsigned* cqTail_{nullptr};
+    unsigned cqMask_{0};
+    io_uring_cqe* cqes_{nullptr};
+
+    std::uint8_t* arena_{nullptr};
+    std::size_t arenaBytes_{0};
+    bool fixed_{false};
+
+    ConnTable<Conn> table_;
+    std::vector<ConnId> rearm_;
+    std::vector<ConnId> dirty_;
+    std::vector<ConnId> lagging_; // Dropped for falling behind; Closed on the next poll
+};
+
+} // namespace
+
+std::unique_ptr<NetBackend> make_net_backend(NetBackendKind kind) {
+    if (kind != NetBackendKind::Epoll) {
+        auto uring = std::make_unique<UringBackend>();
+        if (uring->init()) return uring;
+        std::fprintf(stderr, "net: io_uring unavailable, falling back to epoll\n");
+    }
+    auto ep = std::make_unique<EpollBackend>();
+    if (!ep->init()) return nullptr;
+    return ep;
+}
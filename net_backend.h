@@ -0,0 +1,81 @@
+// net_backend.h
+// TCP transport for the hosted game server, with two interchangeable backends:
+//
+//   io_uring  Accepts, receives and sends through one submission ring. Receive and send
+//             buffers live in a single registered arena (READ_FIXED / WRITE_FIXED), so the
+//             kernel doesn't map pages per call, and a whole poll's worth of sends, re-armed
+//             receives and the wait itself go to the kernel in one io_uring_enter().
+//   epoll     Readiness-based fallback for kernels or sandboxes without io_uring.
+//
+// Both deliver events in batches from poll() and coalesce everything sent to a connection
+// between two polls into one write. Single-threaded: one backend per server loop thread.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Connection handle: slot (low 16 bits) | generation (high 16 bits). Handles of closed
+// connections are recognised as stale and ignored.
+using ConnId = std::uint32_t;
+
+// Wakeup: an fd registered with watch_wakeup() was signalled
+enum class NetEventType : std::uint8_t { Accepted, Data, Closed, Wakeup };
+
+struct NetEvent {
+    NetEventType type{NetEventType::Data};
+    ConnId conn{0};
+    const std::uint8_t* data{nullptr}; // Data: received bytes, valid until the next poll()
+    std::size_t size{0};
+};
+
+enum class NetBackendKind : std::uint8_t { Auto, IoUring, Epoll };
+
+// Counters for comparing backends
+struct NetStats {
+    std::uint64_t syscalls{0}; // Kernel entries made by the backend
+    std::uint64_t bytesIn{0};
+    std::uint64_t bytesOut{0};
+    std::uint64_t accepted{0};
+};
+
+constexpr std::size_t kNetMaxConns = 1024;
+constexpr std::size_t kNetRecvBuf = 4096;  // Per-connection receive buffer
+constexpr std::size_t kNetSendBuf = 16384; // Per-connection send staging buffer
+constexpr std::size_t kNetMaxPending = 1u << 20; // Unsent bytes before a reader counts as stuck
+
+class NetBackend {
+public:
+    virtual ~NetBackend() = default;
+
+    virtual const char* name() const = 0;
+
+    // Bind and listen (port 0 picks a free port). Returns the bound port, or -1.
+    virtual int listen(const char* host, std::uint16_t port) = 0;
+
+    // Flush queued sends, wait up to `timeoutMs` for activity and append events to `out`
+    virtual void poll(std::vector<NetEvent>& out, int timeoutMs) = 0;
+
+    // Queue bytes for a connection; written on the next poll(). False if the handle is stale,
+    // or if the peer has stopped reading and more than kNetMaxPending bytes would be queued:
+    // that connection is dropped and reported Closed by the next poll().
+    virtual bool send(ConnId c, const void* data, std::size_t n) = 0;
+
+    // Drop a connection. No Closed event is reported for server-initiated closes. A
+    // connection that fails (reset, write error) is reported Closed exactly once.
+    virtual void close(ConnId c) = 0;
+
+    // Also wait on an eventfd (e.g. a queue's wake fd): poll() returns with a Wakeup event
+    // when it is signalled, after resetting its counter. One per backend.
+    virtual bool watch_wakeup(int eventFd) = 0;
+
+    const NetStats& stats() const { return stats_; }
+
+protected:
+    NetStats stats_;
+};
+
+// Create a backend. Auto and IoUring fall back to epoll when io_uring is unavailable.
+std::unique_ptr<NetBackend> make_net_backend(NetBackendKind kind);
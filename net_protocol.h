@@ -0,0 +1,105 @@
+// net_protocol.h
+// Wire format between game clients and the game server.
+//
+// A stream carries back-to-back frames: u16 length (little-endian, counts the type byte
+// and body) | u8 type | body. Several frames may arrive in one read and a frame may be
+// split across reads, so receivers reassemble with FrameReader.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+enum class MsgType : std::uint8_t {
+    // Client -> server
+    Ping = 1,     // body: u32 seq, u64 client timestamp (echoed back verbatim)
+    NewGame = 2,  // body: u8 contestant case (0..25)
+    OpenCase = 3, // body: u8 case
+    Deal = 4,
+    NoDeal = 5,
+
+    // Server -> client
+    Pong = 64,    // body: copy of the Ping body
+    State = 65,   // body: StateMsg
+    Error = 66,   // body: u8 error code
+};
+
+enum class ErrorCode : std::uint8_t {
+    BadFrame = 1,
+    NotAllowed = 2, // Command not valid in the current phase
+    BadCase = 3,
+};
+
+// Show phase of one hosted game
+enum class SessionPhase : std::uint8_t {
+    Idle = 0,     // No game running
+    Opening = 1,  // Contestant is opening cases for this round
+    Offer = 2,    // Banker offer on the table, waiting for DEAL / NO DEAL
+    Finished = 3,
+};
+
+#pragma pack(push, 1)
+struct StateMsg {
+    std::uint32_t openedMask;  // Revealed values (see game.h)
+    std::uint32_t openedCases; // Bit per case position that has been opened
+    std::uint32_t offerCents;  // Current/last banker offer
+    std::uint32_t winningsCents;
+    std::uint8_t round;
+    std::uint8_t phase;        // SessionPhase
+    std::uint8_t toOpen;       // Cases still to open this round
+    std::uint8_t reserved;
+};
+#pragma pack(pop)
+
+constexpr std::size_t kFrameHeader = 3;   // u16 length + u8 type
+constexpr std::size_t kMaxFrameBody = 1024;
+
+// Append one frame to an output buffer
+inline void append_frame(std::vector<std::uint8_t>& out, MsgType type, const void* body, std::size_t len) {
+    const auto total = static_cast<std::uint16_t>(len + 1);
+    const std::size_t at = out.size();
+    out.resize(at + kFrameHeader + len);
+    out[at] = static_cast<std::uint8_t>(total & 0xFF);
+    out[at + 1] = static_cast<std::uint8_t>(total >> 8);
+    out[at + 2] = static_cast<std::uint8_t>(type);
+    if (len) std::memcpy(out.data() + at + kFrameHeader, body, len);
+}
+
+// Reassembles frames from arbitrary stream chunks
+class FrameReader {
+public:
+    // Feed received bytes; calls fn(type, body, len) for each complete frame. Returns false
+    // on a malformed frame (the connection should be dropped).
+    template <class Fn>
+    bool feed(const std::uint8_t* data, std::size_t n, Fn&& fn) {
+        // Fast path: nothing buffered, parse straight from the receive buffer
+        if (pending_.empty()) {
+            std::size_t used = 0;
+            if (!parse(data, n, used, fn)) return false;
+            pending_.assign(data + used, data + n);
+            return true;
+        }
+        pending_.insert(pending_.end(), data, data + n);
+        std::size_t used = 0;
+        if (!parse(pending_.data(), pending_.size(), used, fn)) return false;
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(used));
+        return true;
+    }
+
+private:
+    template <class Fn>
+    static bool parse(const std::uint8_t* p, std::size_t n, std::size_t& used, Fn& fn) {
+        while (n - used >= kFrameHeader) {
+            const std::size_t len = static_cast<std::size_t>(p[used] | (p[used + 1] << 8));
+            if (len == 0 || len > kMaxFrameBody + 1) return false;
+            if (n - used < 2 + len) break;
+            fn(static_cast<MsgType>(p[used + 2]), p + used + kFrameHeader, len - 1);
+            used += 2 + len;
+        }
+        return true;
+    }
+
+    std::vector<std::uint8_t> pending_;
+};
@@ -0,0 +1,123 @@
+// render_pacer.cpp
+
+#include "render_pacer.h"
+
+#include <time.h>
+
+#include <algorithm>
+
+namespace {
+
+double clock_seconds(clockid_t id) {
+    timespec ts{};
+    ::clock_gettime(id, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+} // namespace
+
+const char* window_visibility_name(WindowVisibility v) {
+    switch (v) {
+    case WindowVisibility::Focused: return "focused";
+    case WindowVisibility::Unfocused: return "unfocused";
+    case WindowVisibility::Hidden: return "hidden";
+    }
+    return "?";
+}
+
+RenderPacer::RenderPacer(SDL_Window* window, int unfocusedFps, int hiddenWakeMs)
+    : window_(window),
+      unfocusedIntervalNs_(1000000000u / static_cast<std::uint64_t>(std::max(unfocusedFps, 1))),
+      hiddenWakeMs_(static_cast<std::uint32_t>(std::max(hiddenWakeMs, 1))) {
+    const Uint32 flags = SDL_GetWindowFlags(window_);
+    hidden_ = (flags & (SDL_WINDOW_HIDDEN | SDL_WINDOW_MINIMIZED)) != 0;
+    focused_ = (flags & SDL_WINDOW_INPUT_FOCUS) != 0;
+    accounted_ = visibility();
+    markWall_ = clock_seconds(CLOCK_MONOTONIC);
+    markProcess_ = clock_seconds(CLOCK_PROCESS_CPUTIME_ID);
+    markLoop_ = clock_seconds(CLOCK_THREAD_CPUTIME_ID);
+}
+
+WindowVisibility RenderPacer::visibility() const {
+    if (hidden_) return WindowVisibility::Hidden;
+    return focused_ ? WindowVisibility::Focused : WindowVisibility::Unfocused;
+}
+
+void RenderPacer::on_window_event(const SDL_WindowEvent& e) {
+    switch (e.event) {
+    case SDL_WINDOWEVENT_HIDDEN:
+    case SDL_WINDOWEVENT_MINIMIZED: hidden_ = true; break;
+    case SDL_WINDOWEVENT_SHOWN:
+    case SDL_WINDOWEVENT_EXPOSED:
+    case SDL_WINDOWEVENT_RESTORED:
+    case SDL_WINDOWEVENT_MAXIMIZED: hidden_ = (SDL_GetWindowFlags(window_) & SDL_WINDOW_MINIMIZED) != 0; break;
+    case SDL_WINDOWEVENT_FOCUS_GAINED: focused_ = true; break;
+    case SDL_WINDOWEVENT_FOCUS_LOST: focused_ = false; break;
+    default: return;
+    }
+    if (visibility() != accounted_) {
+        account();
+        accounted_ = visibility();
+        nextFrameNs_ = 0; // Draw straight away when coming back
+    }
+}
+
+bool RenderPacer::frame_due(std::uint64_t nowNs) {
+    ++stats_[static_cast<std::size_t>(accounted_)].iterations;
+    switch (visibility()) {
+    case WindowVisibility::Focused: return true;
+    case WindowVisibility::Unfocused: return nowNs >= nextFrameNs_;
+    case WindowVisibility::Hidden: return false;
+    }
+    return true;
+}
+
+void RenderPacer::presented(std::uint64_t nowNs) {
+    ++stats_[static_cast<std::size_t>(accounted_)].frames;
+    // Skip frames we were late for rather than presenting back to back
+    nextFrameNs_ = std::max(nextFrameNs_ + unfocusedIntervalNs_, nowNs + unfocusedIntervalNs_ / 2);
+}
+
+void RenderPacer::wait(std::uint64_t nowNs) {
+    std::uint64_t waitMs = 0;
+    switch (visibility()) {
+    case WindowVisibility::Focused: return;
+    case WindowVisibility::Unfocused:
+        waitMs = nextFrameNs_ > nowNs ? (nextFrameNs_ - nowNs) / 1000000u : 0;
+        waitMs = std::min<std::uint64_t>(waitMs, hiddenWakeMs_); // Still tick on time
+        break;
+    case WindowVisibility::Hidden: waitMs = hiddenWakeMs_; break;
+    }
+    // Waits without taking the event off the queue; the loop's SDL_PollEvent gets it
+    if (waitMs) SDL_WaitEventTimeout(nullptr, static_cast<int>(waitMs));
+}
+
+void RenderPacer::account() {
+    const double wall = clock_seconds(CLOCK_MONOTONIC);
+    const double process = clock_seconds(CLOCK_PROCESS_CPUTIME_ID);
+    const double loop = clock_seconds(CLOCK_THREAD_CPUTIME_ID);
+    PacerStateStats& s = stats_[static_cast<std::size_t>(accounted_)];
+    s.wallSeconds += wall - markWall_;
+    s.processCpuSeconds += process - markProcess_;
+    s.loopCpuSeconds += loop - markLoop_;
+    markWall_ = wall;
+    markProcess_ = process;
+    markLoop_ = loop;
+}
+
+const PacerStateStats& RenderPacer::stats(WindowVisibility v) {
+    account();
+    return stats_[static_cast<std::size_t>(v)];
+}
+
+void RenderPacer::report(std::FILE* out) {
+    account();
+    for (WindowVisibility v : { WindowVisibility::Focused, WindowVisibility::Unfocused, WindowVisibility::Hidden }) {
+        const PacerStateStats& s = stats_[static_cast<std::size_t>(v)];
+        if (s.wallSeconds <= 0) continue;
+        std::fprintf(out, "%-9s %8.1f s  %6.1f fps  %6.1f loops/s  main loop %5.1f%% CPU  process %5.1f%% CPU\n",
+                     window_visibility_name(v), s.wallSeconds, static_cast<double>(s.frames) / s.wallSeconds,
+                     static_cast<double>(s.iterations) / s.wallSeconds, 100.0 * s.loopCpuSeconds / s.wallSeconds,
+                     100.0 * s.processCpuSeconds / s.wallSeconds);
+    }
+}
@@ -0,0 +1,69 @@
+// render_pacer.h
+// Decides, per main loop iteration, whether the main window is worth drawing. Focused, the
+// loop runs flat out and vsync paces it. Unfocused, frames drop to a low rate. Hidden or
+// minimized, nothing is drawn or presented and the loop only wakes at the game's tick rate
+// so timers, replication and audio cues keep running. Any event ends a wait early, so
+// input latency does not depend on the state.
+//
+// SDL2 reports minimize, hide and focus changes but not occlusion by other windows; a
+// covered but focused window is still drawn at full rate.
+//
+// Wall and CPU time are accounted per state, so the savings can be checked on real
+// hardware.
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+enum class WindowVisibility : std::uint8_t { Focused, Unfocused, Hidden };
+
+struct PacerStateStats {
+    double wallSeconds{0};
+    double processCpuSeconds{0};  // All threads, audio and worker threads included
+    double loopCpuSeconds{0};     // The main loop's thread only
+    std::uint64_t frames{0};      // Frames drawn and presented
+    std::uint64_t iterations{0};  // Loop iterations, drawn or not
+};
+
+class RenderPacer {
+public:
+    // `unfocusedFps`: frame rate without input focus. `hiddenWakeMs`: loop period while
+    // nothing is drawn; the game's tick length keeps timers on time.
+    RenderPacer(SDL_Window* window, int unfocusedFps, int hiddenWakeMs);
+
+    // Feed every SDL_WINDOWEVENT of the paced window
+    void on_window_event(const SDL_WindowEvent& e);
+
+    WindowVisibility visibility() const;
+
+    // Whether to draw and present this iteration
+    bool frame_due(std::uint64_t nowNs);
+    // Call after presenting
+    void presented(std::uint64_t nowNs);
+    // Block until the next frame is due (unfocused), for one wake period (hidden) or until
+    // an event arrives. Returns at once when focused.
+    void wait(std::uint64_t nowNs);
+
+    // Close the current accounting period and return the totals for `v`
+    const PacerStateStats& stats(WindowVisibility v);
+    void report(std::FILE* out);
+
+private:
+    void account();
+
+    SDL_Window* window_;
+    std::uint64_t unfocusedIntervalNs_;
+    std::uint32_t hiddenWakeMs_;
+    bool hidden_{false};
+    bool focused_{true};
+    std::uint64_t nextFrameNs_{0};
+
+    WindowVisibility accounted_{WindowVisibility::Focused}; // State the open period belongs to
+    double markWall_{0}, markProcess_{0}, markLoop_{0};
+    std::array<PacerStateStats, 3> stats_{};
+};
+
+const char* window_visibility_name(WindowVisibility v);
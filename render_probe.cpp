@@ -0,0 +1,299 @@
+// render_probe.cpp
+// Render driver benchmark, cache and choice.
+
+#include "render_probe.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+constexpr int kWarmupFrames = 10;
+constexpr int kMaxFrames = 150;
+constexpr double kBudgetMs = 400.0; // Per driver, warmup excluded
+constexpr int kBoardCells = 26;
+constexpr int kListRows = 14;
+constexpr const char* kCacheName = "render_driver.txt";
+
+double ms_since(Uint64 start) {
+    return static_cast<double>(SDL_GetPerformanceCounter() - start) * 1000.0
+           / static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+// Drivers SDL offers on this machine, in its own preference order
+std::vector<std::string> driver_names() {
+    std::vector<std::string> names;
+    const int n = SDL_GetNumRenderDrivers();
+    for (int i = 0; i < n; i++) {
+        SDL_RendererInfo info{};
+        names.emplace_back(SDL_GetRenderDriverInfo(i, &info) == 0 && info.name ? info.name : "");
+    }
+    return names;
+}
+
+int driver_index(const std::vector<std::string>& drivers, const char* name) {
+    for (std::size_t i = 0; i < drivers.size(); i++)
+        if (drivers[i] == name) return static_cast<int>(i);
+    return -1;
+}
+
+// What a cached choice is valid for
+std::string cache_key(const RenderProbeOptions& opt, const std::vector<std::string>& drivers) {
+    char host[128] = "unknown";
+    ::gethostname(host, sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    char size[32];
+    std::snprintf(size, sizeof(size), " %dx%d ", opt.width, opt.height);
+    std::string key = std::string(host) + size;
+    for (std::size_t i = 0; i < drivers.size(); i++) {
+        if (i) key += ',';
+        key += drivers[i];
+    }
+    return key;
+}
+
+std::string cache_path() {
+    char* dir = SDL_GetPrefPath("dond", "dond");
+    if (!dir) return {};
+    std::string path = std::string(dir) + kCacheName;
+    SDL_free(dir);
+    return path;
+}
+
+// Cache file: the key line, then the chosen driver's name
+bool read_cache(const std::string& path, const std::string& key, std::string& driver) {
+    std::FILE* f = path.empty() ? nullptr : std::fopen(path.c_str(), "r");
+    if (!f) return false;
+    char line[512];
+    bool ok = false;
+    if (std::fgets(line, sizeof(line), f)) {
+        line[std::strcspn(line, "\n")] = '\0';
+        if (key == line && std::fgets(line, sizeof(line), f)) {
+            line[std::strcspn(line, "\n")] = '\0';
+            driver = line;
+            ok = !driver.empty();
+        }
+    }
+    std::fclose(f);
+    return ok;
+}
+
+void write_cache(const std::string& path, const std::string& key, const std::string& driver) {
+    std::FILE* f = path.empty() ? nullptr : std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::fprintf(stderr, "render probe: cannot write %s\n", path.c_str());
+        return;
+    }
+    std::fprintf(f, "%s\n%s\n", key.c_str(), driver.c_str());
+    std::fclose(f);
+}
+
+// Labels the scene draws: rasterized once, uploaded to every driver
+struct SceneText {
+    std::vector<SDL_Surface*> surfaces;
+    SceneText() = default;
+    SceneText(const SceneText&) = delete;
+    SceneText& operator=(const SceneText&) = delete;
+    ~SceneText() {
+        for (SDL_Surface* s : surfaces) SDL_FreeSurface(s);
+    }
+};
+
+void load_scene_text(SceneText& text, TTF_Font* font) {
+    if (!font) return;
+    char buf[48];
+    for (int i = 0; i < kBoardCells + kListRows; i++) {
+        if (i < kBoardCells) std::snprintf(buf, sizeof(buf), "%d", i + 1);
+        else std::snprintf(buf, sizeof(buf), "%d  Player %d  $%d", i - kBoardCells + 1, 1000 + i, 250000 - i * 3000);
+        if (SDL_Surface* s = TTF_RenderUTF8_Blended(font, buf, SDL_Color{ 255, 255, 255, 255 }))
+            text.surfaces.push_back(s);
+    }
+}
+
+// One frame of the stand-in scene. The top-left marker gets a per-frame color that the
+// readback checks.
+void draw_scene(SDL_Renderer* r, const std::vector<SDL_Texture*>& labels, SDL_Texture* counter,
+                std::vector<std::uint32_t>& counterPixels, int w, int h, int frame, SDL_Color marker) {
+    SDL_SetRenderDrawColor(r, 20, 24, 28, 255);
+    SDL_RenderClear(r);
+
+    const int cellW = w / 10, cellH = h / 8;
+    for (int i = 0; i < kBoardCells; i++) {
+        const SDL_Rect cell{ 20 + (i % 6) * cellW, 40 + (i / 6) * cellH, cellW - 6, cellH - 6 };
+        SDL_SetRenderDrawColor(r, 46, 50, static_cast<Uint8>(62 + (i + frame) % 32), 255);
+        SDL_RenderFillRect(r, &cell);
+        if (static_cast<std::size_t>(i) < labels.size() && labels[static_cast<std::size_t>(i)]) {
+            int tw = 0, th = 0;
+            SDL_QueryTexture(labels[static_cast<std::size_t>(i)], nullptr, nullptr, &tw, &th);
+            const SDL_Rect dst{ cell.x + 6, cell.y + 4, tw, th };
+            SDL_RenderCopy(r, labels[static_cast<std::size_t>(i)], nullptr, &dst);
+        }
+    }
+
+    // Leaderboard: striped rows, one text texture each, scrolling a pixel per frame
+    const SDL_Rect panel{ w - w / 3, 16, w / 3 - 16, h - 32 };
+    SDL_RenderSetClipRect(r, &panel);
+    for (int row = 0; row < kListRows + 1; row++) {
+        const SDL_Rect rr{ panel.x, panel.y + row * 30 - frame % 30, panel.w, 30 };
+        SDL_SetRenderDrawColor(r, 26, 28, static_cast<Uint8>(row % 2 ? 34 : 27), 255);
+        SDL_RenderFillRect(r, &rr);
+        const std::size_t t = static_cast<std::size_t>(kBoardCells + row % kListRows);
+        if (t < labels.size() && labels[t]) {
+            int tw = 0, th = 0;
+            SDL_QueryTexture(labels[t], nullptr, nullptr, &tw, &th);
+            const SDL_Rect dst{ rr.x + 8, rr.y + 4, tw, th };
+            SDL_SetTextureColorMod(labels[t], 240, 200, 80);
+            SDL_RenderCopy(r, labels[t], nullptr, &dst);
+        }
+    }
+    SDL_RenderSetClipRect(r, nullptr);
+
+    // Counter band re-uploaded every frame, like a ticking countdown
+    if (counter) {
+        const auto v = static_cast<std::uint32_t>(frame);
+        for (std::size_t i = 0; i < counterPixels.size(); i++)
+            counterPixels[i] = ((i / 16 + v) & 1u) ? 0xffffffffu : 0xff202020u;
+        SDL_UpdateTexture(counter, nullptr, counterPixels.data(), 256 * 4);
+        const SDL_Rect dst{ 20, h - 70, 256, 48 };
+        SDL_RenderCopy(r, counter, nullptr, &dst);
+    }
+
+    const SDL_Rect markRect{ 0, 0, 8, 8 };
+    SDL_SetRenderDrawColor(r, marker.r, marker.g, marker.b, 255);
+    SDL_RenderFillRect(r, &markRect);
+}
+
+RenderDriverScore probe_driver(int index, const std::string& name, const RenderProbeOptions& opt,
+                               const SceneText& text) {
+    RenderDriverScore score;
+    score.name = name;
+    score.index = index;
+    SDL_Window* window = SDL_CreateWindow("render probe", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                          opt.width, opt.height, SDL_WINDOW_HIDDEN);
+    if (!window) return score;
+    // No vsync: it would cap every driver at the refresh rate
+    SDL_Renderer* r = SDL_CreateRenderer(window, index, render_driver_flags(index));
+    if (!r) {
+        SDL_DestroyWindow(window);
+        return score;
+    }
+    score.created = true;
+
+    std::vector<SDL_Texture*> labels;
+    for (SDL_Surface* s : text.surfaces) {
+        SDL_Texture* t = SDL_CreateTextureFromSurface(r, s);
+        if (t) SDL_SetTextureBlendMode(t, SDL_BLENDMODE_BLEND);
+        labels.push_back(t);
+    }
+    SDL_Texture* counter = SDL_CreateTexture(r, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 256, 48);
+    std::vector<std::uint32_t> counterPixels(256 * 48);
+
+    int w = 0, h = 0;
+    SDL_GetRendererOutputSize(r, &w, &h);
+    std::vector<double> times;
+    times.reserve(kMaxFrames);
+    bool correct = true;
+    double spent = 0;
+    for (int frame = 0; frame < kWarmupFrames + kMaxFrames && spent < kBudgetMs; frame++) {
+        const SDL_Color marker{ static_cast<Uint8>(frame * 37), static_cast<Uint8>(255 - frame * 11), 160, 255 };
+        const Uint64 start = SDL_GetPerformanceCounter();
+        draw_scene(r, labels, counter, counterPixels, w, h, frame, marker);
+        std::uint32_t px = 0;
+        const SDL_Rect one{ 2, 2, 1, 1 };
+        const bool read = SDL_RenderReadPixels(r, &one, SDL_PIXELFORMAT_ARGB8888, &px, 4) == 0;
+        SDL_RenderPresent(r);
+        const double ms = ms_since(start);
+
+        // Allow for dithering or a 16-bit framebuffer
+        const auto near = [](std::uint32_t got, Uint8 want) {
+            return std::abs(static_cast<int>(got & 0xffu) - static_cast<int>(want)) <= 8;
+        };
+        if (!read || !near(px >> 16, marker.r) || !near(px >> 8, marker.g) || !near(px, marker.b)) correct = false;
+        if (frame < kWarmupFrames) continue;
+        times.push_back(ms);
+        spent += ms;
+    }
+    score.drewCorrectly = correct && !times.empty();
+    if (!times.empty()) {
+        std::sort(times.begin(), times.end());
+        score.medianMs = times[times.size() / 2];
+        score.p99Ms = times[std::min(times.size() - 1, times.size() * 99 / 100)];
+    }
+
+    if (counter) SDL_DestroyTexture(counter);
+    for (SDL_Texture* t : labels)
+        if (t) SDL_DestroyTexture(t);
+    SDL_DestroyRenderer(r);
+    SDL_DestroyWindow(window);
+    return score;
+}
+
+} // namespace
+
+Uint32 render_driver_flags(int index) {
+    SDL_RendererInfo info{};
+    if (index >= 0 && SDL_GetRenderDriverInfo(index, &info) == 0 && (info.flags & SDL_RENDERER_SOFTWARE))
+        return SDL_RENDERER_SOFTWARE;
+    return SDL_RENDERER_ACCELERATED;
+}
+
+RenderDriverChoice choose_render_driver(const RenderProbeOptions& options) {
+    RenderDriverChoice choice;
+    const std::vector<std::string> drivers = driver_names();
+
+    if (options.forceDriver) {
+        choice.index = driver_index(drivers, options.forceDriver);
+        if (choice.index >= 0) {
+            choice.name = options.forceDriver;
+            choice.flags = render_driver_flags(choice.index);
+            choice.source = "override";
+            return choice;
+        }
+        std::fprintf(stderr, "render probe: no render driver named %s\n", options.forceDriver);
+    }
+
+    const std::string key = cache_key(options, drivers);
+    const std::string path = cache_path();
+    std::string cached;
+    if (!options.reprobe && read_cache(path, key, cached) && driver_index(drivers, cached.c_str()) >= 0) {
+        choice.index = driver_index(drivers, cached.c_str());
+        choice.name = cached;
+        choice.flags = render_driver_flags(choice.index);
+        choice.source = "cache";
+        return choice;
+    }
+
+    SceneText text;
+    load_scene_text(text, options.font);
+    const RenderDriverScore* best = nullptr;
+    for (std::size_t i = 0; i < drivers.size(); i++) {
+        if (drivers[i].empty()) continue;
+        choice.scores.push_back(probe_driver(static_cast<int>(i), drivers[i], options, text));
+    }
+    for (const RenderDriverScore& s : choice.scores)
+        if (s.stable() && (!best || s.medianMs < best->medianMs)) best = &s;
+    if (!best) {
+        choice.source = "default"; // Nothing passed: leave it to SDL
+        return choice;
+    }
+    choice.name = best->name;
+    choice.index = best->index;
+    choice.flags = render_driver_flags(best->index);
+    choice.source = "probe";
+    write_cache(path, key, choice.name);
+    return choice;
+}
+
+void print_render_driver_choice(std::FILE* out, const RenderDriverChoice& choice) {
+    std::fprintf(out, "Render driver: %s (%s)\n", choice.name.empty() ? "SDL default" : choice.name.c_str(), choice.source);
+    for (const RenderDriverScore& s : choice.scores) {
+        if (!s.created) std::fprintf(out, "  %-12s unavailable\n", s.name.c_str());
+        else
+            std::fprintf(out, "  %-12s median %6.2f ms  p99 %6.2f ms  %s\n", s.name.c_str(), s.medianMs, s.p99Ms,
+                         !s.drewCorrectly ? "wrong output" : s.stable() ? "stable" : "unstable");
+    }
+}
@@ -0,0 +1,57 @@
+// render_probe.h
+// Picks the SDL render driver at startup. SDL's own preference order (-1) is a poor fit
+// for the kiosk fleet: on some machines opengl is fastest, on others opengles2 or even
+// the software renderer, and a few drivers render nothing at all.
+//
+// The probe creates each available driver on a hidden scratch window and draws a scene
+// like the game's: case board, text, leaderboard rows and a streamed counter. Each frame
+// ends with a one-pixel readback. That forces the GPU to finish the frame, so the timing
+// covers the whole pipeline, and it checks that the driver actually drew. A driver is
+// stable when every frame reads back correctly and its slowest frames stay within a
+// small multiple of the median. The fastest stable driver wins.
+//
+// The choice is cached in the user's pref dir, keyed by host name, window size and the
+// list of drivers. A driver update that changes that list triggers a new probe.
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct RenderDriverScore {
+    std::string name;
+    int index{-1};
+    bool created{false};
+    bool drewCorrectly{false};
+    double medianMs{0};
+    double p99Ms{0};
+    bool stable() const { return created && drewCorrectly && p99Ms <= 4.0 * medianMs + 1.0; }
+};
+
+struct RenderDriverChoice {
+    std::string name;       // Empty: let SDL choose
+    int index{-1};          // For SDL_CreateRenderer
+    Uint32 flags{SDL_RENDERER_ACCELERATED};
+    const char* source{""}; // "override", "cache", "probe" or "default"
+    std::vector<RenderDriverScore> scores; // Filled when the probe ran
+};
+
+struct RenderProbeOptions {
+    const char* forceDriver{nullptr}; // Skip the probe and use this driver
+    bool reprobe{false};              // Ignore the cache
+    int width{900};                   // Scene size (the main window's)
+    int height{600};
+    TTF_Font* font{nullptr};          // For the text part of the scene
+};
+
+// Decide which driver the game renders with (see above)
+RenderDriverChoice choose_render_driver(const RenderProbeOptions& options);
+
+// Renderer flags for driver `index`: software drivers reject SDL_RENDERER_ACCELERATED
+Uint32 render_driver_flags(int index);
+
+// One line for the decision, then one per probed driver
+void print_render_driver_choice(std::FILE* out, const RenderDriverChoice& choice);
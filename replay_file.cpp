@@ -0,0 +1,270 @@
+// replay_file.cpp
+
+#include "replay_file.h"
+
+#include "log_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kIndexMagic = 0x49444E44u; // "DNDI"
+constexpr std::size_t kHeaderBytes = 32;
+constexpr std::size_t kTrailerBytes = 24;
+
+enum RecordType : std::uint32_t { kStart = 0, kInput = 1, kEnd = 2 };
+constexpr std::size_t kStartBody = kNumCases + 2 + 4;
+constexpr std::size_t kInputBody = 1 + 4;
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------------------
+
+bool ReplayWriter::open(const char* path, const ShowTiming& timing, std::uint32_t tickMs) {
+    close(lastTick_);
+    failed_ = false;
+    file_ = std::fopen(path, "wb");
+    if (!file_) {
+        std::fprintf(stderr, "replay: cannot create %s\n", path);
+        return false;
+    }
+    put_u32(out_, kReplayMagic);
+    put_u32(out_, kVersion);
+    put_u32(out_, tickMs);
+    put_u32(out_, timing.introTicks);
+    put_u32(out_, timing.revealTicks);
+    put_u32(out_, timing.bankerCallTicks);
+    put_u32(out_, timing.decisionTicks);
+    put_u32(out_, timing.finaleTicks);
+    return true;
+}
+
+void ReplayWriter::head(std::uint64_t value, std::uint32_t type) {
+    put_varint(out_, value << 2 | type);
+}
+
+void ReplayWriter::show_started(std::uint64_t tick, const ShowState& st) {
+    if (!file_ || failed_) return;
+    index_.push_back(tick);
+    index_.push_back(written_ + out_.size());
+    head(tick, kStart);
+    out_.insert(out_.end(), st.cases.begin(), st.cases.end());
+    out_.push_back(st.contestantCase);
+    out_.push_back(st.lastOpened);
+    put_u32(out_, show_state_hash(st));
+    lastTick_ = tick;
+}
+
+void ReplayWriter::input(std::uint64_t tick, const ShowInput& in, const ShowState& after) {
+    if (!file_ || failed_ || index_.empty()) return; // No show yet
+    head(tick > lastTick_ ? tick - lastTick_ : 0, kInput);
+    out_.push_back(static_cast<std::uint8_t>(in.kind << 5 | (in.caseIndex & 0x1f)));
+    put_u32(out_, show_state_hash(after));
+    lastTick_ = std::max(lastTick_, tick);
+}
+
+void ReplayWriter::flush() {
+    if (!file_ || failed_ || out_.empty()) return;
+    const bool ok = std::fwrite(out_.data(), 1, out_.size(), file_) == out_.size();
+    if (!ok || std::fflush(file_) != 0) {
+        // The index would point at bytes that never landed; stop here and let the
+        // player re-index what did
+        std::fprintf(stderr, "replay: writing the recording failed, stopped recording\n");
+        failed_ = true;
+    } else {
+        written_ += out_.size();
+    }
+    out_.clear();
+}
+
+bool ReplayWriter::close(std::uint64_t endTick) {
+    if (!file_) return !failed_;
+    bool ok = !failed_; // Already reported; the player re-indexes what landed
+    if (ok) {
+        head(endTick > lastTick_ ? endTick - lastTick_ : 0, kEnd);
+        const std::uint64_t indexOffset = written_ + out_.size();
+        for (std::uint64_t v : index_) put_u64(out_, v);
+        put_u64(out_, indexOffset);
+        put_u64(out_, std::max(endTick, lastTick_));
+        put_u32(out_, kIndexMagic);
+        put_u32(out_, 0);
+        ok = std::fwrite(out_.data(), 1, out_.size(), file_) == out_.size();
+    }
+    if (std::fclose(file_) != 0) ok = false;
+    if (!ok && !failed_) std::fprintf(stderr, "replay: writing the recording failed\n");
+    failed_ = !ok;
+    file_ = nullptr;
+    out_.clear();
+    written_ = 0;
+    lastTick_ = 0;
+    index_.clear();
+    return ok;
+}
+
+// ---------------------------------------------------------------------------------------
+// Player
+// ---------------------------------------------------------------------------------------
+
+ReplayPlayer::~ReplayPlayer() {
+    if (slot_.fiber) slot_.fiber->stop(); // Its timers live on our scheduler
+}
+
+bool ReplayPlayer::open(const char* path) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::fprintf(stderr, "replay: cannot open %s\n", path);
+        return false;
+    }
+    std::fseek(f, 0, SEEK_END);
+    const long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    data_.resize(size > 0 ? static_cast<std::size_t>(size) : 0);
+    const bool readOk = std::fread(data_.data(), 1, data_.size(), f) == data_.size();
+    std::fclose(f);
+    if (!readOk || data_.size() < kHeaderBytes || get_u32(data_.data()) != kReplayMagic
+        || get_u32(data_.data() + 4) != kVersion) {
+        std::fprintf(stderr, "replay: %s is not a replay file\n", path);
+        data_.clear();
+        return false;
+    }
+    const std::uint8_t* h = data_.data();
+    tickMs_ = get_u32(h + 8);
+    timing_.introTicks = get_u32(h + 12);
+    timing_.revealTicks = get_u32(h + 16);
+    timing_.bankerCallTicks = get_u32(h + 20);
+    timing_.decisionTicks = get_u32(h + 24);
+    timing_.finaleTicks = get_u32(h + 28);
+
+    if (!read_index()) {
+        std::fprintf(stderr, "replay: %s has no index (recording cut short?); rebuilding it\n", path);
+        scan_index();
+    }
+    mismatches_ = 0;
+    seek(start_tick());
+    return true;
+}
+
+bool ReplayPlayer::read_index() {
+    const std::size_t size = data_.size();
+    if (size < kHeaderBytes + kTrailerBytes) return false;
+    const std::uint8_t* trailer = data_.data() + size - kTrailerBytes;
+    if (get_u32(trailer + 16) != kIndexMagic) return false;
+    const std::uint64_t indexOffset = get_u64(trailer);
+    const std::uint64_t indexEnd = size - kTrailerBytes;
+    if (indexOffset < kHeaderBytes || indexOffset > indexEnd || (indexEnd - indexOffset) % 16 != 0) return false;
+
+    keyframes_.clear();
+    for (std::uint64_t at = indexOffset; at < indexEnd; at += 16) {
+        const Keyframe k{ get_u64(data_.data() + at), get_u64(data_.data() + at + 8) };
+        if (k.offset < kHeaderBytes || k.offset >= indexOffset) return false;
+        if (!keyframes_.empty() && k.tick < keyframes_.back().tick) return false;
+        keyframes_.push_back(k);
+    }
+    recordsEnd_ = data_.data() + indexOffset;
+    endTick_ = get_u64(trailer + 8);
+    return true;
+}
+
+void ReplayPlayer::scan_index() {
+    keyframes_.clear();
+    recordsEnd_ = data_.data() + data_.size();
+    const std::uint8_t* p = data_.data() + kHeaderBytes;
+    std::uint64_t tick = 0;
+    Record rec;
+    while (parse(p, tick, rec)) {
+        if (rec.type == kStart) keyframes_.push_back(Keyframe{ rec.tick, static_cast<std::uint64_t>(p - data_.data()) });
+        tick = rec.tick;
+        p = rec.next;
+    }
+    // A record torn by the crash ends the usable part
+    recordsEnd_ = p;
+    endTick_ = tick;
+}
+
+bool ReplayPlayer::parse(const std::uint8_t* p, std::uint64_t baseTick, Record& rec) const {
+    if (p >= recordsEnd_) return false;
+    std::uint64_t head = 0;
+    if (!get_varint(p, recordsEnd_, head)) return false;
+    rec.type = static_cast<std::uint32_t>(head & 3);
+    rec.tick = rec.type == kStart ? head >> 2 : baseTick + (head >> 2);
+    rec.body = p;
+    const std::size_t bytes = rec.type == kStart ? kStartBody : rec.type == kInput ? kInputBody : 0;
+    if (rec.type > kEnd || static_cast<std::size_t>(recordsEnd_ - p) < bytes) return false;
+    rec.next = p + bytes;
+    return true;
+}
+
+void ReplayPlayer::restart(const Keyframe& k) {
+    slot_.fiber->stop();
+    *slot_.state = ShowState{};
+    sched_.timers() = TimerWheel(k.tick);
+    pos_ = data_.data() + k.offset;
+    baseTick_ = k.tick;
+}
+
+void ReplayPlayer::catch_up(std::uint64_t tick) {
+    // Records carry the recorder's now(): one past the last tick it processed
+    if (tick <= sched_.timers().now()) return;
+    sched_.advance(tick - 1, otherTimers_);
+    otherTimers_.clear();
+}
+
+void ReplayPlayer::apply(const Record& rec) {
+    ShowState& st = *slot_.state;
+    std::uint32_t hash = 0;
+    switch (rec.type) {
+    case kStart:
+        std::memcpy(st.cases.data(), rec.body, kNumCases);
+        st.contestantCase = rec.body[kNumCases];
+        st.lastOpened = rec.body[kNumCases + 1];
+        slot_.fiber->start(sched_, run_show(*slot_.fiber, *slot_.stage, st, timing_));
+        hash = get_u32(rec.body + kNumCases + 2);
+        break;
+    case kInput: {
+        const auto kind = static_cast<std::uint8_t>(rec.body[0] >> 5);
+        if (kind <= ShowInput::NoDeal)
+            slot_.fiber->post(ShowInput{ static_cast<ShowInput::Kind>(kind), static_cast<std::uint8_t>(rec.body[0] & 0x1f) });
+        hash = get_u32(rec.body + 1);
+        break;
+    }
+    default:
+        break;
+    }
+    if (rec.type != kEnd && show_state_hash(st) != hash) ++mismatches_;
+    pos_ = rec.next;
+    baseTick_ = rec.tick;
+}
+
+void ReplayPlayer::play_to(std::uint64_t tick) {
+    if (!slot_.fiber || data_.empty()) return;
+    if (tick < now()) {
+        seek(tick);
+        return;
+    }
+    Record rec;
+    while (parse(pos_, baseTick_, rec) && rec.tick <= tick) {
+        catch_up(rec.tick);
+        apply(rec);
+    }
+    catch_up(tick);
+}
+
+void ReplayPlayer::seek(std::uint64_t tick) {
+    if (!slot_.fiber || data_.empty()) return;
+    tick = std::min(tick, endTick_);
+    const auto next = std::upper_bound(keyframes_.begin(), keyframes_.end(), tick,
+                                       [](std::uint64_t t, const Keyframe& k) { return t < k.tick; });
+    if (next == keyframes_.begin()) {
+        // Before the first show: nothing on stage
+        restart(Keyframe{ tick, kHeaderBytes });
+    } else {
+        const Keyframe& k = *(next - 1);
+        // Playing on is cheaper unless a show started in between
+        if (tick < now() || k.tick >= now()) restart(k);
+    }
+    play_to(tick);
+}
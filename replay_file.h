@@ -0,0 +1,136 @@
+// replay_file.h
+// Recorded shows that can be played back and scrubbed. The show flow is deterministic in
+// (board, inputs, ticks) (see replication.h), so a replay file holds only the show log:
+// each show start with its board and every accepted input, stamped with the scheduler
+// tick. Playback feeds them to a fiber on a scheduler of its own.
+//
+// The suspended flow itself cannot be saved, so the keyframes are the show starts: there
+// the whole state is the board plus the two fields a new show does not reset, and a
+// keyframe record carries all of it. A footer indexes keyframes by tick. Seeking loads
+// the last keyframe before the target and fast-forwards the engine headlessly, which
+// costs at most one show's inputs and the timers between them, however long the file.
+//
+// File layout (little-endian, varints as in log_codec.h):
+//   header   "DNDR", version, tick length (ms), ShowTiming: 32 bytes
+//   records  head = value << 2 | type, then the body:
+//              Start  value = tick; board (26 bytes), contestantCase, lastOpened, hash
+//              Input  value = ticks since the previous record; kind << 5 | case, hash
+//              End    value = ticks since the previous record; nothing
+//   index    tick and record offset of each keyframe (u64 each)
+//   trailer  index offset, end tick (u64 each), "DNDI", reserved: 24 bytes
+// hash is show_state_hash() after the record, as the recording saw it. A file cut short
+// (the recorder crashed) has no index; it is rebuilt by scanning the records.
+
+#pragma once
+
+#include "replication.h"
+#include "show_flow.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+constexpr std::uint32_t kReplayMagic = 0x52444E44u; // "DNDR"
+
+// Writes a replay while the show runs. Calls mirror ReplicationPrimary: log each event
+// right after applying it locally.
+class ReplayWriter {
+public:
+    ReplayWriter() = default;
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+    ~ReplayWriter() { close(lastTick_); }
+
+    // Create `path`. Until this succeeds every other call is a no-op.
+    bool open(const char* path, const ShowTiming& timing, std::uint32_t tickMs);
+
+    void show_started(std::uint64_t tick, const ShowState& st);
+    void input(std::uint64_t tick, const ShowInput& in, const ShowState& after);
+
+    // Hand buffered records to the OS; once per loop turn. A failed write is reported
+    // once and stops the recording; the file is left without an index.
+    void flush();
+
+    // Finish the file: End record at `endTick`, index and trailer. False if any write
+    // failed, now or in an earlier flush().
+    bool close(std::uint64_t endTick);
+
+    bool is_open() const { return file_ != nullptr; }
+    bool failed() const { return failed_; }
+
+private:
+    void head(std::uint64_t value, std::uint32_t type);
+
+    std::FILE* file_{nullptr};
+    std::vector<std::uint8_t> out_;      // Records not yet written
+    std::uint64_t written_{0};           // Bytes already in the file
+    std::uint64_t lastTick_{0};
+    std::vector<std::uint64_t> index_;   // Keyframe tick, offset pairs
+    bool failed_{false};                 // A write failed; later calls are no-ops
+};
+
+// Plays a replay file into one show. Owns the scheduler the fiber runs on; its now() is
+// the playback position.
+class ReplayPlayer {
+public:
+    // Plays into `slot`, which must outlive the player
+    explicit ReplayPlayer(const ReplicaSlot& slot) : slot_(slot) {}
+    ReplayPlayer(const ReplayPlayer&) = delete;
+    ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+    ~ReplayPlayer();
+
+    // Load `path` and seek to its first keyframe
+    bool open(const char* path);
+
+    // Advance playback to `tick`, applying every record up to it; a tick behind the
+    // current position seeks instead
+    void play_to(std::uint64_t tick);
+
+    // Jump to `tick` (clamped to the recording): from the nearest keyframe at or before
+    // it, or straight on when no keyframe lies in between
+    void seek(std::uint64_t tick);
+
+    std::uint64_t now() const { return sched_.timers().now(); }
+    std::uint64_t start_tick() const { return keyframes_.empty() ? endTick_ : keyframes_.front().tick; }
+    std::uint64_t end_tick() const { return endTick_; }
+    std::uint32_t tick_ms() const { return tickMs_; }
+    const ShowTiming& timing() const { return timing_; }
+    std::size_t keyframes() const { return keyframes_.size(); }
+    bool at_end() const { return now() >= endTick_; }
+
+    // Records whose state hash differed from the recording's: this build plays the show
+    // differently from the one that recorded it
+    std::uint64_t mismatches() const { return mismatches_; }
+
+private:
+    struct Keyframe {
+        std::uint64_t tick;
+        std::uint64_t offset; // From the start of the file
+    };
+    struct Record {
+        std::uint32_t type;
+        std::uint64_t tick;
+        const std::uint8_t* body;
+        const std::uint8_t* next;
+    };
+
+    bool parse(const std::uint8_t* p, std::uint64_t baseTick, Record& rec) const;
+    bool read_index();
+    void scan_index();
+    void restart(const Keyframe& k);
+    void catch_up(std::uint64_t tick);
+    void apply(const Record& rec);
+
+    ReplicaSlot slot_;
+    ShowScheduler sched_;
+    ShowTiming timing_;
+    std::uint32_t tickMs_{0};
+    std::vector<std::uint8_t> data_;
+    const std::uint8_t* recordsEnd_{nullptr};
+    std::vector<Keyframe> keyframes_;
+    std::uint64_t endTick_{0};
+    const std::uint8_t* pos_{nullptr};  // Next record to apply
+    std::uint64_t baseTick_{0};         // Tick of the record before it
+    std::vector<TimerEvent> otherTimers_;
+    std::uint64_t mismatches_{0};
+};
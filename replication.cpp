@@ -0,0 +1,428 @@
+// replication.cpp
+
+#include "replication.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr std::size_t kRecordBytes = sizeof(ReplRecord);
+
+// Hello carries the primary's ShowTiming and tick length in the board bytes
+struct HelloBody {
+    std::uint32_t introTicks, revealTicks, bankerCallTicks, decisionTicks, finaleTicks;
+    std::uint32_t tickMs;
+};
+static_assert(sizeof(HelloBody) <= sizeof(ReplRecord::board), "Hello body must fit the board bytes");
+
+struct Fnv {
+    std::uint32_t h{2166136261u};
+    void add(std::uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            h ^= static_cast<std::uint32_t>((v >> (8 * i)) & 0xff);
+            h *= 16777619u;
+        }
+    }
+};
+
+bool fill_unix_addr(sockaddr_un& addr, const char* path) {
+    addr.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(addr.sun_path)) {
+        std::fprintf(stderr, "repl: socket path too long: %s\n", path);
+        return false;
+    }
+    std::strcpy(addr.sun_path, path);
+    return true;
+}
+
+bool same_timing(const ShowTiming& a, const HelloBody& b) {
+    return a.introTicks == b.introTicks && a.revealTicks == b.revealTicks && a.bankerCallTicks == b.bankerCallTicks
+        && a.decisionTicks == b.decisionTicks && a.finaleTicks == b.finaleTicks;
+}
+
+} // namespace
+
+std::uint32_t show_state_hash(const ShowState& st) {
+    Fnv f;
+    f.add(static_cast<std::uint64_t>(st.step), 1);
+    f.add(static_cast<std::uint64_t>(st.phase), 1);
+    for (std::uint8_t c : st.cases) f.add(c, 1);
+    f.add(st.contestantCase, 1);
+    f.add(st.lastOpened, 1);
+    f.add(st.round, 1);
+    f.add(st.toOpen, 1);
+    f.add(st.openedMask, 4);
+    f.add(st.openedCases, 4);
+    f.add(st.offerCents, 4);
+    f.add(st.winningsCents, 4);
+    f.add(st.tookDeal, 1);
+    f.add(st.stepStartTick, 8);
+    f.add(st.stepTicks, 8);
+    return f.h;
+}
+
+std::uint64_t repl_now_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ---------------------------------------------------------------------------------------
+// Primary
+// ---------------------------------------------------------------------------------------
+
+ReplicationPrimary::~ReplicationPrimary() {
+    if (conn_ >= 0) {
+        // Best effort: a clean shutdown must not look like a crash to the standby
+        queue(make(ReplRecord::Goodbye, 0, 0));
+        ::send(conn_, out_.data() + outSent_, out_.size() - outSent_, MSG_NOSIGNAL | MSG_DONTWAIT);
+        ::close(conn_);
+    }
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        ::unlink(path_.data());
+    }
+}
+
+bool ReplicationPrimary::listen(const char* path, const ShowTiming& timing, std::uint32_t tickMs) {
+    sockaddr_un addr{};
+    if (!fill_unix_addr(addr, path)) return false;
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    ::unlink(path);
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 1) != 0) {
+        std::fprintf(stderr, "repl: cannot listen on %s: %s\n", path, std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    listenFd_ = fd;
+    path_.assign(path, path + std::strlen(path) + 1);
+    timing_ = timing;
+    tickMs_ = tickMs;
+    return true;
+}
+
+ReplRecord ReplicationPrimary::make(ReplRecord::Type type, std::uint32_t show, std::uint64_t tick) {
+    ReplRecord rec;
+    rec.seq = seq_++;
+    rec.tick = tick;
+    rec.sentNs = repl_now_ns();
+    rec.show = show;
+    rec.type = type;
+    return rec;
+}
+
+void ReplicationPrimary::show_started(std::uint32_t show, std::uint64_t tick, const ShowState& st) {
+    if (listenFd_ < 0) return;
+    ReplRecord rec = make(ReplRecord::Start, show, tick);
+    std::memcpy(rec.board, st.cases.data(), kNumCases);
+    rec.stateHash = show_state_hash(st);
+    if (history_.size() <= show) history_.resize(show + 1u);
+    history_[show].clear(); // The previous show on this id no longer matters
+    history_[show].push_back(rec);
+    queue(rec);
+}
+
+void ReplicationPrimary::input(std::uint32_t show, std::uint64_t tick, const ShowInput& in, const ShowState& after) {
+    if (listenFd_ < 0 || show >= history_.size() || history_[show].empty()) return;
+    ReplRecord rec = make(ReplRecord::Input, show, tick);
+    rec.inputKind = static_cast<std::uint8_t>(in.kind);
+    rec.caseIndex = in.caseIndex;
+    rec.stateHash = show_state_hash(after);
+    history_[show].push_back(rec);
+    ++stats_.inputs;
+    queue(rec);
+}
+
+void ReplicationPrimary::show_ended(std::uint32_t show) {
+    if (show >= history_.size()) return;
+    history_[show] = {};
+    while (!history_.empty() && history_.back().empty()) history_.pop_back();
+}
+
+void ReplicationPrimary::queue(const ReplRecord& rec) {
+    if (conn_ < 0) return;
+    if (out_.size() - outSent_ + kRecordBytes > kMaxQueuedBytes) {
+        drop_standby("standby fell too far behind");
+        return;
+    }
+    const auto* p = reinterpret_cast<const std::uint8_t*>(&rec);
+    out_.insert(out_.end(), p, p + kRecordBytes);
+    ++stats_.records;
+}
+
+void ReplicationPrimary::flush(std::uint64_t tick) {
+    if (listenFd_ < 0) return;
+    accept_standby(tick);
+    if (conn_ < 0) return;
+
+    queue(make(ReplRecord::Heartbeat, 0, tick));
+    if (conn_ < 0) return; // Cut off while queueing
+    while (outSent_ < out_.size()) {
+        const ssize_t n = ::send(conn_, out_.data() + outSent_, out_.size() - outSent_, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            outSent_ += static_cast<std::size_t>(n);
+            stats_.bytes += static_cast<std::uint64_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Socket full: keep only the unsent tail, so a standby that always trails a
+            // little does not pin everything ever sent
+            if (outSent_ >= out_.size() / 2) {
+                out_.erase(out_.begin(), out_.begin() + static_cast<std::ptrdiff_t>(outSent_));
+                outSent_ = 0;
+            }
+            return;
+        } else {
+            drop_standby("standby went away");
+            return;
+        }
+    }
+    out_.clear();
+    outSent_ = 0;
+}
+
+void ReplicationPrimary::accept_standby(std::uint64_t tick) {
+    for (;;) {
+        const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (conn_ >= 0) {
+            ::close(fd); // One standby at a time
+            continue;
+        }
+        conn_ = fd;
+        out_.clear();
+        outSent_ = 0;
+
+        ReplRecord hello = make(ReplRecord::Hello, 0, tick);
+        const HelloBody body{ timing_.introTicks, timing_.revealTicks, timing_.bankerCallTicks,
+                              timing_.decisionTicks, timing_.finaleTicks, tickMs_ };
+        std::memcpy(hello.board, &body, sizeof(body));
+        queue(hello);
+
+        // Replay the running shows in the order they happened, so the standby's scheduler
+        // only ever moves forward
+        std::vector<ReplRecord> past;
+        for (const auto& h : history_) past.insert(past.end(), h.begin(), h.end());
+        std::sort(past.begin(), past.end(), [](const ReplRecord& a, const ReplRecord& b) { return a.seq < b.seq; });
+        for (const ReplRecord& rec : past) queue(rec);
+        queue(make(ReplRecord::Synced, 0, tick));
+        ++stats_.resyncs;
+    }
+}
+
+void ReplicationPrimary::drop_standby(const char* why) {
+    std::fprintf(stderr, "repl: dropping standby: %s\n", why);
+    ::close(conn_);
+    conn_ = -1;
+    out_.clear();
+    outSent_ = 0;
+    ++stats_.dropped;
+}
+
+// ---------------------------------------------------------------------------------------
+// Standby
+// ---------------------------------------------------------------------------------------
+
+ReplicationStandby::ReplicationStandby(ShowScheduler& sched, const ShowTiming& timing,
+                                       std::function<ReplicaSlot(std::uint32_t)> slot)
+    : sched_(sched), timing_(timing), slot_(std::move(slot)) {}
+
+ReplicationStandby::~ReplicationStandby() {
+    disconnect();
+}
+
+void ReplicationStandby::disconnect() {
+    if (fd_ >= 0) ::close(fd_);
+    if (pidFd_ >= 0) ::close(pidFd_);
+    fd_ = pidFd_ = -1;
+    in_.clear();
+}
+
+bool ReplicationStandby::try_connect(const char* path) {
+    sockaddr_un addr{};
+    if (!fill_unix_addr(addr, path)) return false;
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd); // No primary yet
+        return false;
+    }
+    // Remember who the primary is: a closed socket only means failover if it died
+    ucred cred{};
+    socklen_t len = sizeof(cred);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0) {
+        peerPid_ = cred.pid;
+        pidFd_ = static_cast<int>(::syscall(SYS_pidfd_open, cred.pid, 0));
+    }
+    fd_ = fd;
+    lastRecvNs_ = repl_now_ns();
+    return true;
+}
+
+ReplicationStandby::Status ReplicationStandby::poll(const char* path, int timeoutMs) {
+    if (status_ == Status::Detached || status_ == Status::FailedOver) return status_;
+    if (fd_ < 0 && !try_connect(path)) {
+        if (timeoutMs > 0) ::poll(nullptr, 0, timeoutMs);
+        return status_;
+    }
+
+    pollfd pfd{ fd_, POLLIN, 0 };
+    ::poll(&pfd, 1, timeoutMs);
+    bool closed = false;
+    for (;;) {
+        std::uint8_t buf[16 * 1024];
+        const ssize_t n = ::recv(fd_, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0) {
+            in_.insert(in_.end(), buf, buf + n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        closed = !(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)); // EOF or reset
+        break;
+    }
+
+    // Apply every complete record, including those that arrived just before a close
+    const std::uint64_t nowNs = repl_now_ns();
+    std::size_t used = 0;
+    for (; used + kRecordBytes <= in_.size() && fd_ >= 0; used += kRecordBytes) {
+        ReplRecord rec;
+        std::memcpy(&rec, in_.data() + used, kRecordBytes);
+        apply(rec, nowNs);
+    }
+    if (fd_ < 0) return status_; // Goodbye, or a primary we cannot follow
+    in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(used));
+    if (used) lastRecvNs_ = nowNs;
+
+    if (closed) primary_closed(repl_now_ns());
+    else if (!used && status_ != Status::Connecting && nowNs - lastRecvNs_ > failoverMs_ * 1000000ull)
+        fail_over(nowNs, true); // Heartbeats stopped but the socket is open: primary hung
+    return status_;
+}
+
+void ReplicationStandby::apply(const ReplRecord& rec, std::uint64_t nowNs) {
+    if (rec.type != ReplRecord::Hello && status_ == Status::Connecting) return;
+    switch (rec.type) {
+    case ReplRecord::Hello: {
+        HelloBody body;
+        std::memcpy(&body, rec.board, sizeof(body));
+        if (!same_timing(timing_, body)) {
+            std::fprintf(stderr, "repl: primary runs the show with different timing; not following\n");
+            disconnect();
+            status_ = Status::Detached;
+            return;
+        }
+        tickNs_ = static_cast<std::uint64_t>(body.tickMs) * 1000000ull;
+        status_ = Status::Syncing;
+        break;
+    }
+    case ReplRecord::Start: {
+        catch_up(rec.tick);
+        const ReplicaSlot slot = slot_(rec.show);
+        if (!slot.fiber) break;
+        std::memcpy(slot.state->cases.data(), rec.board, kNumCases);
+        slot.fiber->start(sched_, run_show(*slot.fiber, *slot.stage, *slot.state, timing_));
+        check(rec, slot);
+        break;
+    }
+    case ReplRecord::Input: {
+        catch_up(rec.tick);
+        const ReplicaSlot slot = slot_(rec.show);
+        if (!slot.fiber || rec.inputKind > ShowInput::NoDeal) break;
+        slot.fiber->post(ShowInput{ static_cast<ShowInput::Kind>(rec.inputKind), rec.caseIndex });
+        check(rec, slot);
+        ++stats_.inputs;
+        break;
+    }
+    case ReplRecord::Heartbeat:
+        catch_up(rec.tick);
+        break;
+    case ReplRecord::Synced:
+        status_ = Status::Following;
+        break;
+    case ReplRecord::Goodbye:
+        std::fprintf(stderr, "repl: primary shut down; standby detached\n");
+        disconnect();
+        status_ = Status::Detached;
+        return;
+    }
+
+    ++stats_.records;
+    stats_.bytes += kRecordBytes;
+    lastTick_ = rec.tick;
+    lastSentNs_ = rec.sentNs;
+    if (status_ != Status::Following) return; // History is old by design; not lag
+    const std::uint64_t lag = nowNs > rec.sentNs ? nowNs - rec.sentNs : 0;
+    stats_.lagSumNs += lag;
+    stats_.maxLagNs = std::max(stats_.maxLagNs, lag);
+    if (lagLog) lagLog->push_back(static_cast<std::uint32_t>(std::min<std::uint64_t>(lag, UINT32_MAX)));
+}
+
+void ReplicationStandby::check(const ReplRecord& rec, const ReplicaSlot& slot) {
+    if (show_state_hash(*slot.state) != rec.stateHash) ++stats_.mismatches;
+}
+
+void ReplicationStandby::catch_up(std::uint64_t tick) {
+    // The primary's now() is one past the last tick it processed
+    if (tick <= sched_.timers().now()) return;
+    sched_.advance(tick - 1, otherTimers_);
+}
+
+void ReplicationStandby::take_timers(std::vector<TimerEvent>& out) {
+    out.insert(out.end(), otherTimers_.begin(), otherTimers_.end());
+    otherTimers_.clear();
+}
+
+void ReplicationStandby::primary_closed(std::uint64_t nowNs) {
+    if (status_ == Status::Connecting) {
+        disconnect(); // Never got going; try again on the next poll
+        return;
+    }
+    // The socket closes slightly before the exit becomes visible on the pidfd; give it
+    // a moment. A primary that is still alive after that hung up on purpose.
+    bool died = true;
+    if (pidFd_ >= 0) {
+        pollfd pfd{ pidFd_, POLLIN, 0 };
+        died = ::poll(&pfd, 1, static_cast<int>(std::min<std::uint32_t>(failoverMs_, 20))) > 0;
+    }
+    if (died) return fail_over(nowNs, false);
+    std::fprintf(stderr, "repl: primary dropped this standby; detached\n");
+    disconnect();
+    status_ = Status::Detached;
+}
+
+void ReplicationStandby::fail_over(std::uint64_t nowNs, bool hung) {
+    if (status_ != Status::Following) {
+        // Lost the primary halfway through catching up: these shows are not fit to run
+        std::fprintf(stderr, "repl: primary lost before the standby caught up; detached\n");
+        disconnect();
+        status_ = Status::Detached;
+        return;
+    }
+    if (hung && pidFd_ >= 0) {
+        // Fence the hung primary so it cannot wake up and run the shows alongside us
+        if (::syscall(SYS_pidfd_send_signal, pidFd_, SIGKILL, nullptr, 0) == 0) fenced_ = true;
+    } else if (hung && peerPid_ > 0) {
+        if (::kill(peerPid_, SIGKILL) == 0) fenced_ = true;
+    }
+    std::fprintf(stderr, "repl: primary %s; taking over at tick %llu\n", hung ? "stopped responding" : "died",
+                 static_cast<unsigned long long>(tick_at(nowNs)));
+    disconnect();
+    failoverNs_ = nowNs;
+    status_ = Status::FailedOver;
+}
+
+std::uint64_t ReplicationStandby::tick_at(std::uint64_t nowNs) const {
+    if (!tickNs_ || nowNs <= lastSentNs_) return lastTick_;
+    return lastTick_ + (nowNs - lastSentNs_) / tickNs_;
+}
@@ -0,0 +1,199 @@
+// replication.h
+// Hot standby for live shows. The primary ships its show log (the board each show was
+// dealt and every input its fibers accepted, stamped with the scheduler tick) over a local
+// Unix socket; a standby process replays the log into its own fibers as it arrives. The
+// show flow is deterministic in (board, inputs, ticks), so the standby's shows sit at the
+// same step as the primary's, down to the running timers, and simply carry on if the
+// primary dies.
+//
+// The primary heartbeats on every flush (once per frame or loop turn). The standby fails
+// over when the socket closes and the primary process is gone, which the kernel reports
+// the moment it dies, so a crash is taken over within a frame. A hang is only detected
+// when nothing arrives for `failoverMs`; the primary is then alive but stuck, and the
+// standby kills it before taking over so two processes never run the same show. A standby that connects late is first brought up to date from
+// the primary's history of the running shows.
+//
+// Start and input records carry a hash of the primary's state after applying them; the
+// standby counts mismatches, so divergence shows up in the stats rather than at failover.
+
+#pragma once
+
+#include "show_flow.h"
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// One log record; fixed size so the stream can be cut at any record boundary
+struct ReplRecord {
+    enum Type : std::uint8_t { Hello = 1, Start, Input, Heartbeat, Synced, Goodbye };
+
+    std::uint64_t seq{0};
+    std::uint64_t tick{0};      // Primary scheduler now() when the record was made
+    std::uint64_t sentNs{0};    // repl_now_ns() when queued, for lag measurement
+    std::uint32_t show{0};      // Show id chosen by the primary (a slot; 0 for the client)
+    std::uint32_t stateHash{0}; // show_state_hash() after applying (Start, Input)
+    Type type{Heartbeat};
+    std::uint8_t inputKind{0};
+    std::uint8_t caseIndex{0};
+    std::uint8_t reserved{0};
+    std::uint8_t board[kNumCases]{}; // Start: the dealt cases. Hello: timing and tick length.
+    std::uint8_t pad[2]{};
+};
+static_assert(sizeof(ReplRecord) == 64, "ReplRecord is sent as-is");
+
+// Hash of everything the audience can see about a show
+std::uint32_t show_state_hash(const ShowState& st);
+
+// steady_clock in nanoseconds, the clock records are stamped with (shared by all
+// processes on the machine)
+std::uint64_t repl_now_ns();
+
+struct ReplicationStats {
+    std::uint64_t records{0};
+    std::uint64_t inputs{0};
+    std::uint64_t bytes{0};
+    std::uint64_t resyncs{0};    // Primary: standbys brought up to date from history
+    std::uint64_t dropped{0};    // Primary: standbys cut off for falling too far behind
+    std::uint64_t mismatches{0}; // Standby: records whose state hash differed
+    std::uint64_t maxLagNs{0};   // Standby, once following: worst time from queued to applied
+    std::uint64_t lagSumNs{0};
+};
+
+// ---------------------------------------------------------------------------------------
+// Primary side
+// ---------------------------------------------------------------------------------------
+
+class ReplicationPrimary {
+public:
+    ReplicationPrimary() = default;
+    ReplicationPrimary(const ReplicationPrimary&) = delete;
+    ReplicationPrimary& operator=(const ReplicationPrimary&) = delete;
+    ~ReplicationPrimary(); // Says goodbye, so the standby does not take over
+
+    // Serve a standby on the Unix socket `path` (replaced if it exists). Until this
+    // succeeds every other call is a no-op.
+    bool listen(const char* path, const ShowTiming& timing, std::uint32_t tickMs);
+
+    // Log events right after applying them locally; `tick` is the scheduler's now()
+    void show_started(std::uint32_t show, std::uint64_t tick, const ShowState& st);
+    void input(std::uint32_t show, std::uint64_t tick, const ShowInput& in, const ShowState& after);
+    // The show reached Finished: a standby joining later has nothing of it to replay
+    void show_ended(std::uint32_t show);
+
+    // Accept a waiting standby, heartbeat and send everything queued. Call once per loop
+    // turn; never blocks.
+    void flush(std::uint64_t tick);
+
+    bool has_standby() const { return conn_ >= 0; }
+    const ReplicationStats& stats() const { return stats_; }
+
+    // Unsent bytes beyond which a standby counts as stuck and is cut off. Checked as
+    // records are queued, so the buffer never grows much past it.
+    static constexpr std::size_t kMaxQueuedBytes = 4u << 20;
+
+private:
+    ReplRecord make(ReplRecord::Type type, std::uint32_t show, std::uint64_t tick);
+    void queue(const ReplRecord& rec);
+    void accept_standby(std::uint64_t tick);
+    void drop_standby(const char* why);
+
+    int listenFd_{-1};
+    int conn_{-1};
+    std::vector<char> path_;
+    ShowTiming timing_;
+    std::uint32_t tickMs_{0};
+    std::uint64_t seq_{0};
+    std::vector<std::uint8_t> out_; // Queued bytes; out_[0, outSent_) already went out
+    std::size_t outSent_{0};
+    std::vector<std::vector<ReplRecord>> history_; // Per running show: its Start and inputs since
+    ReplicationStats stats_;
+};
+
+// ---------------------------------------------------------------------------------------
+// Standby side
+// ---------------------------------------------------------------------------------------
+
+// Where the standby applies a show: the fiber to drive and what it reports to
+struct ReplicaSlot {
+    ShowFiber* fiber{nullptr}; // nullptr = show not replicated here
+    ShowState* state{nullptr};
+    ShowStage* stage{nullptr};
+};
+
+class ReplicationStandby {
+public:
+    enum class Status {
+        Connecting, // Waiting for a primary
+        Syncing,    // Replaying the primary's history
+        Following,  // Live, a record behind the primary at most
+        Detached,   // Primary said goodbye or dropped us; the shows are stale
+        FailedOver, // Primary died or hung: the caller now runs the shows
+    };
+
+    // Replays onto `sched`, which must not have advanced yet, with `timing`, which must
+    // match the primary's. `slot(show)` says where a show id lives.
+    ReplicationStandby(ShowScheduler& sched, const ShowTiming& timing,
+                       std::function<ReplicaSlot(std::uint32_t)> slot);
+    ReplicationStandby(const ReplicationStandby&) = delete;
+    ReplicationStandby& operator=(const ReplicationStandby&) = delete;
+    ~ReplicationStandby();
+
+    // Silence that counts as a hung primary, which then gets killed. The default rides
+    // out a window drag or a slow frame on the primary; lower it only where the primary's
+    // loop never stalls that long (a headless server on a fixed tick).
+    static constexpr std::uint32_t kDefaultFailoverMs = 250;
+    void set_failover_ms(std::uint32_t ms) { failoverMs_ = ms; }
+
+    // Connect to `path` if needed, apply whatever arrived and check the primary is alive,
+    // waiting up to `timeoutMs` for data. Once this returns FailedOver the caller owns
+    // the scheduler and the shows.
+    Status poll(const char* path, int timeoutMs);
+
+    Status status() const { return status_; }
+
+    // Timers other than the shows' that fired while the primary's log drove the scheduler,
+    // appended to `out` in firing order. Call every turn while following, like advance().
+    void take_timers(std::vector<TimerEvent>& out);
+
+    // Primary tick at repl_now_ns() time `nowNs`, extrapolated from the last record; lets
+    // the new primary's clock continue where the old one stopped
+    std::uint64_t tick_at(std::uint64_t nowNs) const;
+
+    std::uint64_t last_record_ns() const { return lastSentNs_; }
+    std::uint64_t failover_ns() const { return failoverNs_; }
+    bool fenced() const { return fenced_; } // Failover had to kill a hung primary
+    const ReplicationStats& stats() const { return stats_; }
+
+    // Optional: the lag (ns) of every record applied while following is appended here
+    std::vector<std::uint32_t>* lagLog{nullptr};
+
+private:
+    bool try_connect(const char* path);
+    void apply(const ReplRecord& rec, std::uint64_t nowNs);
+    void check(const ReplRecord& rec, const ReplicaSlot& slot);
+    void catch_up(std::uint64_t tick);
+    void primary_closed(std::uint64_t nowNs);
+    void fail_over(std::uint64_t nowNs, bool hung);
+    void disconnect();
+
+    ShowScheduler& sched_;
+    const ShowTiming& timing_;
+    std::function<ReplicaSlot(std::uint32_t)> slot_;
+    std::uint32_t failoverMs_{kDefaultFailoverMs};
+    int fd_{-1};
+    int pidFd_{-1};   // Primary process, for telling a crash from a hang or a hang-up
+    pid_t peerPid_{0};
+    Status status_{Status::Connecting};
+    std::vector<std::uint8_t> in_;
+    std::vector<TimerEvent> otherTimers_; // Fired since the last take_timers()
+    std::uint64_t lastTick_{0};
+    std::uint64_t lastSentNs_{0};
+    std::uint64_t lastRecvNs_{0};
+    std::uint64_t failoverNs_{0};
+    std::uint64_t tickNs_{0};
+    bool fenced_{false};
+    ReplicationStats stats_;
+};
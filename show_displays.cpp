@@ -0,0 +1,474 @@
+// show_displays.cpp
+// Shared text caches and the host, podium and audience layouts.
+
+#include "show_displays.h"
+
+#include "render_probe.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Cache key: the font pointer's bytes followed by the text
+void make_key(std::string& key, TTF_Font* font, const char* text) {
+    key.assign(reinterpret_cast<const char*>(&font), sizeof(font));
+    key.append(text);
+}
+
+void fill(SDL_Renderer* r, const SDL_Rect& rect, Uint8 red, Uint8 green, Uint8 blue) {
+    SDL_SetRenderDrawColor(r, red, green, blue, 255);
+    SDL_RenderFillRect(r, &rect);
+}
+
+constexpr SDL_Color kWhite{ 255, 255, 255, 255 };
+constexpr SDL_Color kGold{ 240, 200, 80, 255 };
+constexpr SDL_Color kDim{ 90, 90, 100, 255 };
+
+} // namespace
+
+void format_money(char* buf, std::size_t n, std::uint32_t cents) {
+    if (cents % 100) std::snprintf(buf, n, "$%u.%02u", cents / 100, cents % 100);
+    else std::snprintf(buf, n, "$%u", cents / 100);
+}
+
+void show_caption(const ShowState& st, char* caption, std::size_t n, const char*& action) {
+    char money[32];
+    action = "...";
+    switch (st.step) {
+    case ShowStep::Intro:
+        std::snprintf(caption, n, "Welcome to Deal or No Deal!");
+        break;
+    case ShowStep::PickCase:
+        std::snprintf(caption, n, "Pick your case");
+        action = "Pick a case";
+        break;
+    case ShowStep::OpenCases:
+        std::snprintf(caption, n, "Round %u: open %u more case%s", st.round, st.toOpen, st.toOpen == 1 ? "" : "s");
+        action = "Open a case";
+        break;
+    case ShowStep::RevealCase:
+        format_money(money, sizeof(money), kCaseValues[st.cases[st.lastOpened]]);
+        std::snprintf(caption, n, "Case %u held %s", st.lastOpened + 1u, money);
+        break;
+    case ShowStep::BankerCall:
+        std::snprintf(caption, n, "The banker is calling...");
+        break;
+    case ShowStep::Offer:
+        format_money(money, sizeof(money), st.offerCents);
+        std::snprintf(caption, n, "Banker offers %s  (D = deal, N = no deal)", money);
+        action = "No deal";
+        break;
+    case ShowStep::FinalReveal:
+        format_money(money, sizeof(money), kCaseValues[st.cases[st.contestantCase]]);
+        std::snprintf(caption, n, "Your case %u held %s", st.contestantCase + 1u, money);
+        break;
+    case ShowStep::Finished:
+        format_money(money, sizeof(money), st.winningsCents);
+        std::snprintf(caption, n, "You %s %s", st.tookDeal ? "took the deal:" : "won", money);
+        action = "Play again";
+        break;
+    }
+}
+
+void show_prompt(const ShowState& st, char* text, std::size_t n) {
+    char money[32], average[32];
+    text[0] = '\0';
+    switch (st.step) {
+    case ShowStep::Intro:
+        std::snprintf(text, n, "Twenty-six cases hold amounts from $0.01 to $1,000,000. Pick one to keep, then open the "
+                               "others round by round. After each round the banker calls with an offer: take the deal "
+                               "and the game ends, or play on. Refuse every offer and you win what your own case holds.");
+        break;
+    case ShowStep::PickCase:
+        std::snprintf(text, n, "Choose the case you will keep until the end. Nobody in the studio knows what it holds.");
+        break;
+    case ShowStep::OpenCases:
+        std::snprintf(text, n, "Open %u more case%s this round. Every amount you reveal comes off the board, and the "
+                               "banker's next offer follows what is left.", st.toOpen, st.toOpen == 1 ? "" : "s");
+        break;
+    case ShowStep::BankerCall:
+        std::snprintf(text, n, "The banker has seen the board and is on the line.");
+        break;
+    case ShowStep::Offer:
+        format_money(money, sizeof(money), st.offerCents);
+        format_money(average, sizeof(average), static_cast<std::uint32_t>(expected_value(st.openedMask)));
+        std::snprintf(text, n, "\"%s, and you walk away now. The board averages %s, but averages don't pay the rent. "
+                               "Deal, or no deal?\"", money, average);
+        break;
+    case ShowStep::Finished:
+        if (st.tookDeal) {
+            format_money(money, sizeof(money), kCaseValues[st.cases[st.contestantCase]]);
+            std::snprintf(text, n, "Your case %u held %s.", st.contestantCase + 1u, money);
+        }
+        break;
+    case ShowStep::RevealCase:
+    case ShowStep::FinalReveal:
+        break;
+    }
+}
+
+// ---------------------------------------------------------------------------------------
+// Text caches
+// ---------------------------------------------------------------------------------------
+
+SDL_Surface* TextRasterCache::get(TTF_Font* font, const char* text) {
+    if (!text || !*text) return nullptr;
+    std::string key;
+    make_key(key, font, text);
+    Entry& e = entries_[key];
+    e.lastUsed = frame_;
+    if (e.surface) {
+        ++stats_.hits;
+        return e.surface;
+    }
+    e.surface = TTF_RenderUTF8_Blended(font, text, kWhite);
+    ++stats_.misses;
+    return e.surface;
+}
+
+void TextRasterCache::end_frame() {
+    ++frame_;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.lastUsed + kEvictFrames < frame_) {
+            if (it->second.surface) SDL_FreeSurface(it->second.surface);
+            it = entries_.erase(it);
+            ++stats_.evicted;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TextRasterCache::clear() {
+    for (auto& [key, e] : entries_)
+        if (e.surface) SDL_FreeSurface(e.surface);
+    entries_.clear();
+}
+
+TextCacheStats TextRasterCache::stats() const {
+    TextCacheStats s = stats_;
+    s.entries = entries_.size();
+    return s;
+}
+
+int TextTextureCache::draw(TTF_Font* font, const char* text, int x, int y, SDL_Color color, int align) {
+    if (!text || !*text) return 0;
+    std::string key;
+    make_key(key, font, text);
+    Entry& e = entries_[key];
+    e.lastUsed = raster_.frame();
+    if (e.tex) {
+        ++stats_.hits;
+    } else {
+        // Another display may have rasterized this already; only the upload is ours
+        SDL_Surface* surf = raster_.get(font, text);
+        if (!surf) return 0;
+        e.tex = SDL_CreateTextureFromSurface(renderer_, surf);
+        if (!e.tex) return 0;
+        e.w = surf->w;
+        e.h = surf->h;
+        SDL_SetTextureBlendMode(e.tex, SDL_BLENDMODE_BLEND);
+        ++stats_.misses;
+    }
+    SDL_SetTextureColorMod(e.tex, color.r, color.g, color.b);
+    const int left = align == 0 ? x : align == 1 ? x - e.w / 2 : x - e.w;
+    const SDL_Rect dst{ left, y, e.w, e.h };
+    SDL_RenderCopy(renderer_, e.tex, nullptr, &dst);
+    return e.w;
+}
+
+void TextTextureCache::end_frame() {
+    const std::uint64_t frame = raster_.frame();
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.lastUsed + TextRasterCache::kEvictFrames < frame) {
+            if (it->second.tex) SDL_DestroyTexture(it->second.tex);
+            it = entries_.erase(it);
+            ++stats_.evicted;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TextTextureCache::release() {
+    for (auto& [key, e] : entries_)
+        if (e.tex) SDL_DestroyTexture(e.tex);
+    entries_.clear();
+}
+
+TextCacheStats TextTextureCache::stats() const {
+    TextCacheStats s = stats_;
+    s.entries = entries_.size();
+    return s;
+}
+
+// ---------------------------------------------------------------------------------------
+// Displays
+// ---------------------------------------------------------------------------------------
+
+const char* display_role_name(DisplayRole role) {
+    switch (role) {
+    case DisplayRole::Host: return "host";
+    case DisplayRole::Podium: return "podium";
+    case DisplayRole::Audience: return "audience";
+    }
+    return "?";
+}
+
+bool parse_display_role(const char* name, std::size_t len, DisplayRole& role) {
+    for (DisplayRole r : { DisplayRole::Host, DisplayRole::Podium, DisplayRole::Audience }) {
+        const char* n = display_role_name(r);
+        if (std::strlen(n) == len && !std::strncmp(n, name, len)) {
+            role = r;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShowDisplay::open(int monitor, int driver) {
+    char title[64];
+    std::snprintf(title, sizeof(title), "Deal or No Deal - %s", display_role_name(role_));
+    SDL_Rect bounds{};
+    if (monitor < SDL_GetNumVideoDisplays() && SDL_GetDisplayBounds(monitor, &bounds) == 0) {
+        window_ = SDL_CreateWindow(title, bounds.x, bounds.y, bounds.w, bounds.h, SDL_WINDOW_BORDERLESS);
+    } else {
+        const int offset = 40 * (static_cast<int>(role_) + 1);
+        window_ = SDL_CreateWindow(title, offset, offset, 960, 540, SDL_WINDOW_RESIZABLE);
+    }
+    if (!window_) {
+        std::fprintf(stderr, "%s display: SDL_CreateWindow failed: %s\n", display_role_name(role_), SDL_GetError());
+        return false;
+    }
+    // No vsync: presenting here must never wait on this monitor's refresh
+    renderer_ = SDL_CreateRenderer(window_, driver, render_driver_flags(driver));
+    if (!renderer_) {
+        std::fprintf(stderr, "%s display: SDL_CreateRenderer failed: %s\n", display_role_name(role_), SDL_GetError());
+        close();
+        return false;
+    }
+    windowId_ = SDL_GetWindowID(window_);
+    text_ = std::make_unique<TextTextureCache>(renderer_, raster_);
+    atlas_ = std::make_unique<GlyphAtlas>(renderer_);
+    SDL_DisplayMode mode{};
+    if (SDL_GetWindowDisplayMode(window_, &mode) == 0 && mode.refresh_rate > 0)
+        intervalNs_ = 1000000000u / static_cast<std::uint64_t>(mode.refresh_rate);
+    return true;
+}
+
+void ShowDisplay::close() {
+    clock_.reset();
+    offer_.reset();
+    if (text_) text_->release();
+    text_.reset();
+    atlas_.reset();
+    if (renderer_) SDL_DestroyRenderer(renderer_);
+    if (window_) SDL_DestroyWindow(window_);
+    renderer_ = nullptr;
+    window_ = nullptr;
+    windowId_ = 0;
+}
+
+void ShowDisplay::render(const ShowState& st, std::uint64_t tick, std::uint32_t stepMs, const DisplayFonts& fonts,
+                         std::uint64_t nowNs) {
+    if (!window_) return;
+    if (fonts.counters && !clock_) {
+        clock_ = std::make_unique<StreamingText>(*fonts.counters, 12);
+        offer_ = std::make_unique<StreamingText>(*fonts.counters, 14);
+    }
+    int w = 0, h = 0;
+    SDL_GetRendererOutputSize(renderer_, &w, &h);
+    cull_.begin_frame(w, h);
+    switch (role_) {
+    case DisplayRole::Host: render_host(st, tick, stepMs, fonts, w, h); break;
+    case DisplayRole::Podium: render_podium(st, fonts, w, h); break;
+    case DisplayRole::Audience: render_audience(st, tick, stepMs, fonts, w, h); break;
+    }
+    SDL_RenderPresent(renderer_);
+    text_->end_frame();
+    atlas_->end_frame();
+    ++frames_;
+    // Skip intervals we missed instead of presenting back to back to catch up
+    nextPresentNs_ = std::max(nextPresentNs_ + intervalNs_, nowNs + intervalNs_ / 2);
+}
+
+// Operator's view: the board, the numbers the banker works from and the decision clock
+void ShowDisplay::render_host(const ShowState& st, std::uint64_t tick, std::uint32_t stepMs, const DisplayFonts& fonts,
+                              int w, int h) {
+    fill(renderer_, SDL_Rect{ 0, 0, w, h }, 18, 20, 26);
+    char buf[128], money[32];
+    const char* action = nullptr;
+    show_caption(st, buf, sizeof(buf), action);
+    text_->draw(fonts.large, buf, 24, 16, kWhite, 0);
+
+    // Case grid: 6 columns, opened cases show what they held
+    const int gridW = w * 3 / 5, cols = 6, rows = (kNumCases + cols - 1) / cols;
+    const int cellW = gridW / cols, cellH = std::min((h - 90) / rows, cellW * 2 / 3);
+    for (int i = 0; i < kNumCases; i++) {
+        const SDL_Rect cell{ 24 + (i % cols) * cellW, 80 + (i / cols) * cellH, cellW - 6, cellH - 6 };
+        if (!cull_.visible(cell)) continue;
+        const bool opened = (st.openedCases >> i) & 1u;
+        const bool mine = st.phase != SessionPhase::Idle && st.step != ShowStep::PickCase && st.contestantCase == i;
+        if (mine) fill(renderer_, cell, 90, 75, 20);
+        else if (opened) fill(renderer_, cell, 28, 30, 36);
+        else fill(renderer_, cell, 46, 50, 62);
+        std::snprintf(buf, sizeof(buf), "%d", i + 1);
+        text_->draw(fonts.small, buf, cell.x + cell.w / 2, cell.y + 4, opened ? kDim : kWhite);
+        if (opened) {
+            format_money(money, sizeof(money), kCaseValues[st.cases[static_cast<std::size_t>(i)]]);
+            text_->draw(fonts.small, money, cell.x + cell.w / 2, cell.y + cell.h / 2, kGold);
+        }
+    }
+
+    // Figures column
+    const int x = 24 + gridW + 24;
+    int y = 80;
+    const int line = TTF_FontLineSkip(fonts.small) + 6;
+    std::snprintf(buf, sizeof(buf), "Round %u", st.round);
+    text_->draw(fonts.small, buf, x, y, kWhite, 0);
+    y += line;
+    std::snprintf(buf, sizeof(buf), "To open: %u", st.toOpen);
+    text_->draw(fonts.small, buf, x, y, kWhite, 0);
+    y += line;
+    format_money(money, sizeof(money), static_cast<std::uint32_t>(expected_value(st.openedMask)));
+    std::snprintf(buf, sizeof(buf), "Board average: %s", money);
+    text_->draw(fonts.small, buf, x, y, kWhite, 0);
+    y += line;
+    if (st.offerCents) {
+        format_money(money, sizeof(money), st.offerCents);
+        std::snprintf(buf, sizeof(buf), "Last offer: %s", money);
+        text_->draw(fonts.small, buf, x, y, kGold, 0);
+    }
+    y += line;
+    if (st.stepTicks) {
+        // Tenths change every frame or two: streamed, not rasterized
+        const std::uint64_t end = st.stepStartTick + st.stepTicks;
+        const std::uint64_t left = end > tick ? (end - tick) * stepMs : 0;
+        const int labelW = text_->draw(fonts.large, "Clock: ", x, y, kGold, 0);
+        if (clock_) {
+            std::snprintf(buf, sizeof(buf), "%llu.%llu s", static_cast<unsigned long long>(left / 1000),
+                          static_cast<unsigned long long>(left % 1000 / 100));
+            clock_->set(renderer_, buf);
+            clock_->draw(renderer_, x + labelW, y, kGold, 0);
+        }
+    }
+
+    // What to say next, wrapped to the column; laid out again only when it changes
+    y += TTF_FontLineSkip(fonts.large) + 12;
+    char prompt[512];
+    show_prompt(st, prompt, sizeof(prompt));
+    if (prompt[0] && w - x - 24 > 0) atlas_->draw(fonts.small, layouts_.get(fonts.small, prompt, w - x - 24, TextAlign::Left), x, y, kWhite);
+}
+
+// Contestant's podium: their case and the cases still in play
+void ShowDisplay::render_podium(const ShowState& st, const DisplayFonts& fonts, int w, int h) {
+    fill(renderer_, SDL_Rect{ 0, 0, w, h }, 12, 14, 30);
+    char buf[128];
+    const char* action = nullptr;
+    show_caption(st, buf, sizeof(buf), action);
+    text_->draw(fonts.large, buf, w / 2, h / 12, kWhite);
+
+    // While the banker is on the line their panel covers the board; what it hides is skipped
+    const bool banker = st.step == ShowStep::BankerCall || st.step == ShowStep::Offer;
+    const SDL_Rect panel{ w / 12, h / 5, w - w / 6, h * 3 / 4 };
+    if (banker) cull_.add_overlay(panel);
+
+    const bool picked = st.phase != SessionPhase::Idle && st.step != ShowStep::PickCase && st.step != ShowStep::Intro;
+    const SDL_Rect mine{ w / 2 - 90, h / 4, 180, 120 };
+    if (picked && cull_.visible(mine)) {
+        fill(renderer_, mine, 90, 75, 20);
+        std::snprintf(buf, sizeof(buf), "%u", st.contestantCase + 1u);
+        text_->draw(fonts.large, buf, w / 2, mine.y + mine.h / 2 - TTF_FontHeight(fonts.large) / 2, kWhite);
+        text_->draw(fonts.small, "Your case", w / 2, mine.y + mine.h + 8, kGold);
+    }
+
+    // Unopened cases in rows of 9
+    const int cols = 9, cellW = std::min(w / (cols + 1), 96), cellH = cellW * 2 / 3;
+    const int left = (w - cols * cellW) / 2, top = h / 2 + 20;
+    int remaining = 0;
+    for (int i = 0; i < kNumCases; i++)
+        if (!((st.openedCases >> i) & 1u) && !(picked && st.contestantCase == i)) ++remaining;
+    const SDL_Rect board{ left, top, cols * cellW, (remaining + cols - 1) / cols * cellH };
+    if (remaining && cull_.any_visible(board, static_cast<std::uint32_t>(remaining))) {
+        int slot = 0;
+        for (int i = 0; i < kNumCases; i++) {
+            if (((st.openedCases >> i) & 1u) || (picked && st.contestantCase == i)) continue;
+            const SDL_Rect cell{ left + (slot % cols) * cellW, top + (slot / cols) * cellH, cellW - 6, cellH - 6 };
+            ++slot;
+            if (!cull_.visible(cell)) continue;
+            fill(renderer_, cell, 46, 50, 62);
+            std::snprintf(buf, sizeof(buf), "%d", i + 1);
+            text_->draw(fonts.small, buf, cell.x + cell.w / 2, cell.y + (cell.h - TTF_FontHeight(fonts.small)) / 2, kWhite);
+        }
+    }
+    if (banker) render_banker_panel(st, fonts, panel);
+}
+
+// The banker's call over the podium: who is calling, the offer once made, and what the banker says
+void ShowDisplay::render_banker_panel(const ShowState& st, const DisplayFonts& fonts, const SDL_Rect& panel) {
+    fill(renderer_, panel, 10, 10, 14);
+    SDL_SetRenderDrawColor(renderer_, kGold.r, kGold.g, kGold.b, 255);
+    SDL_RenderDrawRect(renderer_, &panel);
+    const int cx = panel.x + panel.w / 2;
+    int y = panel.y + 24;
+    text_->draw(fonts.large, "THE BANKER", cx, y, kGold);
+    y += TTF_FontLineSkip(fonts.large) + 12;
+    if (st.step == ShowStep::Offer) {
+        char money[32];
+        format_money(money, sizeof(money), st.offerCents);
+        text_->draw(fonts.large, money, cx, y, kWhite);
+        y += TTF_FontLineSkip(fonts.large) + 12;
+    }
+    char prompt[512];
+    show_prompt(st, prompt, sizeof(prompt));
+    const int textW = panel.w - 48;
+    if (prompt[0] && textW > 0) {
+        const TextLayout& run = layouts_.get(fonts.small, prompt, textW, TextAlign::Center);
+        atlas_->draw(fonts.small, run, cx - run.width / 2, y, kWhite);
+    }
+}
+
+// Audience wall: the money board flanking the caption, values leaving the board as they
+// are revealed
+void ShowDisplay::render_audience(const ShowState& st, std::uint64_t tick, std::uint32_t stepMs,
+                                  const DisplayFonts& fonts, int w, int h) {
+    fill(renderer_, SDL_Rect{ 0, 0, w, h }, 6, 8, 20);
+    char buf[128], money[32];
+    constexpr int kRows = kNumCases / 2;
+    const int colW = w / 5, margin = 16, rowH = (h - 2 * margin) / kRows;
+    for (int i = 0; i < kNumCases; i++) {
+        const int col = i / kRows, row = i % kRows;
+        const SDL_Rect cell{ col ? w - margin - colW : margin, margin + row * rowH, colW, rowH - 4 };
+        if (!cull_.visible(cell)) continue;
+        const bool gone = (st.openedMask >> i) & 1u;
+        if (gone) fill(renderer_, cell, 24, 24, 30);
+        else if (col) fill(renderer_, cell, 150, 110, 20);
+        else fill(renderer_, cell, 30, 70, 150);
+        format_money(money, sizeof(money), kCaseValues[static_cast<std::size_t>(i)]);
+        text_->draw(fonts.small, money, cell.x + cell.w - 10, cell.y + (cell.h - TTF_FontHeight(fonts.small)) / 2,
+                    gone ? kDim : kWhite, 2);
+    }
+
+    const char* action = nullptr;
+    show_caption(st, buf, sizeof(buf), action);
+    // The keyboard hint in the offer caption is for the operator, not the audience
+    if (char* hint = std::strstr(buf, "  (")) *hint = '\0';
+    text_->draw(fonts.large, buf, w / 2, h / 3, kWhite);
+    if (st.step == ShowStep::Offer) {
+        // The offer counts up over the first second, a new value every frame
+        const std::uint64_t ms = (tick - std::min(tick, st.stepStartTick)) * stepMs;
+        const double t = std::min(static_cast<double>(ms) / 1000.0, 1.0);
+        const double eased = 1.0 - (1.0 - t) * (1.0 - t) * (1.0 - t);
+        const auto shown = static_cast<std::uint32_t>(static_cast<double>(st.offerCents / 100) * eased) * 100;
+        format_money(money, sizeof(money), t < 1.0 ? shown : st.offerCents);
+        if (offer_) {
+            offer_->set(renderer_, money);
+            offer_->draw(renderer_, w / 2, h / 2, kGold);
+        } else {
+            text_->draw(fonts.large, money, w / 2, h / 2, kGold);
+        }
+        text_->draw(fonts.small, "DEAL or NO DEAL?", w / 2, h / 2 + TTF_FontLineSkip(fonts.large) + 8, kWhite);
+    }
+}
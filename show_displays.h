@@ -0,0 +1,188 @@
+// show_displays.h
+// Studio outputs beyond the operator window: the host monitor, the contestant's podium and
+// the audience wall. All of them draw the same ShowState, each with its own layout and its
+// own window and renderer.
+//
+// Text is the expensive part of these layouts, and most of it repeats across displays and
+// frames (case numbers, board values, captions). Rasterizing happens once: a
+// TextRasterCache keeps SDL_ttf's surfaces for every (font, text) pair in use, and each
+// renderer has a TextTextureCache that uploads a surface the first time that renderer draws
+// it. Textures cannot be shared between renderers, surfaces can. Entries nobody drew for
+// a while are evicted, so changing captions and offers do not pile up.
+//
+// Only the main window presents with vsync and paces the loop. Extra displays present
+// without vsync, each at most once per refresh interval of the monitor it is on, so a
+// slow or differently clocked monitor never stalls the others.
+
+#pragma once
+
+#include "counter_text.h"
+#include "show_flow.h"
+#include "text_layout.h"
+#include "ui_cull.h"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Money as "$1,000" (cents shown only when there are any, e.g. "$0.01")
+void format_money(char* buf, std::size_t n, std::uint32_t cents);
+
+// Caption and operator button label for the current show step
+void show_caption(const ShowState& st, char* caption, std::size_t n, const char*& action);
+
+// Longer text for the current step, meant to be wrapped: the rules during the intro, the
+// banker's words during an offer, the host's prompt otherwise. Empty when there is none.
+void show_prompt(const ShowState& st, char* text, std::size_t n);
+
+// ---------------------------------------------------------------------------------------
+// Text caches
+// ---------------------------------------------------------------------------------------
+
+struct TextCacheStats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};   // Rasterized (raster cache) or uploaded (texture cache)
+    std::uint64_t evicted{0};
+    std::size_t entries{0};
+};
+
+// Rasterized text shared by every renderer. Surfaces are white; color comes from a color
+// mod at draw time, so recoloring a label never re-rasterizes it.
+class TextRasterCache {
+public:
+    // Entries not used for this many frames are freed
+    static constexpr std::uint64_t kEvictFrames = 120;
+
+    TextRasterCache() = default;
+    TextRasterCache(const TextRasterCache&) = delete;
+    TextRasterCache& operator=(const TextRasterCache&) = delete;
+    ~TextRasterCache() { clear(); }
+
+    // Surface for `text` in `font` (nullptr for empty text or on SDL_ttf failure). Valid
+    // until the next end_frame().
+    SDL_Surface* get(TTF_Font* font, const char* text);
+
+    // Advance the frame counter and evict stale entries. Call once per main loop iteration.
+    void end_frame();
+    void clear();
+
+    std::uint64_t frame() const { return frame_; }
+    TextCacheStats stats() const;
+
+private:
+    struct Entry {
+        SDL_Surface* surface{nullptr};
+        std::uint64_t lastUsed{0};
+    };
+
+    std::unordered_map<std::string, Entry> entries_;
+    std::uint64_t frame_{0};
+    TextCacheStats stats_;
+};
+
+// Textures for one renderer, uploaded from the shared raster cache
+class TextTextureCache {
+public:
+    TextTextureCache(SDL_Renderer* renderer, TextRasterCache& raster) : renderer_(renderer), raster_(raster) {}
+    TextTextureCache(const TextTextureCache&) = delete;
+    TextTextureCache& operator=(const TextTextureCache&) = delete;
+    ~TextTextureCache() { release(); }
+
+    // Draw `text` with its top edge at y. `align` is where x sits on the text: 0 = left
+    // edge, 1 = center, 2 = right edge. Returns the drawn width.
+    int draw(TTF_Font* font, const char* text, int x, int y, SDL_Color color, int align = 1);
+
+    // Evict textures the raster cache's frame counter says are stale
+    void end_frame();
+    // Destroy all textures. Must be called before the renderer goes away.
+    void release();
+
+    TextCacheStats stats() const;
+
+private:
+    struct Entry {
+        SDL_Texture* tex{nullptr};
+        int w{0}, h{0};
+        std::uint64_t lastUsed{0};
+    };
+
+    SDL_Renderer* renderer_;
+    TextRasterCache& raster_;
+    std::unordered_map<std::string, Entry> entries_;
+    TextCacheStats stats_;
+};
+
+// ---------------------------------------------------------------------------------------
+// Displays
+// ---------------------------------------------------------------------------------------
+
+enum class DisplayRole : std::uint8_t { Host, Podium, Audience };
+
+const char* display_role_name(DisplayRole role);
+// "host", "podium" or "audience"; false for anything else
+bool parse_display_role(const char* name, std::size_t len, DisplayRole& role);
+
+// Fonts the layouts draw with (owned by the caller, shared by all displays)
+struct DisplayFonts {
+    TTF_Font* large{nullptr};
+    TTF_Font* small{nullptr};
+    const GlyphSet* counters{nullptr}; // `large` glyphs for the clock and offer counters
+};
+
+class ShowDisplay {
+public:
+    ShowDisplay(DisplayRole role, TextRasterCache& raster, TextLayoutCache& layouts)
+        : role_(role), raster_(raster), layouts_(layouts) {}
+    ShowDisplay(const ShowDisplay&) = delete;
+    ShowDisplay& operator=(const ShowDisplay&) = delete;
+    ~ShowDisplay() { close(); }
+
+    // Create the window, borderless over monitor `monitor` when it exists, otherwise as
+    // a regular window cascaded from the main one. `driver` is the render driver index
+    // (-1 = SDL's choice).
+    bool open(int monitor, int driver);
+    void close();
+    bool is_open() const { return window_ != nullptr; }
+
+    DisplayRole role() const { return role_; }
+    Uint32 window_id() const { return windowId_; }
+
+    // Whether a refresh interval has passed since the last present
+    bool due(std::uint64_t nowNs) const { return window_ && nowNs >= nextPresentNs_; }
+
+    // Draw `st` at scheduler tick `tick` and present (without waiting for vsync)
+    void render(const ShowState& st, std::uint64_t tick, std::uint32_t stepMs, const DisplayFonts& fonts,
+                std::uint64_t nowNs);
+
+    std::uint64_t frames() const { return frames_; }
+    const TextTextureCache* text() const { return text_.get(); }
+    // Widgets drawn and culled, for the last frame and in total
+    const WidgetCuller& culler() const { return cull_; }
+
+private:
+    void render_host(const ShowState& st, std::uint64_t tick, std::uint32_t stepMs, const DisplayFonts& fonts, int w, int h);
+    void render_podium(const ShowState& st, const DisplayFonts& fonts, int w, int h);
+    void render_banker_panel(const ShowState& st, const DisplayFonts& fonts, const SDL_Rect& panel);
+    void render_audience(const ShowState& st, std::uint64_t tick, std::uint32_t stepMs, const DisplayFonts& fonts,
+                         int w, int h);
+
+    DisplayRole role_;
+    TextRasterCache& raster_;
+    TextLayoutCache& layouts_;
+    SDL_Window* window_{nullptr};
+    SDL_Renderer* renderer_{nullptr};
+    std::unique_ptr<TextTextureCache> text_;
+    std::unique_ptr<GlyphAtlas> atlas_;    // Wrapped paragraphs
+    WidgetCuller cull_;
+    std::unique_ptr<StreamingText> clock_; // Host: decision clock
+    std::unique_ptr<StreamingText> offer_; // Audience: offer counting up
+    Uint32 windowId_{0};
+    std::uint64_t intervalNs_{16666667};
+    std::uint64_t nextPresentNs_{0};
+    std::uint64_t frames_{0};
+};
@@ -0,0 +1,193 @@
+// show_flow.cpp
+
+#include "show_flow.h"
+
+// ---------------------------------------------------------------------------------------
+// Scheduler and fibers
+// ---------------------------------------------------------------------------------------
+
+void ShowScheduler::advance(std::uint64_t tick, std::vector<TimerEvent>& other) {
+    // One batch per due tick: a fiber resumes with now() just past its own timer, not past
+    // `tick`, so what it stamps and schedules does not depend on how many ticks the caller
+    // advances at once (a frame, a replicated record, a replay seek)
+    while (timers_.now() <= tick) {
+        const std::uint64_t until = timers_.now() + timers_.ticks_until_next(tick - timers_.now());
+        expired_.clear();
+        timers_.advance(until, expired_);
+        for (const TimerEvent& ev : expired_) {
+            if (ev.kind == kShowTimerKind) reinterpret_cast<ShowFiber*>(ev.payload)->on_timer(ev.id);
+            else other.push_back(ev);
+        }
+    }
+}
+
+void ShowFiber::start(ShowScheduler& sched, ShowTask flow) {
+    stop();
+    sched_ = &sched;
+    root_ = std::move(flow);
+    root_.resume();
+}
+
+void ShowFiber::stop() {
+    if (sched_ && timer_ != kInvalidTimer) sched_->timers().cancel(timer_);
+    timer_ = kInvalidTimer;
+    waiter_ = {};
+    wantsInput_ = false;
+    inbox_.clear();
+    root_.reset();
+}
+
+bool ShowFiber::post(const ShowInput& input) {
+    if (!running() || inbox_.size() >= kMaxQueuedInputs) return false;
+    inbox_.push_back(input);
+    if (wantsInput_) wake();
+    return true;
+}
+
+void ShowFiber::wait_timer(std::coroutine_handle<> h, std::uint64_t ticks) {
+    waiter_ = h;
+    timer_ = sched_->timers().schedule_in(ticks, ShowScheduler::kShowTimerKind, reinterpret_cast<std::uint64_t>(this));
+}
+
+void ShowFiber::wait_input(std::coroutine_handle<> h, std::uint64_t timeout) {
+    waiter_ = h;
+    wantsInput_ = true;
+    if (timeout) timer_ = sched_->timers().schedule_in(timeout, ShowScheduler::kShowTimerKind, reinterpret_cast<std::uint64_t>(this));
+}
+
+std::optional<ShowInput> ShowFiber::take_input() {
+    if (inbox_.empty()) return std::nullopt; // Input wait timed out
+    const ShowInput in = inbox_.front();
+    inbox_.pop_front();
+    return in;
+}
+
+void ShowFiber::on_timer(TimerId id) {
+    if (id != timer_) return; // Stale: the fiber moved on or was stopped
+    timer_ = kInvalidTimer;
+    wake();
+}
+
+void ShowFiber::wake() {
+    if (timer_ != kInvalidTimer) {
+        sched_->timers().cancel(timer_); // Input arrived before the timeout
+        timer_ = kInvalidTimer;
+    }
+    wantsInput_ = false;
+    const std::coroutine_handle<> h = std::exchange(waiter_, {});
+    if (h) h.resume();
+}
+
+// ---------------------------------------------------------------------------------------
+// The show
+// ---------------------------------------------------------------------------------------
+
+namespace {
+
+void enter(ShowFiber& fiber, ShowState& st, ShowStep step, std::uint64_t ticks) {
+    st.step = step;
+    st.stepStartTick = fiber.now();
+    st.stepTicks = ticks;
+}
+
+ShowTask pick_case(ShowFiber& fiber, ShowStage& stage, ShowState& st) {
+    enter(fiber, st, ShowStep::PickCase, 0);
+    stage.on_step(st);
+    for (;;) {
+        const std::optional<ShowInput> in = co_await fiber.input();
+        if (in->kind != ShowInput::PickCase) { stage.on_rejected(*in, ErrorCode::NotAllowed); continue; }
+        if (in->caseIndex >= kNumCases) { stage.on_rejected(*in, ErrorCode::BadCase); continue; }
+        st.contestantCase = in->caseIndex;
+        co_return;
+    }
+}
+
+ShowTask open_cases(ShowFiber& fiber, ShowStage& stage, ShowState& st, const ShowTiming& timing) {
+    st.toOpen = static_cast<std::uint8_t>(kCasesPerRound[st.round - 1u]);
+    st.phase = SessionPhase::Opening;
+    enter(fiber, st, ShowStep::OpenCases, 0);
+    stage.on_step(st);
+    while (st.toOpen > 0) {
+        const std::optional<ShowInput> in = co_await fiber.input();
+        if (in->kind != ShowInput::OpenCase) { stage.on_rejected(*in, ErrorCode::NotAllowed); continue; }
+        const std::uint8_t c = in->caseIndex;
+        if (c >= kNumCases || c == st.contestantCase || (st.openedCases & (1u << c))) {
+            stage.on_rejected(*in, ErrorCode::BadCase);
+            continue;
+        }
+        st.openedCases |= 1u << c;
+        st.openedMask |= 1u << st.cases[c];
+        st.lastOpened = c;
+        --st.toOpen;
+        if (timing.revealTicks) {
+            enter(fiber, st, ShowStep::RevealCase, timing.revealTicks);
+            stage.on_step(st);
+            co_await fiber.sleep(timing.revealTicks);
+            enter(fiber, st, ShowStep::OpenCases, 0);
+        }
+        stage.on_step(st);
+    }
+}
+
+// Banker call and offer; leaves the decision in st.tookDeal
+ShowTask banker_offer_step(ShowFiber& fiber, ShowStage& stage, ShowState& st, const ShowTiming& timing) {
+    enter(fiber, st, ShowStep::BankerCall, timing.bankerCallTicks);
+    stage.on_step(st);
+    co_await fiber.sleep(timing.bankerCallTicks);
+
+    st.offerCents = banker_offer(st.openedMask, st.round);
+    st.phase = SessionPhase::Offer;
+    enter(fiber, st, ShowStep::Offer, timing.decisionTicks);
+    stage.on_step(st);
+
+    // The countdown keeps running through rejected inputs
+    const std::uint64_t deadline = fiber.now() + timing.decisionTicks;
+    for (;;) {
+        const std::uint64_t left = deadline > fiber.now() ? deadline - fiber.now() : 1;
+        const std::optional<ShowInput> in = co_await fiber.input(timing.decisionTicks ? left : 0);
+        if (!in) { st.tookDeal = false; co_return; } // Silence counts as NO DEAL
+        if (in->kind == ShowInput::Deal || in->kind == ShowInput::NoDeal) {
+            st.tookDeal = in->kind == ShowInput::Deal;
+            co_return;
+        }
+        stage.on_rejected(*in, ErrorCode::NotAllowed);
+    }
+}
+
+} // namespace
+
+ShowTask run_show(ShowFiber& fiber, ShowStage& stage, ShowState& st, const ShowTiming& timing) {
+    // Everything but the board; a host reuses the state for its next show, and a replica
+    // starting the same show from scratch must end up with the same state
+    st.phase = SessionPhase::Idle;
+    st.contestantCase = 0;
+    st.lastOpened = 0;
+    st.round = 0;
+    st.toOpen = 0;
+    st.openedMask = 0;
+    st.openedCases = 0;
+    st.offerCents = 0;
+    st.winningsCents = 0;
+    st.tookDeal = false;
+
+    enter(fiber, st, ShowStep::Intro, timing.introTicks);
+    stage.on_step(st);
+    co_await fiber.sleep(timing.introTicks);
+
+    co_await pick_case(fiber, stage, st);
+
+    for (int round = 1; round <= kNumRounds && !st.tookDeal; round++) {
+        st.round = static_cast<std::uint8_t>(round);
+        co_await open_cases(fiber, stage, st, timing);
+        co_await banker_offer_step(fiber, stage, st, timing);
+    }
+    st.winningsCents = st.tookDeal ? st.offerCents : kCaseValues[st.cases[st.contestantCase]];
+    st.phase = SessionPhase::Finished;
+
+    enter(fiber, st, ShowStep::FinalReveal, timing.finaleTicks);
+    stage.on_step(st);
+    co_await fiber.sleep(timing.finaleTicks);
+
+    enter(fiber, st, ShowStep::Finished, 0);
+    stage.on_step(st);
+}
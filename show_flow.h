@@ -0,0 +1,248 @@
+// show_flow.h
+// The show flow as C++20 coroutines. One function (run_show) describes the whole show:
+// intro, pick a case, open cases, banker call, offer, DEAL / NO DEAL, final reveal. Each
+// step co_awaits a timer (animations and pauses) or the player's next input, so the flow
+// reads top to bottom instead of being spread over event-loop state machines.
+//
+// Sessions are ShowFibers: a suspended coroutine chain plus the one thing it is waiting
+// for. A ShowScheduler drives all fibers of a thread off a single timer wheel, so the SDL
+// client (one fiber) and a server shard (thousands) run the same flow code. Coroutine
+// frames come from the thread's frame pool (frame_pool.h).
+//
+// Everything here is single-threaded: a fiber lives on the thread of its scheduler.
+
+#pragma once
+
+#include "frame_pool.h"
+#include "game.h"
+#include "net_protocol.h"
+#include "timer_wheel.h"
+
+#include <array>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------------------
+// Task: lazily started coroutine that can be co_awaited by another ShowTask
+// ---------------------------------------------------------------------------------------
+
+class ShowTask {
+public:
+    struct promise_type {
+        std::coroutine_handle<> continuation; // Awaiting parent, empty for a fiber's root
+
+        ShowTask get_return_object() { return ShowTask{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            // Hand control straight back to the parent (symmetric transfer); a root stays
+            // suspended at the end until its fiber releases it
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    const std::coroutine_handle<> next = h.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+        void return_void() {}
+        // The flow code reports errors through its stage, never by throwing
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(std::size_t size) { return frame_pool_alloc(size); }
+        static void operator delete(void* p, std::size_t size) { frame_pool_free(p, size); }
+    };
+
+    ShowTask() = default;
+    ShowTask(ShowTask&& o) noexcept : handle_(std::exchange(o.handle_, {})) {}
+    ShowTask& operator=(ShowTask&& o) noexcept {
+        if (this != &o) {
+            reset();
+            handle_ = std::exchange(o.handle_, {});
+        }
+        return *this;
+    }
+    ShowTask(const ShowTask&) = delete;
+    ShowTask& operator=(const ShowTask&) = delete;
+    ~ShowTask() { reset(); }
+
+    // Destroy the frame (and, through its locals, every child frame it is awaiting)
+    void reset() {
+        if (handle_) handle_.destroy();
+        handle_ = {};
+    }
+
+    bool valid() const { return static_cast<bool>(handle_); }
+    bool done() const { return !handle_ || handle_.done(); }
+    void resume() { handle_.resume(); }
+
+    // co_await child_task(): start the child, resume the parent when it finishes
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) noexcept {
+        handle_.promise().continuation = parent;
+        return handle_;
+    }
+    void await_resume() const noexcept {}
+
+private:
+    explicit ShowTask(std::coroutine_handle<promise_type> h) : handle_(h) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// ---------------------------------------------------------------------------------------
+// Fibers and their scheduler
+// ---------------------------------------------------------------------------------------
+
+// Player input fed into a fiber
+struct ShowInput {
+    enum Kind : std::uint8_t { PickCase, OpenCase, Deal, NoDeal };
+    Kind kind{PickCase};
+    std::uint8_t caseIndex{0};
+};
+
+class ShowFiber;
+
+// Owns the timer wheel every fiber of one thread sleeps on. The wheel is shared with the
+// host: timer kinds below kShowTimerKind belong to the caller and come back from advance().
+class ShowScheduler {
+public:
+    static constexpr std::uint32_t kShowTimerKind = 0x5300;
+
+    explicit ShowScheduler(std::uint64_t startTick = 0) : timers_(startTick) {}
+
+    // Process ticks up to `tick`: resume fibers whose timers expired and append the
+    // caller's own expired timers to `other`. Fibers resume one due tick at a time, so the
+    // outcome does not depend on how far each call advances.
+    void advance(std::uint64_t tick, std::vector<TimerEvent>& other);
+
+    TimerWheel& timers() { return timers_; }
+    const TimerWheel& timers() const { return timers_; }
+
+private:
+    TimerWheel timers_;
+    std::vector<TimerEvent> expired_;
+};
+
+// One running show. Not movable: pending timers refer to the fiber by address.
+class ShowFiber {
+public:
+    ShowFiber() = default;
+    ShowFiber(const ShowFiber&) = delete;
+    ShowFiber& operator=(const ShowFiber&) = delete;
+    ~ShowFiber() { stop(); }
+
+    // Start `flow` (created with this fiber as its argument); runs until its first wait
+    void start(ShowScheduler& sched, ShowTask flow);
+
+    // Destroy the flow and whatever it waits on. Must not be called from inside the flow.
+    void stop();
+
+    bool running() const { return root_.valid() && !root_.done(); }
+
+    // Deliver input: resumes the flow if it is waiting for input, otherwise queues it
+    // (up to kMaxQueuedInputs; returns false when the input was dropped)
+    bool post(const ShowInput& input);
+
+    // Awaitables for flow code -----------------------------------------------------------
+
+    // co_await fiber.sleep(ticks): pause for a number of scheduler ticks (0 = no pause)
+    auto sleep(std::uint64_t ticks) {
+        struct Awaiter {
+            ShowFiber& fiber;
+            std::uint64_t ticks;
+            bool await_ready() const noexcept { return ticks == 0; }
+            void await_suspend(std::coroutine_handle<> h) { fiber.wait_timer(h, ticks); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{ *this, ticks };
+    }
+
+    // co_await fiber.input(timeoutTicks): next player input, or nullopt once `timeoutTicks`
+    // pass without one (0 = wait indefinitely)
+    auto input(std::uint64_t timeoutTicks = 0) {
+        struct Awaiter {
+            ShowFiber& fiber;
+            std::uint64_t timeout;
+            bool await_ready() const noexcept { return !fiber.inbox_.empty(); }
+            void await_suspend(std::coroutine_handle<> h) { fiber.wait_input(h, timeout); }
+            std::optional<ShowInput> await_resume() { return fiber.take_input(); }
+        };
+        return Awaiter{ *this, timeoutTicks };
+    }
+
+    // Ticks since the scheduler started; lets the flow (and renderers) time animations
+    std::uint64_t now() const { return sched_ ? sched_->timers().now() : 0; }
+
+    static constexpr std::size_t kMaxQueuedInputs = 8;
+
+private:
+    friend class ShowScheduler;
+
+    void wait_timer(std::coroutine_handle<> h, std::uint64_t ticks);
+    void wait_input(std::coroutine_handle<> h, std::uint64_t timeout);
+    std::optional<ShowInput> take_input();
+    void on_timer(TimerId id);
+    void wake();
+
+    ShowScheduler* sched_{nullptr};
+    ShowTask root_;
+    std::coroutine_handle<> waiter_; // Innermost suspended frame, empty when running or idle
+    TimerId timer_{kInvalidTimer};
+    bool wantsInput_{false};
+    std::deque<ShowInput> inbox_;
+};
+
+// ---------------------------------------------------------------------------------------
+// The show
+// ---------------------------------------------------------------------------------------
+
+// Step of the show the flow is in; renderers key captions and animations off it
+enum class ShowStep : std::uint8_t {
+    Intro, PickCase, OpenCases, RevealCase, BankerCall, Offer, FinalReveal, Finished,
+};
+
+// Everything the audience can see about one show
+struct ShowState {
+    ShowStep step{ShowStep::Intro};
+    SessionPhase phase{SessionPhase::Idle};
+    std::array<std::uint8_t, kNumCases> cases{}; // Value index held by each case position (set by the host)
+    std::uint8_t contestantCase{0};
+    std::uint8_t lastOpened{0};                  // Case being revealed in RevealCase
+    std::uint8_t round{0};
+    std::uint8_t toOpen{0};
+    std::uint32_t openedMask{0};
+    std::uint32_t openedCases{0};
+    std::uint32_t offerCents{0};
+    std::uint32_t winningsCents{0};
+    bool tookDeal{false};
+    std::uint64_t stepStartTick{0};              // When the current step began
+    std::uint64_t stepTicks{0};                  // Its scheduled length (0 = until input)
+};
+
+// Durations of the timed steps, in scheduler ticks. The server uses zeros for everything
+// but the decision countdown; the SDL client paces the show for a human audience.
+struct ShowTiming {
+    std::uint32_t introTicks{0};
+    std::uint32_t revealTicks{0};
+    std::uint32_t bankerCallTicks{0};
+    std::uint32_t decisionTicks{0};  // 0 = wait for the contestant indefinitely
+    std::uint32_t finaleTicks{0};
+};
+
+// Where the flow reports to: a server session or the local game
+class ShowStage {
+public:
+    virtual ~ShowStage() = default;
+    virtual void on_step(const ShowState& state) = 0;                 // Step or state changed
+    virtual void on_rejected(const ShowInput& input, ErrorCode why) = 0; // Input not valid now
+};
+
+// The whole show for one contestant. `state.cases` must hold the shuffled board; every
+// referenced object must outlive the flow.
+ShowTask run_show(ShowFiber& fiber, ShowStage& stage, ShowState& state, const ShowTiming& timing);
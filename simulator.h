@@ -0,0 +1,105 @@
+// simulator.h
+// Headless game simulator. play_game() is a template over the contestant policy so the
+// decision call inlines and millions of games per run cost only the shuffles and offers.
+//
+// A policy is any type with
+//     bool take_deal(std::uint32_t openedMask, int round, std::uint32_t offerCents, Rng& rng);
+
+#pragma once
+
+#include "game.h"
+#include "game_log.h"
+#include "solver.h"
+#include "strategy_table.h"
+#include "transposition_table.h"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// How one game ended
+struct GameResult {
+    std::uint32_t winningsCents{0};
+    std::uint8_t dealRound{0}; // Round the contestant took the deal, 0 if they kept their case
+};
+
+// Uniform integer in [0, n) from a 64-bit engine. Multiply-shift instead of
+// std::uniform_int_distribution so every standard library produces the same games.
+template <class Rng>
+std::uint32_t sim_bounded(Rng& rng, std::uint32_t n) {
+    return static_cast<std::uint32_t>(((rng() >> 32) * n) >> 32);
+}
+
+// Play one full game. Case values are shuffled, the contestant holds case 0 and the other
+// cases open in random order following kCasesPerRound. Each banker call is appended to
+// `log` when it is non-null.
+template <class Policy, class Rng>
+GameResult play_game(Rng& rng, Policy& policy, std::uint32_t gameId, std::vector<DecisionRecord>* log) {
+    // Shuffle value indices into cases (Fisher-Yates)
+    std::array<std::uint8_t, kNumCases> cases{};
+    for (int i = 0; i < kNumCases; i++) cases[static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(i);
+    for (std::uint32_t i = kNumCases - 1; i > 0; i--) {
+        const std::uint32_t j = sim_bounded(rng, i + 1);
+        std::swap(cases[i], cases[j]);
+    }
+
+    GameResult res;
+    std::uint32_t openedMask = 0;
+    std::size_t next = 1; // Case 0 is the contestant's
+    for (int round = 1; round <= kNumRounds; round++) {
+        for (int k = 0; k < kCasesPerRound[static_cast<std::size_t>(round - 1)]; k++)
+            openedMask |= 1u << cases[next++];
+
+        const std::uint32_t offer = banker_offer(openedMask, round);
+        const bool deal = policy.take_deal(openedMask, round, offer, rng);
+        if (log) {
+            DecisionRecord rec;
+            rec.gameId = gameId;
+            rec.openedMask = openedMask;
+            rec.offerCents = offer;
+            rec.round = static_cast<std::uint8_t>(round);
+            rec.tookDeal = deal ? 1 : 0;
+            log->push_back(rec);
+        }
+        if (deal) {
+            res.winningsCents = offer;
+            res.dealRound = static_cast<std::uint8_t>(round);
+            return res;
+        }
+    }
+    res.winningsCents = kCaseValues[cases[0]];
+    return res;
+}
+
+// Simple contestant: takes the deal once the offer reaches a fixed fraction of the EV
+struct ThresholdPolicy {
+    double ratio{0.8};
+
+    template <class Rng>
+    bool take_deal(std::uint32_t openedMask, int, std::uint32_t offerCents, Rng&) {
+        return offerCents >= ratio * expected_value(openedMask);
+    }
+};
+
+// Contestant that plays the risk-averse optimum, evaluated on demand through a shared
+// transposition table. Full games from round 1 touch nearly all 2^26 states, so size the
+// table accordingly or prefer StrategyTablePolicy.
+struct SolverPolicy {
+    TranspositionTable& tt;
+
+    template <class Rng>
+    bool take_deal(std::uint32_t openedMask, int, std::uint32_t, Rng&) {
+        return solve_state(tt, openedMask).takeDeal;
+    }
+};
+
+// Same optimum, read from a precomputed compressed table
+struct StrategyTablePolicy {
+    const StrategyTable& table;
+
+    template <class Rng>
+    bool take_deal(std::uint32_t openedMask, int, std::uint32_t, Rng&) {
+        return table.lookup(openedMask).takeDeal;
+    }
+};
@@ -0,0 +1,110 @@
+// solver.cpp
+// Memoized expectimax over opened-masks. Each reveal is uniformly random among the
+// unopened values (the contestant's own case is unknown, so by symmetry it is just one
+// more unrevealed value). At a banker call the contestant keeps the better of the offer
+// and the certainty equivalent of continuing.
+
+#include "solver.h"
+
+#include <cmath>
+#include <thread>
+
+double solver_utility(double cents) {
+    return std::log1p(cents / kSolverWealthCents);
+}
+
+double solver_certainty_equivalent(double utility) {
+    return std::expm1(utility) * kSolverWealthCents;
+}
+
+namespace {
+
+// Value of a position from its children's values. `childValue(mask)` returns the stored
+// value (in cents) of the position after one more reveal.
+template <class ChildValue>
+Evaluation combine_children(std::uint32_t openedMask, int opened, ChildValue&& childValue) {
+    Evaluation e;
+    // Continue: average utility over every value that could be revealed next.
+    // Children are combined from their stored (rounded) cents so a cache hit and a fresh
+    // evaluation always produce the same answer.
+    double utilSum = 0.0;
+    int n = 0;
+    for (int i = 0; i < kNumCases; i++) {
+        if (openedMask & (1u << i)) continue;
+        utilSum += solver_utility(childValue(openedMask | (1u << i)));
+        ++n;
+    }
+    const double cont = solver_certainty_equivalent(utilSum / n);
+    e.valueCents = static_cast<std::uint32_t>(std::llround(cont));
+
+    // Banker call at this state?
+    const int callRound = offer_round_for_opened(opened);
+    if (callRound > 0) {
+        e.offerCents = banker_offer(openedMask, callRound);
+        if (e.offerCents >= e.valueCents) {
+            e.takeDeal = true;
+            e.valueCents = e.offerCents;
+        }
+    }
+    return e;
+}
+
+// Value of the last unopened case (0 if everything is open)
+std::uint32_t last_case_value(std::uint32_t openedMask) {
+    for (int i = 0; i < kNumCases; i++)
+        if (!(openedMask & (1u << i))) return kCaseValues[static_cast<std::size_t>(i)];
+    return 0;
+}
+
+} // namespace
+
+Evaluation solve_state(TranspositionTable& tt, std::uint32_t openedMask) {
+    const int opened = opened_count(openedMask);
+    const StateKey key{ openedMask, static_cast<std::uint8_t>(rounds_completed(opened)) };
+
+    Evaluation e;
+    // Only the contestant's case is left: its value is known
+    if (opened >= kNumCases - 1) {
+        e.valueCents = last_case_value(openedMask);
+        return e;
+    }
+    if (tt.probe(key, e)) return e;
+
+    e = combine_children(openedMask, opened, [&](std::uint32_t child) {
+        return solve_state(tt, child).valueCents;
+    });
+
+    // Bigger subtrees are more expensive to rebuild, so keep them preferentially
+    tt.store(key, e, static_cast<std::uint16_t>(kNumCases - opened));
+    return e;
+}
+
+void solve_all_states(std::vector<std::uint32_t>& valueCents, std::vector<std::uint8_t>& takeDeal,
+                      unsigned threads) {
+    const std::size_t numStates = std::size_t{1} << kNumCases;
+    valueCents.assign(numStates, 0);
+    takeDeal.assign(numStates, 0);
+    if (threads == 0) threads = 1;
+
+    // Layers by number of opened cases, deepest first: a layer only reads the one below it,
+    // so masks inside a layer can be split across threads freely.
+    for (int opened = kNumCases; opened >= 0; opened--) {
+        auto work = [&, opened](std::size_t begin, std::size_t end) {
+            for (std::size_t m = begin; m < end; m++) {
+                const auto mask = static_cast<std::uint32_t>(m);
+                if (opened_count(mask) != opened) continue;
+                if (opened >= kNumCases - 1) { valueCents[m] = last_case_value(mask); continue; }
+                const Evaluation e = combine_children(mask, opened, [&](std::uint32_t child) {
+                    return valueCents[child];
+                });
+                valueCents[m] = e.valueCents;
+                takeDeal[m] = e.takeDeal;
+            }
+        };
+        std::vector<std::thread> pool;
+        const std::size_t chunk = numStates / threads;
+        for (unsigned t = 1; t < threads; t++) pool.emplace_back(work, chunk * t, t + 1 == threads ? numStates : chunk * (t + 1));
+        work(0, threads == 1 ? numStates : chunk);
+        for (std::thread& th : pool) th.join();
+    }
+}
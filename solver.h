@@ -0,0 +1,29 @@
+// solver.h
+// Deal/no-deal solver for a risk-averse contestant. Positions are valued by their certainty
+// equivalent under log utility, and every evaluated state is memoized in a shared
+// TranspositionTable so concurrent sessions and simulations reuse each other's work.
+
+#pragma once
+
+#include "game.h"
+#include "transposition_table.h"
+
+#include <cstdint>
+#include <vector>
+
+// Contestant wealth used by the utility function, in cents. Smaller means more risk-averse.
+constexpr double kSolverWealthCents = 5000000.0; // $50,000
+
+// Utility of winning `cents` and its inverse
+double solver_utility(double cents);
+double solver_certainty_equivalent(double utility);
+
+// Evaluate a position: value of playing on optimally, the banker offer if a call happens
+// here and whether to take it. The table must hold roughly 2^(cases remaining) entries for
+// the subtree to stay resident; early-game states therefore want a large table.
+Evaluation solve_state(TranspositionTable& tt, std::uint32_t openedMask);
+
+// Solve every one of the 2^26 opened-masks bottom-up (used to build the offline strategy
+// table). Produces exactly the values solve_state would. Needs ~320 MB while running.
+void solve_all_states(std::vector<std::uint32_t>& valueCents, std::vector<std::uint8_t>& takeDeal,
+                      unsigned threads);
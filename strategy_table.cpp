@@ -0,0 +1,164 @@
+// strategy_table.cpp
+// Building, saving and loading the compressed strategy table.
+//
+// File layout (little-endian):
+//   FileHeader | BlockHeader[numBlocks] | packed bit stream (bitBytes bytes)
+
+#include "strategy_table.h"
+
+#include "game.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x53444E44u; // "DNDS"
+constexpr std::uint32_t kVersion = 1;
+
+struct FileHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t numBlocks;
+    std::uint32_t stepsPerOctave;
+    std::uint64_t bitBytes;
+};
+
+// Largest quantized value: log2(1 + $1,000,000 in cents) * steps, with headroom
+constexpr std::uint32_t kMaxQuant = 28u * StrategyTable::kStepsPerOctave;
+// Any 16-bit base plus a 16-bit offset, so a corrupt block cannot index past dequant_
+constexpr std::uint32_t kCodeRange = 1u << 17;
+// BlockHeader::bitOffset is 32 bits wide
+constexpr std::uint64_t kMaxBitBytes = (std::uint64_t{1} << 29) + sizeof(std::uint64_t);
+
+} // namespace
+
+std::uint32_t StrategyTable::quantize(std::uint32_t cents) {
+    const double q = std::log2(1.0 + cents) * kStepsPerOctave;
+    return static_cast<std::uint32_t>(std::lround(q));
+}
+
+std::uint32_t StrategyTable::dequantize(std::uint32_t q) {
+    const double cents = std::exp2(static_cast<double>(q) / kStepsPerOctave) - 1.0;
+    return static_cast<std::uint32_t>(std::llround(cents));
+}
+
+void StrategyTable::build_dequant() {
+    dequant_.resize(kCodeRange >> 1);
+    for (std::uint32_t q = 0; q <= kMaxQuant; q++) dequant_[q] = dequantize(q);
+    std::fill(dequant_.begin() + std::ptrdiff_t{kMaxQuant + 1}, dequant_.end(), dequant_[kMaxQuant]);
+}
+
+StrategyTable StrategyTable::build(const std::vector<std::uint32_t>& valueCents,
+                                   const std::vector<std::uint8_t>& takeDeal) {
+    StrategyTable t;
+    t.build_dequant();
+    const std::size_t blockSize = std::size_t{1} << kBlockShift;
+    const std::size_t numBlocks = (valueCents.size() + blockSize - 1) >> kBlockShift;
+    t.blocks_.resize(numBlocks);
+
+    std::uint64_t bitPos = 0;
+    std::uint32_t codes[std::size_t{1} << kBlockShift];
+    for (std::size_t b = 0; b < numBlocks; b++) {
+        // Encode the block and find its code range
+        std::uint32_t lo = 0xFFFFFFFFu, hi = 0;
+        for (std::size_t i = 0; i < blockSize; i++) {
+            const std::size_t m = (b << kBlockShift) + i;
+            std::uint32_t code = 0;
+            if (m < valueCents.size()) code = (quantize(valueCents[m]) << 1) | (takeDeal[m] ? 1u : 0u);
+            codes[i] = code;
+            if (code < lo) lo = code;
+            if (code > hi) hi = code;
+        }
+        std::uint8_t width = 0;
+        while ((hi - lo) >> width) ++width;
+
+        BlockHeader& h = t.blocks_[b];
+        h.bitOffset = static_cast<std::uint32_t>(bitPos);
+        h.base = static_cast<std::uint16_t>(lo);
+        h.width = width;
+        h.reserved = 0;
+
+        // Append offsets to the stream, least significant bit first
+        t.bits_.resize(static_cast<std::size_t>((bitPos + blockSize * width + 7) >> 3) + sizeof(std::uint64_t), 0);
+        for (std::size_t i = 0; i < blockSize; i++) {
+            const std::uint32_t off = codes[i] - lo;
+            for (std::uint8_t k = 0; k < width; k++, bitPos++)
+                if (off & (1u << k)) t.bits_[static_cast<std::size_t>(bitPos >> 3)] |= static_cast<std::uint8_t>(1u << (bitPos & 7));
+        }
+    }
+    return t;
+}
+
+bool StrategyTable::save(const char* path) const {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) {
+        std::fprintf(stderr, "StrategyTable: cannot write %s\n", path);
+        return false;
+    }
+    const FileHeader fh{ kMagic, kVersion, static_cast<std::uint32_t>(blocks_.size()),
+                         static_cast<std::uint32_t>(kStepsPerOctave), bits_.size() };
+    bool ok = std::fwrite(&fh, sizeof(fh), 1, f) == 1
+           && std::fwrite(blocks_.data(), sizeof(BlockHeader), blocks_.size(), f) == blocks_.size()
+           && std::fwrite(bits_.data(), 1, bits_.size(), f) == bits_.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "StrategyTable: short write to %s\n", path);
+    return ok;
+}
+
+bool StrategyTable::load(const char* path) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::fprintf(stderr, "StrategyTable: cannot open %s\n", path);
+        return false;
+    }
+    FileHeader fh{};
+    if (std::fread(&fh, sizeof(fh), 1, f) != 1 || fh.magic != kMagic || fh.version != kVersion
+        || fh.stepsPerOctave != static_cast<std::uint32_t>(kStepsPerOctave)) {
+        std::fprintf(stderr, "StrategyTable: %s is not a compatible strategy table\n", path);
+        std::fclose(f);
+        return false;
+    }
+    // The counts must describe exactly the rest of the file before anything is allocated
+    long fileSize = -1;
+    if (std::fseek(f, 0, SEEK_END) == 0) fileSize = std::ftell(f);
+    if (fileSize < 0 || std::fseek(f, static_cast<long>(sizeof(fh)), SEEK_SET) != 0) {
+        std::fprintf(stderr, "StrategyTable: cannot size %s\n", path);
+        std::fclose(f);
+        return false;
+    }
+    const std::uint64_t expected = sizeof(fh) + std::uint64_t{fh.numBlocks} * sizeof(BlockHeader) + fh.bitBytes;
+    if (fh.bitBytes > kMaxBitBytes || fh.bitBytes < sizeof(std::uint64_t)
+        || expected != static_cast<std::uint64_t>(fileSize)) {
+        std::fprintf(stderr, "StrategyTable: %s is truncated or corrupt\n", path);
+        std::fclose(f);
+        return false;
+    }
+    if ((std::uint64_t{fh.numBlocks} << kBlockShift) <= kAllCasesMask) {
+        std::fprintf(stderr, "StrategyTable: %s does not cover every opened-mask\n", path);
+        std::fclose(f);
+        return false;
+    }
+    blocks_.resize(fh.numBlocks);
+    bits_.resize(static_cast<std::size_t>(fh.bitBytes));
+    bool ok = std::fread(blocks_.data(), sizeof(BlockHeader), blocks_.size(), f) == blocks_.size()
+           && std::fread(bits_.data(), 1, bits_.size(), f) == bits_.size();
+    std::fclose(f);
+
+    // Every block's codes must lie inside the stream; lookup reads a whole word from the
+    // last one, hence the tail padding
+    const std::uint64_t payloadBits = (fh.bitBytes - sizeof(std::uint64_t)) * 8;
+    for (std::size_t b = 0; ok && b < blocks_.size(); b++) {
+        const BlockHeader& h = blocks_[b];
+        ok = h.width <= 16 && h.bitOffset + (std::uint64_t{h.width} << kBlockShift) <= payloadBits;
+    }
+    if (!ok) {
+        std::fprintf(stderr, "StrategyTable: %s is truncated or corrupt\n", path);
+        blocks_.clear();
+        bits_.clear();
+        return false;
+    }
+    build_dequant();
+    return true;
+}
@@ -0,0 +1,73 @@
+// strategy_table.h
+// Compressed, random-access table of solver results for all 2^26 opened-masks.
+//
+// Values are quantized on a log scale (1/1024 octave, ~0.07% relative error) and combined
+// with the deal bit into a 16-bit code. Codes are grouped into blocks of 64 consecutive
+// masks; each block stores a base code and a bit width, and its codes are bit-packed as
+// offsets from the base. Because neighbouring masks differ only in which cheap cases are
+// open, offsets stay well under the 16-bit code: tools/build_strategy_table measures about
+// 12.2 bits per state, block headers included. A lookup reads one 8-byte block header and
+// one unaligned 8-byte word: O(1) and no branches on the payload.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Decoded table entry
+struct StrategyEntry {
+    std::uint32_t valueCents{0}; // Dequantized certainty-equivalent value
+    bool takeDeal{false};        // Optimal decision if a banker call happens at this state
+};
+
+class StrategyTable {
+public:
+    static constexpr std::uint32_t kBlockShift = 6; // 64 states per block
+    static constexpr int kStepsPerOctave = 1024;
+
+    // Compress solver output; both vectors are indexed by opened-mask
+    static StrategyTable build(const std::vector<std::uint32_t>& valueCents,
+                               const std::vector<std::uint8_t>& takeDeal);
+
+    // Read/write the on-disk format. Return false (and print why) on failure.
+    bool load(const char* path);
+    bool save(const char* path) const;
+
+    bool empty() const { return blocks_.empty(); }
+    std::size_t num_states() const { return blocks_.size() << kBlockShift; }
+    std::size_t bytes() const { return blocks_.size() * sizeof(BlockHeader) + bits_.size(); }
+
+    StrategyEntry lookup(std::uint32_t openedMask) const {
+        const BlockHeader& h = blocks_[openedMask >> kBlockShift];
+        const std::uint64_t bitPos = h.bitOffset + static_cast<std::uint64_t>(openedMask & kBlockMask) * h.width;
+        std::uint64_t word;
+        std::memcpy(&word, bits_.data() + (bitPos >> 3), sizeof(word)); // little-endian stream
+        const auto offset = static_cast<std::uint32_t>((word >> (bitPos & 7)) & ((1ull << h.width) - 1));
+        return decode(h.base + offset);
+    }
+
+    // Log-scale quantization used by the codes (exposed for tools reporting error)
+    static std::uint32_t quantize(std::uint32_t cents);
+    static std::uint32_t dequantize(std::uint32_t q);
+
+private:
+    static constexpr std::uint32_t kBlockMask = (1u << kBlockShift) - 1u;
+
+    struct BlockHeader {
+        std::uint32_t bitOffset; // Start of this block's codes in the bit stream
+        std::uint16_t base;      // Smallest code in the block
+        std::uint8_t width;      // Bits per code offset (0..16)
+        std::uint8_t reserved;
+    };
+
+    StrategyEntry decode(std::uint32_t code) const {
+        return StrategyEntry{ dequant_[code >> 1], (code & 1u) != 0 };
+    }
+    void build_dequant();
+
+    std::vector<BlockHeader> blocks_;
+    std::vector<std::uint8_t> bits_; // Packed offsets plus 8 bytes of tail padding
+    std::vector<std::uint32_t> dequant_; // Code -> cents lookup, built on load/build
+};
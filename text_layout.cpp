@@ -0,0 +1,436 @@
+// text_layout.cpp
+
+#include "text_layout.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+struct LineSpan {
+    std::size_t begin, end;
+    int width;
+    int shaped; // Index into TextLayout::shaped, or -1
+};
+
+void make_key(std::string& key, TTF_Font* font, int maxWidth, TextAlign align, const char* text) {
+    key.assign(reinterpret_cast<const char*>(&font), sizeof font);
+    key.append(reinterpret_cast<const char*>(&maxWidth), sizeof maxWidth);
+    key += static_cast<char>(align);
+    key += text;
+}
+
+int glyph_advance(TTF_Font* font, std::uint32_t c) {
+    int adv = 0;
+    TTF_GlyphMetrics32(font, c, nullptr, nullptr, nullptr, nullptr, &adv);
+    return adv;
+}
+
+// One UTF-8 sequence at `p`, which moves past it. Malformed input decodes as U+FFFD and
+// skips a single byte, so the rest of the string still comes through.
+std::uint32_t next_codepoint(const char*& p) {
+    const auto* s = reinterpret_cast<const unsigned char*>(p);
+    const std::uint32_t b0 = s[0];
+    const int len = b0 < 0x80 ? 1 : (b0 >> 5) == 0x6 ? 2 : (b0 >> 4) == 0xe ? 3 : (b0 >> 3) == 0x1e ? 4 : 0;
+    p++;
+    if (len == 1) return b0;
+    if (len == 0) return 0xfffd;
+    std::uint32_t cp = b0 & (0x7fu >> len);
+    for (int i = 1; i < len; i++) {
+        if ((s[i] & 0xc0) != 0x80) return 0xfffd; // Also stops at the terminator
+        cp = cp << 6 | (s[i] & 0x3fu);
+    }
+    constexpr std::uint32_t kMin[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (cp < kMin[len] || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff)) return 0xfffd;
+    p += len - 1;
+    return cp;
+}
+
+void append_utf8(std::string& s, std::uint32_t cp) {
+    if (cp < 0x80) {
+        s += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        s += static_cast<char>(0xc0 | cp >> 6);
+        s += static_cast<char>(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+        s += static_cast<char>(0xe0 | cp >> 12);
+        s += static_cast<char>(0x80 | (cp >> 6 & 0x3f));
+        s += static_cast<char>(0x80 | (cp & 0x3f));
+    } else {
+        s += static_cast<char>(0xf0 | cp >> 18);
+        s += static_cast<char>(0x80 | (cp >> 12 & 0x3f));
+        s += static_cast<char>(0x80 | (cp >> 6 & 0x3f));
+        s += static_cast<char>(0x80 | (cp & 0x3f));
+    }
+}
+
+// Just enough of Unicode's character properties for the scripts we localize into
+enum : std::uint8_t { kMark = 1, kRtl = 2, kShaper = 4 };
+
+struct ScriptRange {
+    std::uint32_t lo, hi;
+    std::uint8_t flags;
+    const char* script;
+};
+
+constexpr ScriptRange kRanges[] = {
+    { 0x0300, 0x036f, kMark, nullptr },          // Combining diacriticals
+    { 0x0483, 0x0489, kMark, nullptr },          // Cyrillic
+    { 0x0591, 0x05bd, kMark | kRtl, nullptr },   // Hebrew points
+    { 0x05bf, 0x05bf, kMark | kRtl, nullptr },
+    { 0x05c1, 0x05c2, kMark | kRtl, nullptr },
+    { 0x05c4, 0x05c5, kMark | kRtl, nullptr },
+    { 0x05c7, 0x05c7, kMark | kRtl, nullptr },
+    { 0x0590, 0x05ff, kRtl, nullptr },           // Hebrew
+    { 0x0600, 0x06ff, kRtl | kShaper, "Arab" },
+    { 0x0700, 0x074f, kRtl | kShaper, "Syrc" },
+    { 0x0750, 0x077f, kRtl | kShaper, "Arab" },
+    { 0x0780, 0x07bf, kRtl | kShaper, "Thaa" },
+    { 0x07c0, 0x07ff, kRtl | kShaper, "Nkoo" },
+    { 0x08a0, 0x08ff, kRtl | kShaper, "Arab" },
+    { 0x0900, 0x097f, kShaper, "Deva" },
+    { 0x0980, 0x09ff, kShaper, "Beng" },
+    { 0x0a00, 0x0a7f, kShaper, "Guru" },
+    { 0x0a80, 0x0aff, kShaper, "Gujr" },
+    { 0x0b00, 0x0b7f, kShaper, "Orya" },
+    { 0x0b80, 0x0bff, kShaper, "Taml" },
+    { 0x0c00, 0x0c7f, kShaper, "Telu" },
+    { 0x0c80, 0x0cff, kShaper, "Knda" },
+    { 0x0d00, 0x0d7f, kShaper, "Mlym" },
+    { 0x0d80, 0x0dff, kShaper, "Sinh" },
+    { 0x0e31, 0x0e31, kMark, nullptr },          // Thai vowels and tone marks
+    { 0x0e34, 0x0e3a, kMark, nullptr },
+    { 0x0e47, 0x0e4e, kMark, nullptr },
+    { 0x0f00, 0x0fff, kShaper, "Tibt" },
+    { 0x1000, 0x109f, kShaper, "Mymr" },
+    { 0x1780, 0x17ff, kShaper, "Khmr" },
+    { 0x1ab0, 0x1aff, kMark, nullptr },
+    { 0x1dc0, 0x1dff, kMark, nullptr },
+    { 0x20d0, 0x20ff, kMark, nullptr },
+    { 0xfb1d, 0xfb4f, kRtl, nullptr },           // Hebrew presentation forms
+    { 0xfb50, 0xfdff, kRtl, nullptr },           // Arabic presentation forms: already shaped
+    { 0xfe20, 0xfe2f, kMark, nullptr },
+    { 0xfe70, 0xfeff, kRtl, nullptr },
+};
+
+const ScriptRange* script_range(std::uint32_t cp) {
+    if (cp < 0x0300) return nullptr;
+    for (const ScriptRange& r : kRanges)
+        if (cp >= r.lo && cp <= r.hi) return &r;
+    return nullptr;
+}
+
+std::uint8_t char_flags(std::uint32_t cp) {
+    const ScriptRange* r = script_range(cp);
+    return r ? r->flags : 0;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------
+// Layout
+// ---------------------------------------------------------------------------------------
+
+void layout_text(TTF_Font* font, const char* text, int maxWidth, TextAlign align, TextLayout& out) {
+    out.glyphs.clear();
+    out.shaped.clear();
+    out.width = out.height = out.lines = 0;
+    if (!text || !*text) return;
+
+    // Latin-1 advances looked up once per layout, the rest through SDL_ttf's glyph cache
+    int latin[256];
+    std::fill_n(latin, 256, -1);
+    const auto adv_of = [&](std::uint32_t c) {
+        if (c >= 256) return char_flags(c) & kMark ? 0 : glyph_advance(font, c);
+        if (latin[c] < 0) latin[c] = glyph_advance(font, c);
+        return latin[c];
+    };
+
+    const int lineSkip = TTF_FontLineSkip(font);
+    std::vector<LineSpan> spans;
+    std::vector<LaidGlyph>& g = out.glyphs;
+    std::size_t lineStart = 0;
+    std::size_t breakAt = 0; // Last space on this line, +1 (0 = none)
+    int penX = 0, y = 0;
+    std::uint32_t prev = 0;
+
+    // Put right-to-left stretches of [begin, end) in visual order. A stretch runs from one
+    // RTL letter to the last one before something left-to-right, taking spaces and marks
+    // in between along.
+    const auto reorder_rtl = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end;) {
+            if (!(char_flags(g[i].codepoint) & kRtl)) {
+                i++;
+                continue;
+            }
+            std::size_t last = i, j = i + 1;
+            for (; j < end; j++) {
+                const std::uint32_t cp = g[j].codepoint;
+                if (cp != ' ' && !(char_flags(cp) & (kRtl | kMark))) break;
+                if (cp != ' ') last = j;
+            }
+            int left = g[i].x, right = left;
+            for (std::size_t k = i; k <= last; k++) right = std::max(right, g[k].x + adv_of(g[k].codepoint));
+            int baseRight = right;
+            for (std::size_t k = i; k <= last; k++) {
+                const int adv = adv_of(g[k].codepoint);
+                if (char_flags(g[k].codepoint) & kMark) {
+                    g[k].x = baseRight; // Marks follow their base, now to its right
+                } else {
+                    g[k].x = left + right - (g[k].x + adv);
+                    baseRight = g[k].x + adv;
+                }
+            }
+            i = j;
+        }
+    };
+
+    // Trailing spaces take no room. Lines that need the font's shaper trade their
+    // glyphs for the text.
+    const auto finish_line = [&](int penEnd) {
+        while (g.size() > lineStart && g.back().codepoint == ' ') {
+            penEnd = g.back().x;
+            g.pop_back();
+        }
+        const ScriptRange* shaper = nullptr;
+        bool rtl = false;
+        for (std::size_t i = lineStart; i < g.size(); i++) {
+            const ScriptRange* r = script_range(g[i].codepoint);
+            if (r && (r->flags & kShaper) && !shaper) shaper = r;
+            if (r && (r->flags & kRtl)) rtl = true;
+        }
+        if (shaper) {
+            ShapedLine line;
+            for (std::size_t i = lineStart; i < g.size(); i++) append_utf8(line.text, g[i].codepoint);
+            line.y = y;
+            line.rtl = rtl;
+            line.script = shaper->script;
+            TTF_SizeUTF8(font, line.text.c_str(), &line.width, nullptr);
+            g.resize(lineStart);
+            spans.push_back(LineSpan{ lineStart, lineStart, line.width, static_cast<int>(out.shaped.size()) });
+            out.shaped.push_back(std::move(line));
+            penEnd = spans.back().width;
+        } else {
+            if (rtl) reorder_rtl(lineStart, g.size());
+            spans.push_back(LineSpan{ lineStart, g.size(), penEnd, -1 });
+        }
+        out.width = std::max(out.width, penEnd);
+        lineStart = g.size();
+        breakAt = 0;
+        y += lineSkip;
+    };
+
+    for (const char* p = text; *p;) {
+        const std::uint32_t c = next_codepoint(p);
+        if (c == '\n') {
+            finish_line(penX);
+            penX = 0;
+            prev = 0;
+            continue;
+        }
+        if (char_flags(c) & kMark) {
+            // Zero width, after its base; kerning carries on from the base
+            g.push_back(LaidGlyph{ c, penX, y });
+            continue;
+        }
+        const int adv = adv_of(c);
+        int x = penX + (prev ? TTF_GetFontKerningSizeGlyphs32(font, prev, c) : 0);
+        if (maxWidth > 0 && c != ' ' && x + adv > maxWidth && g.size() > lineStart) {
+            if (breakAt) {
+                // Wrap at the last space: the word in progress moves down
+                std::vector<LaidGlyph> word(g.begin() + static_cast<std::ptrdiff_t>(breakAt), g.end());
+                g.resize(breakAt);
+                finish_line(g.back().x);
+                const int shift = word.empty() ? x : word.front().x;
+                for (LaidGlyph w : word) {
+                    w.x -= shift;
+                    w.y = y;
+                    g.push_back(w);
+                }
+                penX -= shift;
+                x -= shift;
+            } else {
+                // A word wider than the line on its own breaks where it overflows
+                finish_line(penX);
+                penX = x = 0;
+            }
+        }
+        if (c == ' ') breakAt = g.size() + 1;
+        g.push_back(LaidGlyph{ c, x, y });
+        penX = x + adv;
+        prev = c;
+    }
+    finish_line(penX);
+
+    for (const LineSpan& s : spans) {
+        const int offset = align == TextAlign::Left ? 0 : align == TextAlign::Center ? (out.width - s.width) / 2 : out.width - s.width;
+        if (s.shaped >= 0) out.shaped[static_cast<std::size_t>(s.shaped)].x = offset;
+        if (offset == 0) continue;
+        for (std::size_t i = s.begin; i < s.end; i++) g[i].x += offset;
+    }
+    out.lines = static_cast<int>(spans.size());
+    out.height = (out.lines - 1) * lineSkip + TTF_FontHeight(font);
+}
+
+// ---------------------------------------------------------------------------------------
+// TextLayoutCache
+// ---------------------------------------------------------------------------------------
+
+const TextLayout& TextLayoutCache::get(TTF_Font* font, const char* text, int maxWidth, TextAlign align) {
+    std::string key;
+    make_key(key, font, maxWidth, align, text ? text : "");
+    auto [it, inserted] = entries_.try_emplace(std::move(key));
+    Entry& e = it->second;
+    e.lastUsed = frame_;
+    if (inserted) {
+        layout_text(font, text, maxWidth, align, e.layout);
+        ++stats_.layouts;
+    } else {
+        ++stats_.hits;
+    }
+    return e.layout;
+}
+
+void TextLayoutCache::end_frame() {
+    ++frame_;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.lastUsed + kEvictFrames < frame_) {
+            it = entries_.erase(it);
+            ++stats_.evicted;
+        } else {
+            ++it;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------
+// GlyphAtlas
+// ---------------------------------------------------------------------------------------
+
+void GlyphAtlas::release() {
+    for (Page& p : pages_)
+        if (p.tex) SDL_DestroyTexture(p.tex);
+    for (auto& [key, line] : lines_)
+        if (line.tex) SDL_DestroyTexture(line.tex);
+    pages_.clear();
+    glyphs_.clear();
+    fontIds_.clear();
+    lines_.clear();
+}
+
+void GlyphAtlas::end_frame() {
+    ++frame_;
+    for (auto it = lines_.begin(); it != lines_.end();) {
+        if (it->second.lastUsed + TextLayoutCache::kEvictFrames < frame_) {
+            if (it->second.tex) SDL_DestroyTexture(it->second.tex);
+            it = lines_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool GlyphAtlas::place(int w, int h, int& page, SDL_Rect& rect) {
+    if (w > kPageSize || h > kPageSize) return false;
+    if (!pages_.empty()) {
+        Page& p = pages_.back();
+        if (p.shelfX + w > kPageSize) {
+            p.shelfY += p.shelfH;
+            p.shelfX = p.shelfH = 0;
+        }
+        if (p.shelfY + h <= kPageSize) {
+            page = static_cast<int>(pages_.size() - 1);
+            rect = SDL_Rect{ p.shelfX, p.shelfY, w, h };
+            p.shelfX += w + 1; // One clear column so filtering never bleeds neighbours in
+            p.shelfH = std::max(p.shelfH, h + 1);
+            return true;
+        }
+    }
+    SDL_Texture* tex = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, kPageSize, kPageSize);
+    if (!tex) return false;
+    SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+    // Static textures start undefined; clear so the gaps between glyphs stay transparent
+    const std::vector<std::uint32_t> clear(static_cast<std::size_t>(kPageSize) * kPageSize, 0);
+    SDL_UpdateTexture(tex, nullptr, clear.data(), kPageSize * 4);
+    pages_.push_back(Page{ tex, w + 1, 0, h + 1 });
+    page = static_cast<int>(pages_.size() - 1);
+    rect = SDL_Rect{ 0, 0, w, h };
+    return true;
+}
+
+const GlyphAtlas::Slot& GlyphAtlas::slot(TTF_Font* font, std::uint32_t codepoint) {
+    const auto idIt = fontIds_.try_emplace(font, static_cast<std::uint32_t>(fontIds_.size())).first;
+    const std::uint64_t key = std::uint64_t{idIt->second} << 32 | codepoint;
+    auto [it, inserted] = glyphs_.try_emplace(key);
+    Slot& s = it->second;
+    if (!inserted || codepoint == ' ') return s;
+
+    SDL_Surface* surf = TTF_RenderGlyph32_Blended(font, codepoint, SDL_Color{ 255, 255, 255, 255 });
+    if (surf && surf->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        SDL_Surface* conv = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surf);
+        surf = conv;
+    }
+    if (!surf) return s;
+    // SDL_ttf widens the bitmap to the left for glyphs that overhang the pen
+    int minX = 0;
+    TTF_GlyphMetrics32(font, codepoint, &minX, nullptr, nullptr, nullptr, nullptr);
+    s.xOffset = std::min(minX, 0);
+    if (place(surf->w, surf->h, s.page, s.rect)) {
+        SDL_LockSurface(surf);
+        SDL_UpdateTexture(pages_[static_cast<std::size_t>(s.page)].tex, &s.rect, surf->pixels, surf->pitch);
+        SDL_UnlockSurface(surf);
+    }
+    SDL_FreeSurface(surf);
+    return s;
+}
+
+const GlyphAtlas::LineTexture& GlyphAtlas::shaped_line(TTF_Font* font, const ShapedLine& line) {
+    std::string key(reinterpret_cast<const char*>(&font), sizeof font);
+    key += line.text;
+    auto [it, inserted] = lines_.try_emplace(std::move(key));
+    LineTexture& lt = it->second;
+    lt.lastUsed = frame_;
+    if (!inserted) return lt;
+
+#if SDL_TTF_VERSION_ATLEAST(2, 20, 0)
+    TTF_SetFontDirection(font, line.rtl ? TTF_DIRECTION_RTL : TTF_DIRECTION_LTR);
+    TTF_SetFontScriptName(font, line.script);
+#endif
+    SDL_Surface* surf = TTF_RenderUTF8_Blended(font, line.text.c_str(), SDL_Color{ 255, 255, 255, 255 });
+#if SDL_TTF_VERSION_ATLEAST(2, 20, 0)
+    // Back to SDL_ttf's defaults: left to right, script guessed from the text
+    TTF_SetFontDirection(font, TTF_DIRECTION_LTR);
+    TTF_SetFontScriptName(font, "Zzzz");
+#endif
+    if (!surf) return lt;
+    lt.tex = SDL_CreateTextureFromSurface(renderer_, surf);
+    lt.w = surf->w;
+    lt.h = surf->h;
+    if (lt.tex) SDL_SetTextureBlendMode(lt.tex, SDL_BLENDMODE_BLEND);
+    SDL_FreeSurface(surf);
+    return lt;
+}
+
+void GlyphAtlas::draw(TTF_Font* font, const TextLayout& run, int x, int y, SDL_Color color) {
+    for (Page& p : pages_) SDL_SetTextureColorMod(p.tex, color.r, color.g, color.b);
+    std::size_t pagesBefore = pages_.size();
+    for (const LaidGlyph& lg : run.glyphs) {
+        const Slot& s = slot(font, lg.codepoint);
+        if (s.page < 0) continue;
+        // A page added mid-run needs the color too
+        if (pages_.size() != pagesBefore) {
+            for (std::size_t i = pagesBefore; i < pages_.size(); i++) SDL_SetTextureColorMod(pages_[i].tex, color.r, color.g, color.b);
+            pagesBefore = pages_.size();
+        }
+        const SDL_Rect dst{ x + lg.x + s.xOffset, y + lg.y, s.rect.w, s.rect.h };
+        SDL_RenderCopy(renderer_, pages_[static_cast<std::size_t>(s.page)].tex, &s.rect, &dst);
+    }
+    for (const ShapedLine& line : run.shaped) {
+        const LineTexture& lt = shaped_line(font, line);
+        if (!lt.tex) continue;
+        SDL_SetTextureColorMod(lt.tex, color.r, color.g, color.b);
+        const SDL_Rect dst{ x + line.x, y + line.y, lt.w, lt.h };
+        SDL_RenderCopy(renderer_, lt.tex, nullptr, &dst);
+    }
+}
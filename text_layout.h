@@ -0,0 +1,141 @@
+// text_layout.h
+// Multi-line text: banker dialogs, the rules screen, host prompts. Laying out a
+// paragraph means one metrics lookup and one kerning lookup per glyph, then line
+// breaking and alignment. Those results only change when the text, the font or the
+// width changes, so TextLayoutCache keeps each finished glyph run and hands the same one
+// back every frame. It is CPU-only and shared by all renderers.
+//
+// Runs are drawn from a GlyphAtlas: one per renderer, holding each glyph once on a
+// shared texture page. A paragraph then costs one SDL_RenderCopy per glyph and no
+// rasterizing at all once its glyphs are in the atlas.
+//
+// Line breaking is greedy: break at the last space that fits, at '\n', or inside a word
+// that is wider than the line on its own.
+//
+// Text is UTF-8, shaped once when the run is laid out:
+//   - combining marks take no room and sit after their base, never split from it
+//   - right-to-left stretches (Hebrew, Arabic) are put in visual order within the line
+//   - lines in scripts whose letters change shape with their neighbours (Arabic,
+//     Indic, Myanmar, Khmer, Tibetan) cannot be drawn glyph by glyph. Those lines are
+//     kept as text, rasterized whole by SDL_ttf's own shaper (HarfBuzz, where SDL_ttf
+//     has it) and cached in the atlas as one bitmap per line.
+// Either way a localized show pays for shaping once per string, not once per frame.
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class TextAlign : std::uint8_t { Left, Center, Right };
+
+struct LaidGlyph {
+    std::uint32_t codepoint{0};
+    int x{0}; // Pen position in the run, relative to its top-left
+    int y{0}; // Top of the glyph's line
+};
+
+// A line left for the font's shaper
+struct ShapedLine {
+    std::string text;            // UTF-8, logical order
+    int x{0}, y{0};
+    int width{0};
+    bool rtl{false};             // Direction for the shaper
+    const char* script{nullptr}; // ISO 15924 tag, e.g. "Arab"
+};
+
+struct TextLayout {
+    std::vector<LaidGlyph> glyphs;  // Spaces at line ends are dropped
+    std::vector<ShapedLine> shaped; // Lines with no entries in `glyphs`
+    int width{0};                   // Widest line
+    int height{0};
+    int lines{0};
+};
+
+// Lay out `text` (UTF-8) in `font`, wrapped to `maxWidth` (0 = no wrapping)
+void layout_text(TTF_Font* font, const char* text, int maxWidth, TextAlign align, TextLayout& out);
+
+struct TextLayoutStats {
+    std::uint64_t hits{0};
+    std::uint64_t layouts{0};
+    std::uint64_t evicted{0};
+};
+
+class TextLayoutCache {
+public:
+    static constexpr std::uint64_t kEvictFrames = 300;
+
+    // The run for these arguments, laid out on first use
+    const TextLayout& get(TTF_Font* font, const char* text, int maxWidth, TextAlign align);
+
+    // Advance the frame counter and drop runs unused for kEvictFrames
+    void end_frame();
+
+    const TextLayoutStats& stats() const { return stats_; }
+
+private:
+    struct Entry {
+        TextLayout layout;
+        std::uint64_t lastUsed{0};
+    };
+
+    std::unordered_map<std::string, Entry> entries_;
+    std::uint64_t frame_{0};
+    TextLayoutStats stats_;
+};
+
+// Glyphs of any font on shared texture pages, for one renderer
+class GlyphAtlas {
+public:
+    static constexpr int kPageSize = 512;
+
+    explicit GlyphAtlas(SDL_Renderer* renderer) : renderer_(renderer) {}
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+    ~GlyphAtlas() { release(); }
+
+    // Draw a laid-out run with its top-left at (x, y)
+    void draw(TTF_Font* font, const TextLayout& run, int x, int y, SDL_Color color);
+
+    // Drop shaped lines not drawn for TextLayoutCache::kEvictFrames. Glyphs stay: a
+    // font's character set is bounded, a show's sentences are not.
+    void end_frame();
+
+    // Destroy the pages. Must be called before the renderer goes away.
+    void release();
+
+    std::size_t glyph_count() const { return glyphs_.size(); }
+    std::size_t page_count() const { return pages_.size(); }
+    std::size_t shaped_line_count() const { return lines_.size(); }
+
+private:
+    struct Slot {
+        int page{-1};   // -1: nothing to draw (space, or SDL_ttf could not render it)
+        SDL_Rect rect{};
+        int xOffset{0}; // Where the glyph's bitmap starts relative to the pen
+    };
+    struct Page {
+        SDL_Texture* tex{nullptr};
+        int shelfX{0}, shelfY{0}, shelfH{0}; // Shelf packing cursor
+    };
+
+    struct LineTexture {
+        SDL_Texture* tex{nullptr};
+        int w{0}, h{0};
+        std::uint64_t lastUsed{0};
+    };
+
+    const Slot& slot(TTF_Font* font, std::uint32_t codepoint);
+    bool place(int w, int h, int& page, SDL_Rect& rect);
+    const LineTexture& shaped_line(TTF_Font* font, const ShapedLine& line);
+
+    SDL_Renderer* renderer_;
+    std::vector<Page> pages_;
+    std::unordered_map<std::uint64_t, Slot> glyphs_; // Keyed by font id and codepoint
+    std::unordered_map<const TTF_Font*, std::uint32_t> fontIds_;
+    std::unordered_map<std::string, LineTexture> lines_; // Keyed by font and text
+    std::uint64_t frame_{0};
+};
@@ -0,0 +1,167 @@
+// timer_wheel.cpp
+// Timer placement: a timer `delta` ticks away goes to the lowest level whose span covers
+// it, in the slot selected by that level's bits of its due tick. When level 0 wraps, the
+// matching slot of the next level is re-distributed ("cascaded") into the levels below,
+// so every timer reaches level 0 exactly at its due tick.
+
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+TimerId make_id(std::int32_t index, std::uint32_t generation) {
+    return (static_cast<TimerId>(generation) << 32) | static_cast<std::uint32_t>(index);
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(std::uint64_t startTick) : now_(startTick) {
+    heads_.fill(kNil);
+}
+
+std::int32_t TimerWheel::alloc_node() {
+    if (!freeList_.empty()) {
+        const std::int32_t n = freeList_.back();
+        freeList_.pop_back();
+        return n;
+    }
+    nodes_.emplace_back();
+    return static_cast<std::int32_t>(nodes_.size() - 1);
+}
+
+void TimerWheel::link(std::int32_t n) {
+    Node& node = nodes_[static_cast<std::size_t>(n)];
+    const std::uint64_t delta = node.due > now_ ? node.due - now_ : 0;
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (std::uint64_t{1} << (kSlotBits * (level + 1)))) ++level;
+    // Beyond the top level's span: park in the farthest top-level slot; it is cascaded
+    // (and re-parked if still too far) each time the top level comes round.
+    const std::uint64_t span = std::uint64_t{1} << (kSlotBits * kLevels);
+    const std::uint64_t placeAt = delta >= span ? now_ + span - 1 : node.due;
+    const auto slot = static_cast<std::uint32_t>((placeAt >> (kSlotBits * level)) & (kSlots - 1));
+
+    const std::int32_t gslot = static_cast<std::int32_t>(static_cast<std::uint32_t>(level) * kSlots + slot);
+    std::int32_t& head = heads_[static_cast<std::size_t>(gslot)];
+    node.slot = gslot;
+    node.prev = kNil;
+    node.next = head;
+    if (head != kNil) nodes_[static_cast<std::size_t>(head)].prev = n;
+    head = n;
+    if (level == 0) level0Used_[slot / 64] |= std::uint64_t{1} << (slot % 64);
+}
+
+void TimerWheel::unlink(std::int32_t n) {
+    Node& node = nodes_[static_cast<std::size_t>(n)];
+    if (node.prev != kNil) nodes_[static_cast<std::size_t>(node.prev)].next = node.next;
+    else heads_[static_cast<std::size_t>(node.slot)] = node.next;
+    if (node.next != kNil) nodes_[static_cast<std::size_t>(node.next)].prev = node.prev;
+    const auto slot = static_cast<std::uint32_t>(node.slot);
+    if (slot < kSlots && heads_[slot] == kNil) level0Used_[slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+    node.prev = node.next = kNil;
+    node.slot = kNil;
+}
+
+TimerId TimerWheel::schedule_in(std::uint64_t delay, std::uint32_t kind, std::uint64_t payload) {
+    return schedule_at(now_ + delay, kind, payload);
+}
+
+TimerId TimerWheel::schedule_at(std::uint64_t dueTick, std::uint32_t kind, std::uint64_t payload) {
+    const std::int32_t n = alloc_node();
+    Node& node = nodes_[static_cast<std::size_t>(n)];
+    node.due = dueTick < now_ ? now_ : dueTick;
+    node.kind = kind;
+    node.payload = payload;
+    link(n);
+    ++active_;
+    return make_id(n, node.generation);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    const auto index = static_cast<std::uint32_t>(id);
+    const auto generation = static_cast<std::uint32_t>(id >> 32);
+    if (index >= nodes_.size()) return false;
+    Node& node = nodes_[index];
+    if (node.generation != generation || node.slot == kNil) return false;
+    unlink(static_cast<std::int32_t>(index));
+    ++node.generation; // Invalidate outstanding handles
+    freeList_.push_back(static_cast<std::int32_t>(index));
+    --active_;
+    return true;
+}
+
+void TimerWheel::cascade(int level, std::uint32_t slot) {
+    // Detach the whole list first: re-linking may put timers back into this same slot
+    const std::size_t gslot = static_cast<std::size_t>(level) * kSlots + slot;
+    std::int32_t n = heads_[gslot];
+    heads_[gslot] = kNil;
+    while (n != kNil) {
+        const std::int32_t next = nodes_[static_cast<std::size_t>(n)].next;
+        link(n);
+        n = next;
+    }
+}
+
+std::size_t TimerWheel::advance(std::uint64_t tick, std::vector<TimerEvent>& out) {
+    const std::size_t before = out.size();
+    while (now_ <= tick) {
+        // Nothing scheduled: jump straight to the target
+        if (active_ == 0) { now_ = tick + 1; break; }
+
+        // Level 0 wrapped: pull the next chunk of each higher level down
+        if ((now_ & (kSlots - 1)) == 0) {
+            for (int level = 1; level < kLevels; level++) {
+                const auto slot = static_cast<std::uint32_t>((now_ >> (kSlotBits * level)) & (kSlots - 1));
+                cascade(level, slot);
+                if (slot != 0) break;
+            }
+        }
+
+        // Skip empty level-0 slots up to the next timer or wrap
+        if (const std::uint64_t gap = level0_gap()) {
+            now_ = std::min(now_ + gap, tick + 1);
+            continue;
+        }
+
+        // Fire the current level-0 slot: everything linked here is due at this tick
+        const auto slot = static_cast<std::size_t>(now_ & (kSlots - 1));
+        std::int32_t n = heads_[slot];
+        while (n != kNil) {
+            Node& node = nodes_[static_cast<std::size_t>(n)];
+            const std::int32_t next = node.next;
+            if (node.due <= now_) {
+                out.push_back(TimerEvent{ make_id(n, node.generation), node.kind, node.payload, node.due });
+                unlink(n);
+                ++node.generation;
+                freeList_.push_back(n);
+                --active_;
+            }
+            n = next;
+        }
+        ++now_;
+    }
+    return out.size() - before;
+}
+
+// Ticks from now_ to the next non-empty level-0 slot, or to the next wrap if that comes
+// first (past it, level-0 slots are stale until the cascade)
+std::uint64_t TimerWheel::level0_gap() const {
+    const auto cur = static_cast<std::uint32_t>(now_ & (kSlots - 1));
+    for (std::uint32_t w = cur / 64; w < kSlots / 64; w++) {
+        std::uint64_t bits = level0Used_[w];
+        if (w == cur / 64) bits &= ~std::uint64_t{0} << (cur % 64);
+        if (bits) return w * 64 + static_cast<std::uint32_t>(std::countr_zero(bits)) - cur;
+    }
+    return kSlots - cur;
+}
+
+std::uint64_t TimerWheel::ticks_until_next(std::uint64_t limit) const {
+    if (active_ == 0) return limit;
+    // At a wrap the coming block's timers are still in the upper levels until advance()
+    // cascades them, so the wrap itself is the next thing to process
+    if ((now_ & (kSlots - 1)) == 0) return 0;
+    const std::uint64_t gap = level0_gap();
+    return gap < limit ? gap : limit;
+}
@@ -0,0 +1,81 @@
+// timer_wheel.h
+// Hierarchical timing wheel for session timers (decision countdowns, idle timeouts, banker
+// ring delays). Four levels of 256 slots cover 2^32 ticks; insert and cancel are O(1)
+// (intrusive lists over a node pool) and expiry is processed in batches: advance() hands
+// back every timer due up to a tick so the caller dispatches them in one pass.
+//
+// Time is measured in caller-defined ticks (the client uses its fixed update step, the
+// server its loop tick). Not thread-safe: each wheel belongs to one loop thread.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Handle to a scheduled timer. Stale handles (timer already fired or cancelled) are
+// detected through a generation counter, so cancelling them is harmless.
+using TimerId = std::uint64_t;
+constexpr TimerId kInvalidTimer = 0;
+
+struct TimerEvent {
+    TimerId id{kInvalidTimer};
+    std::uint32_t kind{0};    // Caller-defined timer type
+    std::uint64_t payload{0}; // Caller-defined data (session id, ...)
+    std::uint64_t dueTick{0};
+};
+
+class TimerWheel {
+public:
+    explicit TimerWheel(std::uint64_t startTick = 0);
+
+    // Schedule a timer `delay` ticks from the current tick (0 = fire on the next advance)
+    TimerId schedule_in(std::uint64_t delay, std::uint32_t kind, std::uint64_t payload);
+
+    // Schedule at an absolute tick; ticks already passed fire on the next advance
+    TimerId schedule_at(std::uint64_t dueTick, std::uint32_t kind, std::uint64_t payload);
+
+    // Returns false if the timer already fired, was cancelled or never existed
+    bool cancel(TimerId id);
+
+    // Process every tick up to and including `tick`, appending expired timers to `out`
+    // in due order. Returns the number appended.
+    std::size_t advance(std::uint64_t tick, std::vector<TimerEvent>& out);
+
+    // Ticks until the next timer within the level-0 horizon (<= 256 ticks), or `limit`
+    // if none is due sooner; 0 at a level-0 wrap, which has to be processed before the
+    // next block's timers are known. Lets an event loop sleep instead of spinning, and
+    // process timers one due tick at a time.
+    std::uint64_t ticks_until_next(std::uint64_t limit) const;
+
+    std::uint64_t now() const { return now_; }
+    std::size_t size() const { return active_; }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr std::uint32_t kSlots = 1u << kSlotBits;
+    static constexpr std::int32_t kNil = -1;
+
+    struct Node {
+        std::uint64_t due{0};
+        std::uint64_t payload{0};
+        std::uint32_t kind{0};
+        std::uint32_t generation{1};
+        std::int32_t prev{kNil}, next{kNil};
+        std::int32_t slot{kNil}; // Global slot index (level * kSlots + slot), kNil when free
+    };
+
+    std::int32_t alloc_node();
+    void link(std::int32_t n);
+    void unlink(std::int32_t n);
+    void cascade(int level, std::uint32_t slot);
+    std::uint64_t level0_gap() const;
+
+    std::vector<Node> nodes_;
+    std::vector<std::int32_t> freeList_;
+    std::array<std::int32_t, kLevels * kSlots> heads_;
+    std::array<std::uint64_t, kSlots / 64> level0Used_{}; // Bit per non-empty level-0 slot
+    std::uint64_t now_; // Next tick to be processed
+    std::size_t active_{0};
+};
@@ -0,0 +1,121 @@
+// tools/art_convert.cpp
+// Prepares artwork for the game: converts .ppm / .pam / .qoi / .dart into a compact .qoi
+// for distribution or a .dart pre-converted to the target renderer's pixel layout, and
+// measures how fast each loads.
+//
+// Usage: art_convert IN OUT.qoi
+//        art_convert IN OUT.dart [--layout argb8888|abgr8888|rgba8888|bgra8888]
+//        art_convert --bench IN [--layout L]
+//
+// --flatten RRGGBB composites the art over that solid color (gamma-correct, in linear
+// light) and stores it opaque. Use it for art that always sits on the same backdrop: an
+// opaque texture draws without blending and looks the same as the blended original.
+//
+// The layout for .dart should be the one the kiosk's render driver reports first
+// (printed by the game at startup); argb8888 suits the opengl and software drivers.
+
+#include "color_math.h"
+#include "image_codec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool ends_with(const char* s, const char* suffix) {
+    const std::size_t n = std::strlen(s), m = std::strlen(suffix);
+    return n >= m && !std::strcmp(s + n - m, suffix);
+}
+
+double ms(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// Time decoding `in` as QOI and loading it as .dart, best of several runs
+int bench(const char* path, PixelLayout layout) {
+    Image img;
+    if (!load_image(path, layout, img)) return 1;
+    std::vector<std::uint8_t> qoi, dart;
+    qoi_encode(img, qoi);
+    art_encode(img, dart);
+
+    constexpr int kRuns = 20;
+    double qoiBest = 1e30, dartBest = 1e30;
+    Image out;
+    for (int i = 0; i < kRuns; i++) {
+        auto t = Clock::now();
+        if (!qoi_decode(qoi.data(), qoi.size(), layout, out)) return 1;
+        qoiBest = std::min(qoiBest, ms(t));
+        if (out.pixels != img.pixels) {
+            std::fprintf(stderr, "QOI round trip mismatch\n");
+            return 1;
+        }
+        t = Clock::now();
+        ArtHeader h;
+        const std::uint32_t* px = nullptr;
+        if (!art_parse(dart.data(), dart.size(), h, px)) return 1;
+        out.pixels.assign(px, px + img.pixels.size()); // Stands in for the texture upload copy
+        dartBest = std::min(dartBest, ms(t));
+    }
+    const double mpx = static_cast<double>(img.pixels.size()) / 1e6;
+    std::printf("%s: %dx%d\n", path, img.width, img.height);
+    std::printf("  qoi   %9zu bytes (%5.1f%%)  decode %7.3f ms  %7.1f Mpx/s\n", qoi.size(),
+                100.0 * static_cast<double>(qoi.size()) / static_cast<double>(dart.size()), qoiBest, mpx / qoiBest * 1e3);
+    std::printf("  dart  %9zu bytes           copy   %7.3f ms  %7.1f Mpx/s\n", dart.size(), dartBest,
+                mpx / dartBest * 1e3);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* in = nullptr;
+    const char* out = nullptr;
+    bool benchMode = false;
+    PixelLayout layout = PixelLayout::ARGB8888;
+    const char* flatten = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--bench")) benchMode = true;
+        else if (!std::strcmp(argv[i], "--layout") && i + 1 < argc) {
+            if (!parse_pixel_layout(argv[++i], layout)) {
+                std::fprintf(stderr, "unknown layout %s\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (!std::strcmp(argv[i], "--flatten") && i + 1 < argc) flatten = argv[++i];
+        else if (!in) in = argv[i];
+        else if (!out) out = argv[i];
+        else in = nullptr;
+    }
+    if (!in || (!benchMode && (!out || !(ends_with(out, ".qoi") || ends_with(out, ".dart"))))) {
+        std::fprintf(stderr, "usage: %s IN OUT.qoi\n"
+                             "       %s IN OUT.dart [--layout argb8888|abgr8888|rgba8888|bgra8888]\n"
+                             "       (either form: [--flatten RRGGBB])\n"
+                             "       %s --bench IN [--layout L]\n", argv[0], argv[0], argv[0]);
+        return 2;
+    }
+    if (benchMode) return bench(in, layout);
+
+    Image img;
+    if (!load_image(in, layout, img)) return 1;
+    if (flatten) {
+        const unsigned long rgb = std::strtoul(flatten, nullptr, 16);
+        std::vector<std::uint32_t> backdrop(img.pixels.size(), pack_pixel(layout, (rgb >> 16) & 0xffu, (rgb >> 8) & 0xffu,
+                                                                          rgb & 0xffu, 255));
+        blend_over_srgb(backdrop.data(), img.pixels.data(), img.pixels.size(), layout);
+        img.pixels.swap(backdrop);
+    }
+    std::vector<std::uint8_t> bytes;
+    if (ends_with(out, ".qoi")) qoi_encode(img, bytes);
+    else art_encode(img, bytes);
+    if (!write_file(out, bytes)) return 1;
+    std::printf("%s -> %s: %dx%d, %zu bytes%s%s\n", in, out, img.width, img.height, bytes.size(),
+                ends_with(out, ".dart") ? ", " : "", ends_with(out, ".dart") ? pixel_layout_name(layout) : "");
+    return 0;
+}
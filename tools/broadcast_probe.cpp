@@ -0,0 +1,202 @@
+// tools/broadcast_probe.cpp
+// Reads the game's shared-memory broadcast export the way the graphics truck would.
+//
+//   broadcast_probe [--name N] [--seconds S]            watch a running game: print each
+//                                                       show step and frame rate
+//   broadcast_probe --synthetic [--width W --height H]  stress the export: a child process
+//                                                       publishes state at 1 kHz and frames
+//                                                       at 60 fps while this process reads
+//                                                       flat out and checks every frame;
+//                                                       fails unless most frames were checked
+//
+// Synthetic frames are filled with their frame number, so a reader that sees a mixed frame
+// while still_valid() says it was intact has caught a real tear.
+
+#include "broadcast_export.h"
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Returns the child's exit status; the exporter goes out of scope first, so the segment
+// is unlinked before the child calls _exit
+int run_synthetic_writer(const char* name, int width, int height, double seconds) {
+    BroadcastExport out;
+    if (!out.open(name, width, height)) return 1;
+    ShowState st;
+    const auto t0 = Clock::now();
+    auto nextFrame = t0;
+    std::uint64_t tick = 0;
+    while (Clock::now() - t0 < std::chrono::duration<double>(seconds)) {
+        ++tick;
+        st.offerCents = static_cast<std::uint32_t>(tick);
+        st.winningsCents = static_cast<std::uint32_t>(~tick); // Readers check the pair matches
+        st.stepStartTick = tick;
+        out.publish_state(st, tick);
+        if (Clock::now() >= nextFrame) {
+            nextFrame += std::chrono::microseconds(16667);
+            const ExportFrame f = out.begin_frame(width, height);
+            const auto v = static_cast<std::uint32_t>(tick);
+            for (int y = 0; y < f.height; y++) {
+                auto* row = reinterpret_cast<std::uint32_t*>(f.pixels + static_cast<std::ptrdiff_t>(y) * f.pitch);
+                for (int x = 0; x < f.width; x++) row[x] = v;
+            }
+            out.end_frame(tick);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(1000));
+    }
+    return 0;
+}
+
+bool attach_retrying(BroadcastReader& in, const char* name, double seconds) {
+    const auto until = Clock::now() + std::chrono::duration<double>(seconds);
+    while (!in.attach(name)) {
+        if (Clock::now() > until) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+int synthetic(const char* name, int width, int height, double seconds) {
+    // A segment left by an earlier run would let the reader attach before the child
+    // has created its own
+    ::shm_unlink(name);
+    const pid_t child = ::fork();
+    if (child < 0) {
+        std::perror("fork");
+        return 1;
+    }
+    if (child == 0) _exit(run_synthetic_writer(name, width, height, seconds));
+
+    BroadcastReader in;
+    if (!attach_retrying(in, name, 2.0)) {
+        std::fprintf(stderr, "broadcast_probe: export %s did not appear\n", name);
+        ::kill(child, SIGKILL);
+        ::waitpid(child, nullptr, 0);
+        ::shm_unlink(name);
+        return 1;
+    }
+
+    std::uint64_t stateReads = 0, badStates = 0, frames = 0, skipped = 0, torn = 0, lapped = 0;
+    std::uint64_t lastFrame = 0;
+    const auto t0 = Clock::now();
+    while (Clock::now() - t0 < std::chrono::duration<double>(seconds)) {
+        ExportState s;
+        if (in.read_state(s)) {
+            ++stateReads;
+            if (s.winningsCents != static_cast<std::uint32_t>(~s.offerCents) || s.stepStartTick != s.tick) ++badStates;
+        }
+        ExportFrameView f;
+        if (!in.acquire_frame(f) || f.frame == lastFrame) continue;
+        // Check every pixel in place, then whether the writer got there first
+        const auto expect = static_cast<std::uint32_t>(f.tick);
+        bool mixed = false;
+        for (int y = 0; y < f.height && !mixed; y++) {
+            const auto* row = reinterpret_cast<const std::uint32_t*>(f.pixels + static_cast<std::ptrdiff_t>(y) * f.pitch);
+            for (int x = 0; x < f.width; x++)
+                if (row[x] != expect) { mixed = true; break; }
+        }
+        if (!in.still_valid(f)) ++lapped;   // Discarded, as a real consumer would
+        else if (mixed) ++torn;             // Must never happen
+        else ++frames;
+        if (lastFrame && f.frame > lastFrame + 1) skipped += f.frame - lastFrame - 1;
+        lastFrame = f.frame;
+    }
+    int status = 0;
+    const bool childOk = ::waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    ::shm_unlink(name); // In case the child died before its exporter could
+
+    const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+    std::printf("state: %.2f M reads/s, %llu inconsistent, %llu retries\n",
+                static_cast<double>(stateReads) / secs / 1e6, static_cast<unsigned long long>(badStates),
+                static_cast<unsigned long long>(in.retries()));
+    std::printf("frames %dx%d: %llu checked intact, %llu skipped, %llu lapped by the writer, %llu torn\n",
+                width, height, static_cast<unsigned long long>(frames), static_cast<unsigned long long>(skipped),
+                static_cast<unsigned long long>(lapped), static_cast<unsigned long long>(torn));
+
+    // The writer publishes at 60 fps; seeing under a quarter of that means the reader
+    // barely looked, which proves nothing
+    const auto minFrames = static_cast<std::uint64_t>(seconds * 60.0 / 4.0);
+    bool ok = !badStates && !torn;
+    if (!childOk) {
+        std::fprintf(stderr, "broadcast_probe: writer process failed (status %d)\n", status);
+        ok = false;
+    }
+    if (!stateReads || frames < minFrames) {
+        std::fprintf(stderr, "broadcast_probe: too little checked (%llu state reads, %llu frames, want %llu)\n",
+                     static_cast<unsigned long long>(stateReads), static_cast<unsigned long long>(frames),
+                     static_cast<unsigned long long>(minFrames));
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
+
+int watch(const char* name, double seconds) {
+    BroadcastReader in;
+    if (!attach_retrying(in, name, seconds)) {
+        std::fprintf(stderr, "broadcast_probe: no export named %s (start the game with --export)\n", name);
+        return 1;
+    }
+    const ExportHeader* h = in.header();
+    if (h->maxWidth) std::printf("frames exported, up to %ux%u\n", h->maxWidth, h->maxHeight);
+    else std::printf("state only\n");
+
+    int lastStep = -1;
+    std::uint64_t lastFrame = 0, framesSeen = 0;
+    auto lastReport = Clock::now();
+    const auto t0 = lastReport;
+    while (Clock::now() - t0 < std::chrono::duration<double>(seconds)) {
+        ExportState s;
+        if (in.read_state(s) && s.step != lastStep) {
+            lastStep = s.step;
+            std::printf("tick %8llu  step %u  round %u  to open %u  offer %u.%02u  winnings %u.%02u\n",
+                        static_cast<unsigned long long>(s.tick), s.step, s.round, s.toOpen, s.offerCents / 100,
+                        s.offerCents % 100, s.winningsCents / 100, s.winningsCents % 100);
+        }
+        ExportFrameView f;
+        if (in.acquire_frame(f) && f.frame != lastFrame) {
+            lastFrame = f.frame;
+            ++framesSeen;
+        }
+        if (Clock::now() - lastReport >= std::chrono::seconds(1)) {
+            if (h->maxWidth) std::printf("  %llu frames/s\n", static_cast<unsigned long long>(framesSeen));
+            framesSeen = 0;
+            lastReport = Clock::now();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* name = "/dond-broadcast";
+    double seconds = 3.0;
+    int width = 1280, height = 720;
+    bool synth = false;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--name") && hasValue) name = argv[++i];
+        else if (!std::strcmp(argv[i], "--seconds") && hasValue) seconds = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--width") && hasValue) width = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--height") && hasValue) height = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--synthetic")) synth = true;
+        else {
+            std::fprintf(stderr, "usage: %s [--name N] [--seconds S] [--synthetic [--width W] [--height H]]\n", argv[0]);
+            return 2;
+        }
+    }
+    return synth ? synthetic(name, width, height, seconds) : watch(name, seconds);
+}
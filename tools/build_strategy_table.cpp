@@ -0,0 +1,73 @@
+// tools/build_strategy_table.cpp
+// Offline builder for the compressed strategy table. Solves all 2^26 opened-masks, packs
+// them with StrategyTable, writes the file and reports size, quantization error and
+// random-access decode speed.
+//
+// Usage: build_strategy_table [output=strategy.dnds] [threads=hardware]
+
+#include "solver.h"
+#include "strategy_table.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const char* outPath = argc > 1 ? argv[1] : "strategy.dnds";
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10))
+                                : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::duration d) { return std::chrono::duration<double>(d).count(); };
+
+    // Solve every state
+    std::vector<std::uint32_t> values;
+    std::vector<std::uint8_t> deals;
+    auto t0 = Clock::now();
+    solve_all_states(values, deals, threads);
+    auto t1 = Clock::now();
+    std::printf("solved %zu states in %.2f s (%u threads)\n", values.size(), seconds(t1 - t0), threads);
+
+    // Compress and save
+    StrategyTable table = StrategyTable::build(values, deals);
+    auto t2 = Clock::now();
+    const double rawMiB = static_cast<double>(values.size() * (sizeof(std::uint32_t) + 1)) / (1024.0 * 1024.0);
+    const double packedMiB = static_cast<double>(table.bytes()) / (1024.0 * 1024.0);
+    std::printf("compressed in %.2f s: %.1f MiB -> %.1f MiB (%.2f bits/state)\n",
+                seconds(t2 - t1), rawMiB, packedMiB,
+                static_cast<double>(table.bytes()) * 8.0 / static_cast<double>(values.size()));
+    if (!table.save(outPath)) return 1;
+
+    // Verify every entry and measure quantization error
+    double maxRelErr = 0.0;
+    std::size_t dealMismatches = 0;
+    for (std::size_t m = 0; m < values.size(); m++) {
+        const StrategyEntry e = table.lookup(static_cast<std::uint32_t>(m));
+        if (e.takeDeal != (deals[m] != 0)) ++dealMismatches;
+        if (values[m] >= 100) { // ignore sub-dollar values where one cent dominates
+            const double err = std::abs(static_cast<double>(e.valueCents) - values[m]) / values[m];
+            if (err > maxRelErr) maxRelErr = err;
+        }
+    }
+    std::printf("verify: max relative error %.4f%%, deal mismatches %zu\n", maxRelErr * 100.0, dealMismatches);
+
+    // Random-access decode speed: independent lookups (throughput) and a dependent chain
+    // (latency, each address depends on the previous result so misses can't overlap)
+    std::mt19937 rng{12345};
+    std::vector<std::uint32_t> probes(1u << 22);
+    for (std::uint32_t& p : probes) p = rng() & kAllCasesMask;
+    std::uint32_t sink = 0;
+    auto t3 = Clock::now();
+    for (std::uint32_t p : probes) sink += table.lookup(p).valueCents;
+    auto t4 = Clock::now();
+    for (std::uint32_t p : probes) sink += table.lookup((p ^ (sink & 1u)) & kAllCasesMask).valueCents;
+    auto t5 = Clock::now();
+    const double n = static_cast<double>(probes.size());
+    std::printf("random lookup: %.1f ns/op throughput, %.1f ns/op latency (checksum %u)\n",
+                seconds(t4 - t3) * 1e9 / n, seconds(t5 - t4) * 1e9 / n, sink);
+    return dealMismatches == 0 ? 0 : 1;
+}
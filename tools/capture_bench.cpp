@@ -0,0 +1,155 @@
+// tools/capture_bench.cpp
+// Drives VideoCapture with synthetic show frames (static backdrop, a moving case and a
+// ticking counter band) at a fixed frame rate, first as raw Y4M and then compressed, and
+// reports what capture costs the main loop, the worker threads' load, dropped frames and
+// file sizes. When neither run dropped a frame, the compressed file is converted back and
+// must match the raw one byte for byte.
+//
+// Usage: capture_bench [--width W] [--height H] [--fps F] [--seconds S] [--pool N] [--dir D]
+//        capture_bench --convert IN.dcap OUT.y4m
+
+#include "video_capture.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count());
+}
+
+// Stand-in for the renderer: frame `n` of the synthetic show, BGRA
+void render(std::vector<std::uint32_t>& px, int w, int h, std::uint64_t n) {
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+            px[static_cast<std::size_t>(y * w + x)] = 0xff000000u | static_cast<std::uint32_t>(y * 255 / h) << 8
+                                                    | static_cast<std::uint32_t>(x * 255 / w);
+    const int box = 160, bx = static_cast<int>((n * 6) % static_cast<std::uint64_t>(w - box)), by = h / 3;
+    for (int y = by; y < by + box && y < h; y++)
+        for (int x = bx; x < bx + box; x++) px[static_cast<std::size_t>(y * w + x)] = 0xffc8a040u;
+    // Counter band: a few digits' worth of pixels change every frame
+    for (int y = h - 60; y < h - 20; y++)
+        for (int x = 40; x < 240; x++)
+            px[static_cast<std::size_t>(y * w + x)] = ((static_cast<std::uint64_t>(x / 20) + n) & 1) ? 0xffffffffu : 0xff202020u;
+}
+
+struct RunResult {
+    CaptureStats stats;
+    double seconds{0};
+};
+
+RunResult run(const char* path, int w, int h, const CaptureOptions& opt, double seconds) {
+    VideoCapture cap;
+    RunResult r;
+    if (!cap.open(path, w, h, opt)) return r;
+    std::vector<std::uint32_t> frame(static_cast<std::size_t>(w) * static_cast<std::size_t>(h));
+    const auto t0 = Clock::now();
+    const auto frameTime = std::chrono::nanoseconds(1000000000 / opt.fps);
+    auto next = t0;
+    std::uint64_t n = 0;
+    while (Clock::now() - t0 < std::chrono::duration<double>(seconds)) {
+        render(frame, w, h, n++);
+        if (cap.frame_due(now_ns())) {
+            const CaptureBuffer buf = cap.begin_frame(w, h);
+            if (buf.pixels) {
+                // The readback: SDL_RenderReadPixels into the pooled buffer
+                for (int y = 0; y < buf.height; y++)
+                    std::memcpy(buf.pixels + static_cast<std::ptrdiff_t>(y) * buf.pitch,
+                                frame.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(w),
+                                static_cast<std::size_t>(buf.width) * 4);
+                cap.submit();
+            }
+        }
+        next += frameTime;
+        std::this_thread::sleep_until(next);
+    }
+    cap.close();
+    r.stats = cap.stats();
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    return r;
+}
+
+void report(const char* label, const RunResult& r) {
+    const CaptureStats& s = r.stats;
+    const double frames = static_cast<double>(s.frames ? s.frames : 1);
+    std::printf("%-10s %5llu frames %4llu dropped   main %6.1f us avg %7.1f us max   encode %6.2f ms/frame   "
+                "write %6.2f ms/frame   %8.1f MB (%.1f MB/s)\n",
+                label, static_cast<unsigned long long>(s.frames), static_cast<unsigned long long>(s.dropped),
+                static_cast<double>(s.mainNs) / frames / 1e3, static_cast<double>(s.mainMaxNs) / 1e3,
+                static_cast<double>(s.encodeNs) / frames / 1e6, static_cast<double>(s.writeNs) / frames / 1e6,
+                static_cast<double>(s.bytes) / 1e6, static_cast<double>(s.bytes) / 1e6 / r.seconds);
+}
+
+bool same_file(const std::string& a, const std::string& b) {
+    std::FILE* fa = std::fopen(a.c_str(), "rb");
+    std::FILE* fb = std::fopen(b.c_str(), "rb");
+    bool same = fa && fb;
+    std::vector<char> ba(1 << 16), bb(1 << 16);
+    while (same) {
+        const std::size_t na = std::fread(ba.data(), 1, ba.size(), fa);
+        const std::size_t nb = std::fread(bb.data(), 1, bb.size(), fb);
+        if (na != nb || std::memcmp(ba.data(), bb.data(), na) != 0) same = false;
+        if (na == 0) break;
+    }
+    if (fa) std::fclose(fa);
+    if (fb) std::fclose(fb);
+    return same;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int w = 1280, h = 720;
+    double seconds = 3.0;
+    CaptureOptions opt;
+    opt.fps = 60;
+    std::string dir = "/tmp";
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--convert") && i + 2 < argc) return capture_to_y4m(argv[i + 1], argv[i + 2]) ? 0 : 1;
+        if (!std::strcmp(argv[i], "--width") && hasValue) w = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--height") && hasValue) h = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--fps") && hasValue) opt.fps = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seconds") && hasValue) seconds = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--pool") && hasValue) opt.poolFrames = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--dir") && hasValue) dir = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: %s [--width W] [--height H] [--fps F] [--seconds S] [--pool N] [--dir D]\n"
+                                 "       %s --convert IN.dcap OUT.y4m\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (opt.fps <= 0 || w < 2 || h < 2) return 2;
+
+    const std::string raw = dir + "/capture_bench.y4m", packed = dir + "/capture_bench.dcap",
+                      unpacked = dir + "/capture_bench.unpacked.y4m";
+    std::printf("%dx%d at %d fps for %.1f s, %d pooled frames\n", w & ~1, h & ~1, opt.fps, seconds, opt.poolFrames);
+    opt.compress = false;
+    const RunResult a = run(raw.c_str(), w, h, opt, seconds);
+    report("y4m", a);
+    opt.compress = true;
+    const RunResult b = run(packed.c_str(), w, h, opt, seconds);
+    report("dcap", b);
+
+    int rc = 0;
+    if (a.stats.dropped == 0 && b.stats.dropped == 0 && a.stats.frames == b.stats.frames) {
+        const bool ok = capture_to_y4m(packed.c_str(), unpacked.c_str()) && same_file(raw, unpacked);
+        std::printf("dcap -> y4m round trip: %s\n", ok ? "identical" : "MISMATCH");
+        rc = ok ? 0 : 1;
+    } else {
+        std::printf("frames were dropped; round trip not compared\n");
+    }
+    std::remove(raw.c_str());
+    std::remove(packed.c_str());
+    std::remove(unpacked.c_str());
+    return rc;
+}
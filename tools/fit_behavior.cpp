@@ -0,0 +1,56 @@
+// tools/fit_behavior.cpp
+// Fit the contestant behavior model from recorded decision logs. Logs are scanned in
+// parallel, the logistic model is fitted with batched gradient descent and written as a
+// model file that `simulate --model` plays directly.
+//
+// Usage: fit_behavior out.model log.dndl [log.dndl ...] [--threads N] [--iters N]
+
+#include "behavior_model.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    BehaviorFitOptions opts;
+    opts.threads = std::thread::hardware_concurrency();
+    const char* outPath = nullptr;
+    std::vector<std::string> logs;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--threads") && hasValue) opts.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--iters") && hasValue) opts.iterations = std::atoi(argv[++i]);
+        else if (!outPath) outPath = argv[i];
+        else logs.emplace_back(argv[i]);
+    }
+    if (!outPath || logs.empty()) {
+        std::fprintf(stderr, "usage: %s out.model log.dndl [log.dndl ...] [--threads N] [--iters N]\n", argv[0]);
+        return 2;
+    }
+    if (opts.threads == 0) opts.threads = 1;
+
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::duration d) { return std::chrono::duration<double>(d).count(); };
+
+    auto t0 = Clock::now();
+    BehaviorDataset data;
+    const bool allRead = load_behavior_dataset(logs, opts.threads, data);
+    auto t1 = Clock::now();
+    std::printf("scanned %zu logs, %zu decisions in %.2f s\n", logs.size(), data.size(), seconds(t1 - t0));
+    if (data.size() == 0) return 1;
+
+    BehaviorModel model;
+    const BehaviorFitReport rep = fit_behavior_model(data, opts, model);
+    auto t2 = Clock::now();
+    std::printf("fitted in %.2f s (%d iterations, %u threads): log-loss %.4f, accuracy %.2f%%\n",
+                seconds(t2 - t1), opts.iterations, opts.threads, rep.logLoss, rep.accuracy * 100.0);
+    std::printf("weights: bias %.4f, offer/EV %.4f, round %.4f, spread %.4f\n",
+                static_cast<double>(model.weights[0]), static_cast<double>(model.weights[1]),
+                static_cast<double>(model.weights[2]), static_cast<double>(model.weights[3]));
+    if (!model.save(outPath)) return 1;
+    return allRead ? 0 : 1;
+}
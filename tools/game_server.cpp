@@ -0,0 +1,54 @@
+// tools/game_server.cpp
+// Standalone hosted game server (see game_server.h and net_protocol.h).
+//
+// Usage: game_server [--port P] [--host ADDR] [--epoll] [--shards N] [--decision-ms MS] [--idle-ms MS]
+// Runs until SIGINT/SIGTERM; prints the backend in use and periodic session counts.
+
+#include "game_server.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+std::atomic<bool> gRunning{true};
+
+extern "C" void on_signal(int) { gRunning.store(false); }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    GameServerConfig config;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--port") && hasValue) config.port = static_cast<std::uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--host") && hasValue) config.host = argv[++i];
+        else if (!std::strcmp(argv[i], "--epoll")) config.backend = NetBackendKind::Epoll;
+        else if (!std::strcmp(argv[i], "--shards") && hasValue) config.shards = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--decision-ms") && hasValue) config.decisionTicks = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10)) / config.tickMs;
+        else if (!std::strcmp(argv[i], "--idle-ms") && hasValue) config.idleTicks = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10)) / config.tickMs;
+        else {
+            std::fprintf(stderr, "usage: %s [--port P] [--host ADDR] [--epoll] [--shards N] [--decision-ms MS] [--idle-ms MS]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    GameServer server(config);
+    if (!server.start()) return 1;
+    std::printf("listening on %s:%d (%s)\n", config.host, server.port(), server.backend().name());
+    std::fflush(stdout);
+    server.run(gRunning);
+
+    const NetStats& st = server.backend().stats();
+    std::printf("frames %llu, accepted %llu, syscalls %llu\n",
+                static_cast<unsigned long long>(server.frames_handled()),
+                static_cast<unsigned long long>(st.accepted),
+                static_cast<unsigned long long>(st.syscalls));
+    return 0;
+}
@@ -0,0 +1,104 @@
+// tools/log_bench.cpp
+// Checks and times the compact decision log codec (log_codec.h): round trip, size
+// against raw records, streaming encode/decode throughput and random access through
+// the keyframe index.
+//
+// Usage: log_bench [--games N] [--interval K] [log.dndl|log.dndc]
+// Without a log, N deterministic games (seed 1) with a threshold contestant are used.
+
+#include "deterministic.h"
+#include "log_codec.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point t) {
+    return std::chrono::duration<double>(Clock::now() - t).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t games = 1000000;
+    std::uint32_t interval = kDefaultKeyframeInterval;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--games") && hasValue) games = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--interval") && hasValue) interval = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (argv[i][0] != '-' && !path) path = argv[i];
+        else {
+            std::fprintf(stderr, "usage: %s [--games N] [--interval K] [log.dndl|log.dndc]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<DecisionRecord> records;
+    if (path) {
+        if (!read_decision_log(path, records)) return 1;
+    } else {
+        ThresholdPolicy policy;
+        std::vector<DecisionRecord> calls;
+        for (std::uint64_t g = 0; g < games; g++) {
+            policy.ratio = 0.6 + 0.05 * static_cast<double>(g % 8);
+            play_transcribed(1, static_cast<std::uint32_t>(g), policy, calls);
+            records.insert(records.end(), calls.begin(), calls.end());
+        }
+    }
+    for (DecisionRecord& r : records) r.reserved = 0; // Not stored by the codec
+    const double rawBytes = static_cast<double>(records.size() * sizeof(DecisionRecord));
+
+    // Best of three for each direction
+    std::vector<std::uint8_t> file;
+    double encSecs = 1e30, decSecs = 1e30;
+    for (int run = 0; run < 3; run++) {
+        auto t = Clock::now();
+        encode_decision_log(records, file, interval);
+        encSecs = std::min(encSecs, seconds_since(t));
+    }
+    std::vector<DecisionRecord> back;
+    for (int run = 0; run < 3; run++) {
+        back.clear();
+        back.reserve(records.size());
+        auto t = Clock::now();
+        if (!decode_decision_log(file.data(), file.size(), back)) return 1;
+        decSecs = std::min(decSecs, seconds_since(t));
+    }
+    const bool same = back.size() == records.size()
+                   && std::memcmp(back.data(), records.data(), records.size() * sizeof(DecisionRecord)) == 0;
+
+    // Random access: seek to scattered records and compare one record each
+    LogDecoder dec;
+    if (!dec.open(file.data(), file.size())) return 1;
+    constexpr int kSeeks = 20000;
+    std::uint64_t x = 12345;
+    bool seeksOk = true;
+    auto t = Clock::now();
+    for (int i = 0; i < kSeeks && !records.empty(); i++) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        const std::uint64_t at = (x >> 20) % records.size();
+        DecisionRecord r;
+        if (!dec.seek(at) || !dec.next(r) || std::memcmp(&r, &records[at], sizeof(r)) != 0) seeksOk = false;
+    }
+    const double seekUs = seconds_since(t) / kSeeks * 1e6;
+
+    const double fileBytes = static_cast<double>(file.size());
+    std::printf("%zu records, keyframe every %u\n", records.size(), interval);
+    std::printf("  size    %.1f MB raw -> %.1f MB (%.2f bytes/record, %.1fx)\n", rawBytes / 1e6, fileBytes / 1e6,
+                fileBytes / static_cast<double>(std::max<std::size_t>(records.size(), 1)), rawBytes / fileBytes);
+    std::printf("  encode  %7.1f M records/s  %6.2f GB/s of records\n", static_cast<double>(records.size()) / encSecs / 1e6,
+                rawBytes / encSecs / 1e9);
+    std::printf("  decode  %7.1f M records/s  %6.2f GB/s of records\n", static_cast<double>(records.size()) / decSecs / 1e6,
+                rawBytes / decSecs / 1e9);
+    std::printf("  seek    %.2f us per random record\n", seekUs);
+    std::printf("  round trip %s, seeks %s\n", same ? "identical" : "DIFFERENT", seeksOk ? "ok" : "WRONG");
+    return same && seeksOk ? 0 : 1;
+}
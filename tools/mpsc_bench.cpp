@@ -0,0 +1,186 @@
+// tools/mpsc_bench.cpp
+// Contention benchmark and self-check for MpscQueue. For each producer count, producers
+// push tagged sequence numbers as fast as they can while one consumer drains in batches;
+// the consumer verifies nothing is lost or reordered per producer. The same workload runs
+// through a mutex + condition variable ring for comparison.
+//
+// Usage: mpsc_bench [--items N] [--capacity C] [--batch B] [--producers 1,2,4,8]
+// Exits non-zero if any run loses or reorders an item (build with `make tsan` for the
+// ThreadSanitizer variant, bin/mpsc_bench_tsan).
+
+#include "mpsc_queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Item = producer index (high 16 bits) | per-producer sequence
+std::uint64_t make_item(std::uint64_t producer, std::uint64_t seq) {
+    return (producer << 48) | seq;
+}
+
+// Consumer-side check shared by both queues
+struct Checker {
+    explicit Checker(std::size_t producers) : next(producers, 0) {}
+    void take(std::uint64_t item) {
+        const std::size_t p = static_cast<std::size_t>(item >> 48);
+        const std::uint64_t seq = item & ((std::uint64_t{1} << 48) - 1);
+        if (p >= next.size() || seq != next[p]) ok = false;
+        else ++next[p];
+        ++received;
+    }
+    std::vector<std::uint64_t> next;
+    std::uint64_t received{0};
+    bool ok{true};
+};
+
+// Bounded ring under a mutex, the baseline
+class LockedQueue {
+public:
+    explicit LockedQueue(std::size_t capacity) : ring_(capacity) {}
+
+    void push(std::uint64_t item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [&] { return count_ < ring_.size(); });
+        ring_[(head_ + count_) % ring_.size()] = item;
+        ++count_;
+        lock.unlock();
+        notEmpty_.notify_one();
+    }
+
+    std::size_t pop_batch(std::uint64_t* out, std::size_t max) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait_for(lock, std::chrono::milliseconds(10), [&] { return count_ > 0; });
+        std::size_t n = 0;
+        while (n < max && count_ > 0) {
+            out[n++] = ring_[head_];
+            head_ = (head_ + 1) % ring_.size();
+            --count_;
+        }
+        lock.unlock();
+        if (n) notFull_.notify_all();
+        return n;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable notFull_, notEmpty_;
+    std::vector<std::uint64_t> ring_;
+    std::size_t head_{0}, count_{0};
+};
+
+struct RunResult {
+    double seconds{0};
+    std::uint64_t batches{0};
+    std::uint64_t wakeups{0};
+    bool ok{false};
+};
+
+RunResult run_mpsc(std::size_t producers, std::uint64_t perProducer, std::size_t capacity, std::size_t batch) {
+    MpscQueue<std::uint64_t> q(capacity);
+    Checker check(producers);
+    std::vector<std::uint64_t> buf(batch);
+    RunResult res;
+
+    const auto t0 = Clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (std::uint64_t i = 0; i < perProducer; i++)
+                while (!q.try_push(make_item(p, i))) std::this_thread::yield();
+        });
+    }
+    const std::uint64_t total = perProducer * producers;
+    while (check.received < total) {
+        const std::size_t n = q.pop_batch(buf.data(), batch);
+        if (n == 0) { q.wait(10); continue; }
+        ++res.batches;
+        for (std::size_t i = 0; i < n; i++) check.take(buf[i]);
+    }
+    for (auto& t : threads) t.join();
+    res.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    res.wakeups = q.wakeups();
+    res.ok = check.ok && check.received == total;
+    return res;
+}
+
+RunResult run_locked(std::size_t producers, std::uint64_t perProducer, std::size_t capacity, std::size_t batch) {
+    LockedQueue q(capacity);
+    Checker check(producers);
+    std::vector<std::uint64_t> buf(batch);
+    RunResult res;
+
+    const auto t0 = Clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (std::uint64_t i = 0; i < perProducer; i++) q.push(make_item(p, i));
+        });
+    }
+    const std::uint64_t total = perProducer * producers;
+    while (check.received < total) {
+        const std::size_t n = q.pop_batch(buf.data(), batch);
+        if (n) ++res.batches;
+        for (std::size_t i = 0; i < n; i++) check.take(buf[i]);
+    }
+    for (auto& t : threads) t.join();
+    res.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    res.ok = check.ok && check.received == total;
+    return res;
+}
+
+void report(const char* name, const RunResult& r, std::uint64_t total, bool showWakeups) {
+    std::printf("  %-8s %8.2f Mitems/s   mean batch %7.1f", name, static_cast<double>(total) / r.seconds / 1e6,
+                r.batches ? static_cast<double>(total) / static_cast<double>(r.batches) : 0.0);
+    if (showWakeups) std::printf("   eventfd wakeups %llu", static_cast<unsigned long long>(r.wakeups));
+    std::printf("   %s\n", r.ok ? "ok" : "FAILED (lost or reordered items)");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t items = 4000000;
+    std::size_t capacity = 4096, batch = 256;
+    std::vector<std::size_t> producerCounts{ 1, 2, 4, 8 };
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--items") && hasValue) items = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--capacity") && hasValue) capacity = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--batch") && hasValue) batch = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--producers") && hasValue) {
+            producerCounts.clear();
+            for (char* p = argv[++i]; *p;) {
+                producerCounts.push_back(std::strtoull(p, &p, 10));
+                if (*p == ',') ++p;
+            }
+        } else {
+            std::fprintf(stderr, "usage: %s [--items N] [--capacity C] [--batch B] [--producers 1,2,4,8]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok = true;
+    std::printf("%llu items per run, capacity %zu, batch %zu, %u hardware threads\n",
+                static_cast<unsigned long long>(items), capacity, batch, std::thread::hardware_concurrency());
+    for (std::size_t producers : producerCounts) {
+        if (producers == 0) continue;
+        const std::uint64_t perProducer = items / producers;
+        const std::uint64_t total = perProducer * producers;
+        std::printf("%zu producer%s\n", producers, producers == 1 ? "" : "s");
+        const RunResult lockFree = run_mpsc(producers, perProducer, capacity, batch);
+        report("mpsc", lockFree, total, true);
+        const RunResult locked = run_locked(producers, perProducer, capacity, batch);
+        report("mutex", locked, total, false);
+        ok = ok && lockFree.ok && locked.ok;
+    }
+    return ok ? 0 : 1;
+}
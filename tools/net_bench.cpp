@@ -0,0 +1,225 @@
+// tools/net_bench.cpp
+// Loopback benchmark for the game server transports. Starts the server in-process, then
+// client threads keep `--depth` pings in flight each and measure round trips. With --play
+// the clients play games instead (one command in flight per connection), which exercises
+// the game shards when --shards is given.
+//
+// Usage: net_bench [--backend uring|epoll|both] [--clients N] [--depth D] [--seconds S]
+//                  [--play] [--shards N]
+// Reports messages/second, p50/p99 round-trip latency and server syscalls per message.
+
+#include "game_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+struct ClientResult {
+    std::uint64_t messages{0};
+    std::vector<std::uint32_t> rttNs;
+};
+
+void append_ping(std::vector<std::uint8_t>& out, std::uint32_t seq) {
+    std::uint8_t body[12];
+    const std::uint64_t ts = now_ns();
+    std::memcpy(body, &seq, 4);
+    std::memcpy(body + 4, &ts, 8);
+    append_frame(out, MsgType::Ping, body, sizeof(body));
+}
+
+void run_client(int port, int depth, Clock::time_point until, ClientResult& res) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::fprintf(stderr, "net_bench: connect failed: %s\n", std::strerror(errno));
+        ::close(fd);
+        return;
+    }
+
+    std::vector<std::uint8_t> out;
+    std::uint32_t seq = 0;
+    for (int i = 0; i < depth; i++) append_ping(out, seq++);
+    ::write(fd, out.data(), out.size());
+
+    FrameReader reader;
+    std::uint8_t buf[16384];
+    bool stopping = false;
+    int inFlight = depth;
+    while (inFlight > 0) {
+        const ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n <= 0) break;
+        if (!stopping && Clock::now() >= until) stopping = true;
+        out.clear();
+        const std::uint64_t t = now_ns();
+        reader.feed(buf, static_cast<std::size_t>(n), [&](MsgType type, const std::uint8_t* body, std::size_t len) {
+            if (type != MsgType::Pong || len != 12) return;
+            std::uint64_t sent;
+            std::memcpy(&sent, body + 4, 8);
+            res.rttNs.push_back(static_cast<std::uint32_t>(std::min<std::uint64_t>(t - sent, UINT32_MAX)));
+            ++res.messages;
+            --inFlight;
+            // Answer each pong with a new ping; all of them leave in one write below
+            if (!stopping) { append_ping(out, seq++); ++inFlight; }
+        });
+        if (!out.empty()) ::write(fd, out.data(), out.size());
+    }
+    ::close(fd);
+}
+
+// Plays games back to back: opens cases in order, says NO DEAL until round 5, then DEAL
+void run_player(int port, Clock::time_point until, ClientResult& res) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::fprintf(stderr, "net_bench: connect failed: %s\n", std::strerror(errno));
+        ::close(fd);
+        return;
+    }
+
+    std::vector<std::uint8_t> out;
+    std::uint8_t nextCase = 1;
+    const std::uint8_t contestant = 0;
+    append_frame(out, MsgType::NewGame, &contestant, 1);
+    std::uint64_t sentAt = now_ns();
+    ::write(fd, out.data(), out.size());
+
+    FrameReader reader;
+    std::uint8_t buf[4096];
+    bool done = false;
+    while (!done) {
+        const ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n <= 0) break;
+        out.clear();
+        reader.feed(buf, static_cast<std::size_t>(n), [&](MsgType type, const std::uint8_t* body, std::size_t len) {
+            if (type != MsgType::State || len != sizeof(StateMsg)) { done = true; return; }
+            const std::uint64_t t = now_ns();
+            res.rttNs.push_back(static_cast<std::uint32_t>(std::min<std::uint64_t>(t - sentAt, UINT32_MAX)));
+            ++res.messages;
+            if (Clock::now() >= until) { done = true; return; }
+
+            StateMsg st;
+            std::memcpy(&st, body, sizeof(st));
+            switch (static_cast<SessionPhase>(st.phase)) {
+            case SessionPhase::Opening:
+                append_frame(out, MsgType::OpenCase, &nextCase, 1);
+                ++nextCase;
+                break;
+            case SessionPhase::Offer:
+                append_frame(out, st.round >= 5 ? MsgType::Deal : MsgType::NoDeal, nullptr, 0);
+                break;
+            default:
+                nextCase = 1;
+                append_frame(out, MsgType::NewGame, &contestant, 1);
+                break;
+            }
+            sentAt = now_ns();
+        });
+        if (!out.empty()) ::write(fd, out.data(), out.size());
+    }
+    ::close(fd);
+}
+
+void bench(NetBackendKind kind, int clients, int depth, double seconds, bool play, std::uint32_t shards) {
+    GameServerConfig config;
+    config.port = 0;
+    config.backend = kind;
+    config.shards = shards;
+    GameServer server(config);
+    if (!server.start()) return;
+
+    std::atomic<bool> running{true};
+    std::thread serverThread([&] { server.run(running); });
+
+    const auto t0 = Clock::now();
+    const auto until = t0 + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    std::vector<ClientResult> results(static_cast<std::size_t>(clients));
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < results.size(); i++)
+        if (play) threads.emplace_back(run_player, server.port(), until, std::ref(results[i]));
+        else threads.emplace_back(run_client, server.port(), depth, until, std::ref(results[i]));
+    for (auto& t : threads) t.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    running.store(false);
+    serverThread.join();
+
+    std::uint64_t messages = 0;
+    std::vector<std::uint32_t> rtt;
+    for (const ClientResult& r : results) {
+        messages += r.messages;
+        rtt.insert(rtt.end(), r.rttNs.begin(), r.rttNs.end());
+    }
+    if (rtt.empty()) {
+        std::printf("%-30s no messages\n", server.backend().name());
+        return;
+    }
+    const auto pct = [&](double p) {
+        const std::size_t k = std::min(rtt.size() - 1, static_cast<std::size_t>(p * static_cast<double>(rtt.size())));
+        std::nth_element(rtt.begin(), rtt.begin() + static_cast<std::ptrdiff_t>(k), rtt.end());
+        return static_cast<double>(rtt[k]) / 1000.0;
+    };
+    const double p50 = pct(0.50), p99 = pct(0.99);
+    const NetStats& st = server.backend().stats();
+    std::printf("%-30s %10.0f msg/s   p50 %8.1f us   p99 %8.1f us   %.3f syscalls/msg\n",
+                server.backend().name(), static_cast<double>(messages) / elapsed, p50, p99,
+                static_cast<double>(st.syscalls) / static_cast<double>(server.frames_handled()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* backend = "both";
+    int clients = 8, depth = 16;
+    double seconds = 3.0;
+    bool play = false;
+    std::uint32_t shards = 0;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--backend") && hasValue) backend = argv[++i];
+        else if (!std::strcmp(argv[i], "--clients") && hasValue) clients = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--depth") && hasValue) depth = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seconds") && hasValue) seconds = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--play")) play = true;
+        else if (!std::strcmp(argv[i], "--shards") && hasValue) shards = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else {
+            std::fprintf(stderr, "usage: %s [--backend uring|epoll|both] [--clients N] [--depth D] [--seconds S] [--play] [--shards N]\n", argv[0]);
+            return 2;
+        }
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    if (play) std::printf("%d clients playing games, %u shard%s, %.1f s per backend\n", clients, shards, shards == 1 ? "" : "s", seconds);
+    else std::printf("%d clients x %d pings in flight, %.1f s per backend\n", clients, depth, seconds);
+    const bool both = !std::strcmp(backend, "both");
+    if (both || !std::strcmp(backend, "uring")) bench(NetBackendKind::IoUring, clients, depth, seconds, play, shards);
+    if (both || !std::strcmp(backend, "epoll")) bench(NetBackendKind::Epoll, clients, depth, seconds, play, shards);
+    return 0;
+}
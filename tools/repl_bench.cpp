@@ -0,0 +1,228 @@
+// tools/repl_bench.cpp
+// Replication under load, then failover. A child process plays the primary: it runs many
+// shows on a 1 ms tick, feeds them random contestant input and ships the log through a
+// ReplicationPrimary. This process is the standby. It joins late, so it is first brought
+// up to date from history, then follows live and measures how far it trails. After
+// --seconds the primary crashes (or, with --hang, freezes). The standby detects it, takes
+// over and keeps the shows running for a while to show they carry on.
+//
+// Usage: repl_bench [--shows N] [--rate INPUTS_PER_S] [--seconds S] [--failover-ms M] [--hang]
+// Reports replication lag percentiles, hash mismatches and the time to detect the failure.
+
+#include "replication.h"
+#include "simulator.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t kTickMs = 1;
+
+struct BenchShow final : ShowStage {
+    ShowFiber fiber;
+    ShowState state;
+    void on_step(const ShowState&) override {}
+    void on_rejected(const ShowInput&, ErrorCode) override {}
+};
+
+ShowTiming bench_timing() {
+    ShowTiming t;
+    t.introTicks = 20;
+    t.revealTicks = 5;
+    t.bankerCallTicks = 30;
+    t.decisionTicks = 200;
+    t.finaleTicks = 40;
+    return t;
+}
+
+std::uint64_t elapsed_ms(std::chrono::steady_clock::time_point t0) {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count());
+}
+
+// Drives a set of shows with random contestants; used by the primary and, after
+// failover, by the standby
+class Contestants {
+public:
+    Contestants(ShowScheduler& sched, BenchShow* shows, std::uint32_t count, std::uint64_t seed)
+        : sched_(sched), shows_(shows), count_(count), rng_(seed) {}
+
+    void start(std::uint32_t i) {
+        BenchShow& s = shows_[i];
+        for (int c = 0; c < kNumCases; c++) s.state.cases[static_cast<std::size_t>(c)] = static_cast<std::uint8_t>(c);
+        for (std::uint32_t c = kNumCases - 1; c > 0; c--) std::swap(s.state.cases[c], s.state.cases[sim_bounded(rng_, c + 1)]);
+        s.fiber.start(sched_, run_show(s.fiber, s, s.state, timing_));
+        if (repl) repl->show_started(i, sched_.timers().now(), s.state);
+        ++started;
+    }
+
+    // One random move by one random contestant
+    void act() {
+        const std::uint32_t i = sim_bounded(rng_, count_);
+        BenchShow& s = shows_[i];
+        const auto c = static_cast<std::uint8_t>(sim_bounded(rng_, kNumCases));
+        ShowInput in;
+        switch (s.state.step) {
+        case ShowStep::PickCase: in = ShowInput{ ShowInput::PickCase, c }; break;
+        case ShowStep::OpenCases: in = ShowInput{ ShowInput::OpenCase, c }; break;
+        case ShowStep::Offer: in = ShowInput{ sim_bounded(rng_, 4) ? ShowInput::NoDeal : ShowInput::Deal, 0 }; break;
+        case ShowStep::Finished: start(i); return;
+        default: return;
+        }
+        if (!s.fiber.post(in)) return;
+        if (repl) repl->input(i, sched_.timers().now(), in, s.state);
+        ++inputs;
+    }
+
+    ReplicationPrimary* repl{nullptr};
+    std::uint64_t started{0};
+    std::uint64_t inputs{0};
+
+private:
+    ShowScheduler& sched_;
+    BenchShow* shows_;
+    std::uint32_t count_;
+    std::mt19937_64 rng_;
+    const ShowTiming timing_{bench_timing()};
+};
+
+[[noreturn]] void run_primary(const char* path, std::uint32_t shows, double rate, double seconds, bool hang) {
+    const ShowTiming timing = bench_timing();
+    ReplicationPrimary repl;
+    if (!repl.listen(path, timing, kTickMs)) _exit(1);
+    ShowScheduler sched;
+    auto pool = std::make_unique<BenchShow[]>(shows);
+    Contestants players(sched, pool.get(), shows, 42);
+    players.repl = &repl;
+    for (std::uint32_t i = 0; i < shows; i++) players.start(i);
+
+    std::vector<TimerEvent> other;
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto stopMs = static_cast<std::uint64_t>(seconds * 1000.0);
+    double owed = 0.0;
+    std::uint64_t lastMs = 0;
+    for (;;) {
+        const std::uint64_t ms = elapsed_ms(t0);
+        if (ms >= stopMs) break;
+        sched.advance(ms / kTickMs, other);
+        owed += rate * static_cast<double>(ms - lastMs) / 1000.0;
+        lastMs = ms;
+        for (; owed >= 1.0; owed -= 1.0) players.act();
+        repl.flush(sched.timers().now());
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    std::printf("primary: %llu shows started, %llu inputs, %llu records (%.1f MiB) sent\n",
+                static_cast<unsigned long long>(players.started), static_cast<unsigned long long>(players.inputs),
+                static_cast<unsigned long long>(repl.stats().records),
+                static_cast<double>(repl.stats().bytes) / (1024.0 * 1024.0));
+    std::fflush(stdout);
+    if (hang) ::raise(SIGSTOP); // Freeze with the socket open; the standby has to fence us
+    _exit(0);                   // Crash: no goodbye, the kernel closes the socket
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint32_t shows = 2000, failoverMs = 30;
+    double rate = 20000.0, seconds = 3.0;
+    bool hang = false;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--shows") && hasValue) shows = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--rate") && hasValue) rate = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seconds") && hasValue) seconds = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--failover-ms") && hasValue) failoverMs = static_cast<std::uint32_t>(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--hang")) hang = true;
+        else {
+            std::fprintf(stderr, "usage: %s [--shows N] [--rate INPUTS_PER_S] [--seconds S] [--failover-ms M] [--hang]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (shows == 0) shows = 1;
+
+    char path[64];
+    std::snprintf(path, sizeof(path), "/tmp/repl_bench.%d.sock", static_cast<int>(::getpid()));
+    std::fflush(stdout);
+    const pid_t child = ::fork();
+    if (child < 0) {
+        std::perror("fork");
+        return 1;
+    }
+    if (child == 0) run_primary(path, shows, rate, seconds, hang);
+
+    // Standby: join late so the history resync is part of the run
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const ShowTiming timing = bench_timing();
+    ShowScheduler sched;
+    auto pool = std::make_unique<BenchShow[]>(shows);
+    std::vector<std::uint32_t> lag;
+    ReplicationStandby standby(sched, timing, [&](std::uint32_t show) {
+        if (show >= shows) return ReplicaSlot{};
+        return ReplicaSlot{ &pool[show].fiber, &pool[show].state, &pool[show] };
+    });
+    standby.set_failover_ms(failoverMs);
+    standby.lagLog = &lag;
+
+    ReplicationStandby::Status st = ReplicationStandby::Status::Connecting;
+    const auto waitUntil = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds + 5.0);
+    while (st != ReplicationStandby::Status::FailedOver && st != ReplicationStandby::Status::Detached
+           && std::chrono::steady_clock::now() < waitUntil)
+        st = standby.poll(path, 5);
+    if (st != ReplicationStandby::Status::FailedOver) {
+        std::printf("standby: no failover (status %d)\n", static_cast<int>(st));
+        ::kill(child, SIGKILL);
+        ::waitpid(child, nullptr, 0);
+        return 1;
+    }
+
+    const ReplicationStats& rs = standby.stats();
+    std::printf("standby: %llu records, %llu inputs applied, %llu hash mismatches\n",
+                static_cast<unsigned long long>(rs.records), static_cast<unsigned long long>(rs.inputs),
+                static_cast<unsigned long long>(rs.mismatches));
+    if (!lag.empty()) {
+        const auto pct = [&](double p) {
+            const std::size_t k = std::min(lag.size() - 1, static_cast<std::size_t>(p * static_cast<double>(lag.size())));
+            std::nth_element(lag.begin(), lag.begin() + static_cast<std::ptrdiff_t>(k), lag.end());
+            return static_cast<double>(lag[k]) / 1000.0;
+        };
+        const double p50 = pct(0.50), p99 = pct(0.99);
+        std::printf("lag: p50 %.1f us   p99 %.1f us   max %.1f us\n", p50, p99,
+                    static_cast<double>(rs.maxLagNs) / 1000.0);
+    }
+    std::printf("failure detected %.2f ms after the primary's last record%s\n",
+                static_cast<double>(standby.failover_ns() - standby.last_record_ns()) / 1e6,
+                standby.fenced() ? " (hung primary killed)" : "");
+
+    // Take over: the clock continues from the primary's last tick
+    const std::uint64_t baseTick = standby.tick_at(repl_now_ns());
+    Contestants players(sched, pool.get(), shows, 7);
+    std::vector<TimerEvent> other;
+    const auto t0 = std::chrono::steady_clock::now();
+    std::uint64_t lastMs = 0;
+    double owed = 0.0;
+    for (std::uint64_t ms = 0; ms < 1000; ms = elapsed_ms(t0)) {
+        sched.advance(baseTick + ms / kTickMs, other);
+        owed += rate * static_cast<double>(ms - lastMs) / 1000.0;
+        lastMs = ms;
+        for (; owed >= 1.0; owed -= 1.0) players.act();
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    std::printf("after takeover: %llu inputs, %llu new shows in 1 s\n",
+                static_cast<unsigned long long>(players.inputs), static_cast<unsigned long long>(players.started));
+
+    ::waitpid(child, nullptr, 0);
+    for (std::uint32_t i = 0; i < shows; i++) pool[i].fiber.stop();
+    return rs.mismatches ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+// tools/replay_bench.cpp
+// Seek latency in replay files (replay_file.h). Records a long session of back-to-back
+// shows at the client's pacing (10 ms ticks advanced a frame at a time, human think
+// times), then seeks to random moments and checks that every seek lands on the same
+// state as plain playback.
+//
+// Usage: replay_bench [--minutes M] [--seeks N] [--out FILE] [--seed S]
+// Defaults: a two-hour recording, 2000 seeks, /tmp/replay_bench.dndr.
+
+#include "replay_file.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t kTickMs = 10;
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchShow final : ShowStage {
+    ShowFiber fiber;
+    ShowState state;
+    void on_step(const ShowState&) override {}
+    void on_rejected(const ShowInput&, ErrorCode) override {}
+};
+
+// The SDL client's pacing; the offer waits for the contestant
+ShowTiming client_timing() {
+    ShowTiming t;
+    t.introTicks = 1500 / kTickMs;
+    t.revealTicks = 800 / kTickMs;
+    t.bankerCallTicks = 2000 / kTickMs;
+    t.finaleTicks = 3000 / kTickMs;
+    return t;
+}
+
+std::uint8_t random_case(std::mt19937_64& rng, const ShowState& st) {
+    std::uint8_t c = 0;
+    do c = static_cast<std::uint8_t>(sim_bounded(rng, kNumCases));
+    while (c == st.contestantCase || (st.openedCases & (1u << c)));
+    return c;
+}
+
+// Plays shows for `endTick` ticks with a random contestant, recording them to `path`.
+// Returns the number of shows.
+std::uint32_t record_session(const char* path, std::uint64_t endTick, std::uint64_t seed) {
+    const ShowTiming timing = client_timing();
+    ReplayWriter writer;
+    if (!writer.open(path, timing, kTickMs)) return 0;
+    std::mt19937_64 rng{seed};
+    ShowScheduler sched;
+    std::vector<TimerEvent> other;
+    BenchShow show;
+    ShowState& st = show.state;
+    std::uint32_t shows = 0;
+    auto think = [&](std::uint32_t minMs, std::uint32_t maxMs) {
+        return (minMs + sim_bounded(rng, maxMs - minMs)) / kTickMs;
+    };
+
+    while (sched.timers().now() < endTick) {
+        std::uint64_t wake = sched.timers().now();
+        std::optional<ShowInput> in;
+        switch (st.step) {
+        case ShowStep::PickCase: wake += think(1000, 6000); in = ShowInput{ ShowInput::PickCase, random_case(rng, st) }; break;
+        case ShowStep::OpenCases: wake += think(500, 4000); in = ShowInput{ ShowInput::OpenCase, random_case(rng, st) }; break;
+        case ShowStep::Offer:
+            wake += think(2000, 15000);
+            in = ShowInput{ sim_bounded(rng, 5) == 0 ? ShowInput::Deal : ShowInput::NoDeal, 0 };
+            break;
+        default: wake = std::max(wake, st.stepStartTick + st.stepTicks); break;
+        }
+        // Between shows (or before the first) the studio takes a break
+        if (!show.fiber.running()) wake += shows == 0 ? 0 : think(5000, 30000);
+
+        // The client advances a frame's worth of ticks at a time
+        while (sched.timers().now() < wake) sched.advance(std::min(wake - 1, sched.timers().now() + sim_bounded(rng, 4)), other);
+        other.clear();
+        if (!show.fiber.running()) {
+            for (int i = 0; i < kNumCases; i++) st.cases[static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(i);
+            for (std::uint32_t i = kNumCases - 1; i > 0; i--) std::swap(st.cases[i], st.cases[sim_bounded(rng, i + 1)]);
+            show.fiber.start(sched, run_show(show.fiber, show, st, timing));
+            writer.show_started(sched.timers().now(), st);
+            ++shows;
+        } else if (in) {
+            if (show.fiber.post(*in)) writer.input(sched.timers().now(), *in, st);
+        } else if (wake == sched.timers().now()) {
+            sched.advance(wake, other); // Let the step's timer fire
+            other.clear();
+        }
+        writer.flush();
+    }
+    writer.close(sched.timers().now());
+    show.fiber.stop();
+    return shows;
+}
+
+double ms_since(Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t minutes = 120;
+    std::uint32_t seeks = 2000;
+    std::uint64_t seed = 1;
+    const char* path = "/tmp/replay_bench.dndr";
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--minutes") && hasValue) minutes = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seeks") && hasValue) seeks = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--out") && hasValue) path = argv[++i];
+        else if (!std::strcmp(argv[i], "--seed") && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::fprintf(stderr, "usage: %s [--minutes M] [--seeks N] [--out FILE] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    auto t = Clock::now();
+    const std::uint32_t shows = record_session(path, minutes * 60000 / kTickMs, seed);
+    if (shows == 0) return 1;
+    std::printf("recorded %llu min, %u shows in %.0f ms\n", static_cast<unsigned long long>(minutes), shows, ms_since(t));
+
+    BenchShow show;
+    ReplayPlayer player(ReplicaSlot{ &show.fiber, &show.state, &show });
+    t = Clock::now();
+    if (!player.open(path)) return 1;
+    std::printf("opened: %zu keyframes, %.2f ms\n", player.keyframes(), ms_since(t));
+
+    // Reference: the state hash at each target tick by playing straight through
+    std::mt19937_64 rng{seed + 1};
+    std::vector<std::uint64_t> targets(seeks);
+    const std::uint64_t span = player.end_tick() + 1;
+    for (std::uint64_t& target : targets) target = (rng() >> 11) % span;
+    std::vector<std::uint64_t> sorted = targets;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> expected;
+    t = Clock::now();
+    player.seek(0);
+    for (std::uint64_t target : sorted) {
+        player.play_to(target);
+        expected.emplace_back(target, show_state_hash(show.state));
+    }
+    std::printf("played through: %.1f ms (%.0fx real time)\n", ms_since(t),
+                static_cast<double>(minutes) * 60000.0 / std::max(ms_since(t), 1e-6));
+
+    // Random seeks in recording order, each timed and checked against the reference
+    std::vector<double> lat;
+    std::uint32_t wrong = 0;
+    for (std::uint64_t target : targets) {
+        t = Clock::now();
+        player.seek(target);
+        lat.push_back(ms_since(t));
+        const auto it = std::lower_bound(expected.begin(), expected.end(), std::make_pair(target, 0u));
+        if (it == expected.end() || it->first != target || it->second != show_state_hash(show.state)) ++wrong;
+    }
+    std::sort(lat.begin(), lat.end());
+    double sum = 0;
+    for (double l : lat) sum += l;
+    const auto pct = [&](double p) { return lat.empty() ? 0.0 : lat[static_cast<std::size_t>(p * static_cast<double>(lat.size() - 1))]; };
+    std::printf("%u seeks: mean %.3f ms, p50 %.3f, p99 %.3f, max %.3f ms\n", seeks,
+                lat.empty() ? 0.0 : sum / static_cast<double>(lat.size()), pct(0.5), pct(0.99), pct(1.0));
+    std::printf("seek states %s, %llu hash mismatches against the recording\n", wrong ? "WRONG" : "match playback",
+                static_cast<unsigned long long>(player.mismatches()));
+    return wrong == 0 && player.mismatches() == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+// tools/replay_verify.cpp
+// Audit check: replays every game of a transcript file (simulate --transcripts) on this
+// build and compares payout, deal round and the digest of every banker call bit for
+// bit. Games are independent (deterministic.h), so they are split across threads.
+//
+// Usage: replay_verify games.dndt [--threads N]
+// Exit status 0 when every game matches, 1 on any mismatch or error.
+
+#include "deterministic.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    unsigned threads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--threads") && hasValue) threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (!path && argv[i][0] != '-') path = argv[i];
+        else path = nullptr, i = argc;
+    }
+    if (!path) {
+        std::fprintf(stderr, "usage: %s games.dndt [--threads N]\n", argv[0]);
+        return 2;
+    }
+    if (threads == 0) threads = 1;
+
+    std::uint64_t runSeed = 0;
+    std::vector<GameTranscript> games;
+    if (!read_transcripts(path, runSeed, games)) return 1;
+
+    // Threads take blocks of games; the first few mismatches are kept for the report
+    constexpr std::size_t kBlock = 4096;
+    constexpr std::size_t kMaxReported = 10;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::uint64_t> mismatches{0};
+    std::mutex reportLock;
+    std::vector<std::uint32_t> reported;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back([&] {
+            std::vector<DecisionRecord> scratch;
+            std::uint64_t bad = 0;
+            for (;;) {
+                const std::size_t begin = next.fetch_add(kBlock, std::memory_order_relaxed);
+                if (begin >= games.size()) break;
+                const std::size_t end = std::min(begin + kBlock, games.size());
+                for (std::size_t i = begin; i < end; i++) {
+                    if (verify_transcript(runSeed, games[i], scratch)) continue;
+                    ++bad;
+                    std::lock_guard<std::mutex> lock(reportLock);
+                    if (reported.size() < kMaxReported) reported.push_back(games[i].gameId);
+                }
+            }
+            mismatches.fetch_add(bad, std::memory_order_relaxed);
+        });
+    }
+    for (std::thread& t : pool) t.join();
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::sort(reported.begin(), reported.end());
+    for (std::uint32_t id : reported) std::printf("MISMATCH game %u\n", id);
+    std::printf("%zu games (seed %llu) replayed on %u thread%s in %.2f s (%.2f M games/s): %llu mismatch%s\n",
+                games.size(), static_cast<unsigned long long>(runSeed), threads, threads == 1 ? "" : "s", secs,
+                static_cast<double>(games.size()) / std::max(secs, 1e-9) / 1e6,
+                static_cast<unsigned long long>(mismatches.load()), mismatches.load() == 1 ? "" : "es");
+    return mismatches.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+// tools/show_bench.cpp
+// Runs many concurrent shows on one ShowScheduler, the way a server shard does: every
+// session is a fiber executing run_show(), fed random contestant input, with paced steps
+// so thousands of coroutines are suspended on the timer wheel at once.
+//
+// Usage: show_bench [--sessions N] [--ticks T] [--seed S]
+// Reports shows completed, inputs/second and the frame pool counters.
+
+#include "show_flow.h"
+#include "simulator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct BenchSession final : ShowStage {
+    ShowFiber fiber;
+    ShowState state;
+    std::uint64_t steps{0};
+    std::uint64_t rejected{0};
+    void on_step(const ShowState&) override { ++steps; }
+    void on_rejected(const ShowInput&, ErrorCode) override { ++rejected; }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t sessions = 10000;
+    std::uint64_t ticks = 20000, seed = 1;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--sessions") && hasValue) sessions = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--ticks") && hasValue) ticks = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed") && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::fprintf(stderr, "usage: %s [--sessions N] [--ticks T] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    ShowTiming timing;
+    timing.introTicks = 5;
+    timing.revealTicks = 2;
+    timing.bankerCallTicks = 10;
+    timing.decisionTicks = 50;
+    timing.finaleTicks = 10;
+
+    std::mt19937_64 rng{seed};
+    ShowScheduler sched;
+    auto pool = std::make_unique<BenchSession[]>(sessions);
+    auto start = [&](BenchSession& s) {
+        for (int i = 0; i < kNumCases; i++) s.state.cases[static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(i);
+        for (std::uint32_t i = kNumCases - 1; i > 0; i--) std::swap(s.state.cases[i], s.state.cases[sim_bounded(rng, i + 1)]);
+        s.fiber.start(sched, run_show(s.fiber, s, s.state, timing));
+    };
+    for (std::size_t i = 0; i < sessions; i++) start(pool[i]);
+
+    std::vector<TimerEvent> other;
+    std::uint64_t inputs = 0, shows = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t tick = 0; tick < ticks; tick++) {
+        sched.advance(tick, other);
+        // Each tick a random tenth of the contestants act; some moves are invalid on purpose
+        for (std::size_t k = 0; k < sessions / 10; k++) {
+            BenchSession& s = pool[sim_bounded(rng, static_cast<std::uint32_t>(sessions))];
+            const auto c = static_cast<std::uint8_t>(sim_bounded(rng, kNumCases));
+            switch (s.state.step) {
+            case ShowStep::PickCase: s.fiber.post(ShowInput{ ShowInput::PickCase, c }); break;
+            case ShowStep::OpenCases: s.fiber.post(ShowInput{ ShowInput::OpenCase, c }); break;
+            case ShowStep::Offer: s.fiber.post(ShowInput{ sim_bounded(rng, 4) ? ShowInput::NoDeal : ShowInput::Deal, 0 }); break;
+            case ShowStep::Finished: ++shows; start(s); break;
+            default: continue;
+            }
+            ++inputs;
+        }
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::uint64_t steps = 0, rejected = 0;
+    for (std::size_t i = 0; i < sessions; i++) {
+        steps += pool[i].steps;
+        rejected += pool[i].rejected;
+    }
+    const FramePoolStats fp = frame_pool_stats();
+    std::printf("%zu sessions, %llu ticks in %.2f s\n", sessions, static_cast<unsigned long long>(ticks), secs);
+    std::printf("shows completed %llu, inputs %llu (%.2f M/s), steps %llu, rejected %llu\n",
+                static_cast<unsigned long long>(shows), static_cast<unsigned long long>(inputs),
+                static_cast<double>(inputs) / secs / 1e6, static_cast<unsigned long long>(steps),
+                static_cast<unsigned long long>(rejected));
+    std::printf("frames: %llu allocated, %.1f%% reused, %llu oversize, %llu live, %.1f KiB of slabs\n",
+                static_cast<unsigned long long>(fp.allocations),
+                fp.allocations ? 100.0 * static_cast<double>(fp.reused) / static_cast<double>(fp.allocations) : 0.0,
+                static_cast<unsigned long long>(fp.oversize), static_cast<unsigned long long>(fp.live),
+                static_cast<double>(fp.slabBytes) / 1024.0);
+
+    for (std::size_t i = 0; i < sessions; i++) pool[i].fiber.stop();
+    return 0;
+}
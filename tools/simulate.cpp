@@ -0,0 +1,121 @@
+// tools/simulate.cpp
+// Headless game simulator for economics runs. Plays N games with a chosen contestant
+// policy, reports payouts and throughput, and can write the banker calls as a decision log.
+//
+// Usage: simulate [--games N] [--seed S] [--model behavior.model | --table strategy.dnds | --solver]
+//                 [--log out.dndl|out.dndc] [--transcripts out.dndt]
+// By default the contestant plays the optimum from ./strategy.dnds (build_strategy_table).
+// --solver evaluates it live through a 1 GiB transposition table instead: random games
+// reach almost every state, so anything smaller thrashes.
+// --transcripts switches to deterministic mode (deterministic.h): every game is seeded on
+// its own from the run seed, and its transcript is written for replay_verify.
+
+#include "behavior_model.h"
+#include "deterministic.h"
+#include "simulator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Totals {
+    std::uint64_t games{0};
+    std::uint64_t winningsCents{0};
+    std::uint64_t deals{0};
+};
+
+template <class Policy>
+Totals run(Policy& policy, std::uint64_t games, std::uint64_t seed, std::vector<DecisionRecord>* log,
+           std::vector<GameTranscript>* transcripts) {
+    Totals t;
+    t.games = games;
+    if (transcripts) {
+        std::vector<DecisionRecord> calls;
+        for (std::uint64_t g = 0; g < games; g++) {
+            const GameTranscript tr = play_transcribed(seed, static_cast<std::uint32_t>(g), policy, calls);
+            transcripts->push_back(tr);
+            if (log) log->insert(log->end(), calls.begin(), calls.end());
+            t.winningsCents += tr.winningsCents;
+            t.deals += tr.dealRound ? 1 : 0;
+        }
+        return t;
+    }
+    std::mt19937_64 rng{seed};
+    for (std::uint64_t g = 0; g < games; g++) {
+        const GameResult r = play_game(rng, policy, static_cast<std::uint32_t>(g), log);
+        t.winningsCents += r.winningsCents;
+        t.deals += r.dealRound ? 1 : 0;
+    }
+    return t;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t games = 100000, seed = 1;
+    const char* modelPath = nullptr;
+    const char* tablePath = "strategy.dnds";
+    bool useSolver = false;
+    const char* logPath = nullptr;
+    const char* transcriptPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--games") && hasValue) games = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed") && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--model") && hasValue) modelPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--table") && hasValue) tablePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--solver")) useSolver = true;
+        else if (!std::strcmp(argv[i], "--log") && hasValue) logPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--transcripts") && hasValue) transcriptPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: %s [--games N] [--seed S] [--model file | --table file | --solver] [--log file]\n"
+                                 "       [--transcripts file]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<DecisionRecord> log;
+    std::vector<DecisionRecord>* logOut = logPath ? &log : nullptr;
+    std::vector<GameTranscript> transcripts;
+    std::vector<GameTranscript>* transcriptsOut = transcriptPath ? &transcripts : nullptr;
+
+    auto t0 = std::chrono::steady_clock::now();
+    Totals t;
+    const char* policyName;
+    if (modelPath) {
+        BehaviorModel model;
+        if (!model.load(modelPath)) return 1;
+        t = run(model, games, seed, logOut, transcriptsOut);
+        policyName = "behavior model";
+    } else if (useSolver) {
+        TranspositionTable tt(std::size_t{1} << 26);
+        SolverPolicy policy{ tt };
+        t = run(policy, games, seed, logOut, transcriptsOut);
+        policyName = "solver";
+        std::printf("transposition table hit rate %.2f%%\n", tt.stats().hit_rate() * 100.0);
+    } else {
+        StrategyTable table;
+        if (!table.load(tablePath)) {
+            std::fprintf(stderr, "run build_strategy_table first, or pass --model/--solver\n");
+            return 1;
+        }
+        StrategyTablePolicy policy{ table };
+        t = run(policy, games, seed, logOut, transcriptsOut);
+        policyName = "strategy table";
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::printf("%s: %llu games in %.2f s (%.0f games/s)\n", policyName,
+                static_cast<unsigned long long>(t.games), secs, static_cast<double>(t.games) / secs);
+    std::printf("mean payout $%.2f, deal rate %.2f%%\n",
+                static_cast<double>(t.winningsCents) / static_cast<double>(t.games) / 100.0,
+                static_cast<double>(t.deals) * 100.0 / static_cast<double>(t.games));
+    if (logPath && !write_decision_log(logPath, log)) return 1;
+    if (transcriptPath && !write_transcripts(transcriptPath, seed, transcripts)) return 1;
+    return 0;
+}
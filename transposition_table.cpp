@@ -0,0 +1,158 @@
+// transposition_table.cpp
+// Lock-free transposition table: bucketed open addressing with xor-validated slots.
+//
+// Slot encoding
+//   data  = valueCents | offerCents << 32 | takeDeal << 63
+//   tag   = packedKey | occupied << 31 | hash(packedKey) << 32
+//   check = tag ^ data
+// A torn slot (two writers interleaving, or a reader racing a writer) decodes to a tag
+// that doesn't match the probed key in all 64 bits, so it is simply reported as a miss;
+// a torn high half of `data` (offer and decision) is caught like any other bit.
+
+#include "transposition_table.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr std::uint64_t kOccupied = 1ull << 31;
+constexpr int kAgePenalty = 64; // One generation of age outweighs 64 units of cost
+
+std::atomic<std::size_t> g_nextStripe{0};
+
+std::uint64_t pack_data(const Evaluation& e) {
+    return static_cast<std::uint64_t>(e.valueCents)
+         | (static_cast<std::uint64_t>(e.offerCents & 0x7FFFFFFFu) << 32)
+         | (static_cast<std::uint64_t>(e.takeDeal) << 63);
+}
+
+Evaluation unpack_data(std::uint64_t d) {
+    Evaluation e;
+    e.valueCents = static_cast<std::uint32_t>(d);
+    e.offerCents = static_cast<std::uint32_t>(d >> 32) & 0x7FFFFFFFu;
+    e.takeDeal = (d >> 63) != 0;
+    return e;
+}
+
+std::uint64_t key_tag(std::uint32_t packedKey) {
+    const std::uint64_t hash = (static_cast<std::uint64_t>(packedKey) * 0xC2B2AE3D27D4EB4Full) >> 32;
+    return packedKey | kOccupied | hash << 32;
+}
+
+std::uint64_t meta_field(std::uint64_t meta, std::size_t slot) {
+    return (meta >> (16 * slot)) & 0xFFFFu;
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(std::size_t capacitySlots) {
+    std::size_t buckets = 1;
+    while (buckets * kBucketSlots < capacitySlots) buckets <<= 1;
+    buckets_.reset(new Bucket[buckets]);
+    meta_.reset(new BucketMeta[buckets]);
+    for (std::size_t i = 0; i < buckets; i++) meta_[i].store(0, std::memory_order_relaxed);
+    bucketMask_ = buckets - 1;
+}
+
+TranspositionTable::CounterStripe& TranspositionTable::stripe() {
+    thread_local const std::size_t idx = g_nextStripe.fetch_add(1, std::memory_order_relaxed) % kStripes;
+    return counters_[idx];
+}
+
+std::size_t TranspositionTable::bucket_index(std::uint32_t packedKey) const {
+    // Fibonacci hashing spreads neighbouring masks across the table
+    const std::uint64_t h = (static_cast<std::uint64_t>(packedKey) * 0x9E3779B97F4A7C15ull) >> 29;
+    return static_cast<std::size_t>(h) & bucketMask_;
+}
+
+bool TranspositionTable::probe(StateKey key, Evaluation& out) {
+    CounterStripe& cs = stripe();
+    cs.probes.fetch_add(1, std::memory_order_relaxed);
+
+    const std::uint32_t packedKey = key.packed();
+    const std::uint64_t want = key_tag(packedKey);
+    Bucket& b = buckets_[bucket_index(packedKey)];
+    for (Slot& s : b.slots) {
+        const std::uint64_t d = s.data.load(std::memory_order_relaxed);
+        const std::uint64_t c = s.check.load(std::memory_order_relaxed);
+        if (c == 0 || (c ^ d) != want) continue;
+        out = unpack_data(d);
+        cs.hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(StateKey key, const Evaluation& eval, std::uint16_t cost) {
+    CounterStripe& cs = stripe();
+    cs.stores.fetch_add(1, std::memory_order_relaxed);
+
+    const std::uint32_t packedKey = key.packed();
+    const std::uint64_t want = key_tag(packedKey);
+    const std::uint8_t gen = generation_.load(std::memory_order_relaxed);
+    const std::size_t bi = bucket_index(packedKey);
+    Bucket& b = buckets_[bi];
+    BucketMeta& meta = meta_[bi];
+    std::uint64_t m = meta.load(std::memory_order_relaxed);
+
+    // Pick a slot: same key > empty > lowest priority (cheap and old)
+    std::size_t victim = 0;
+    int victimScore = std::numeric_limits<int>::max();
+    bool evicts = true;
+    for (std::size_t i = 0; i < kBucketSlots; i++) {
+        Slot& s = b.slots[i];
+        const std::uint64_t c = s.check.load(std::memory_order_relaxed);
+        const std::uint64_t d = s.data.load(std::memory_order_relaxed);
+        if (c == 0) {
+            if (evicts) { victim = i; evicts = false; }
+            continue;
+        }
+        if ((c ^ d) == want) { victim = i; evicts = false; break; }
+        if (!evicts) continue;
+        const std::uint64_t f = meta_field(m, i);
+        const int oldCost = static_cast<int>(f & 0xFFu);
+        const int age = static_cast<std::uint8_t>(gen - static_cast<std::uint8_t>(f >> 8));
+        const int score = oldCost - age * kAgePenalty;
+        if (score < victimScore) { victim = i; victimScore = score; }
+    }
+
+    const std::uint64_t data = pack_data(eval);
+    b.slots[victim].data.store(data, std::memory_order_relaxed);
+    b.slots[victim].check.store(want ^ data, std::memory_order_relaxed);
+    const std::uint64_t field = std::min<std::uint64_t>(cost, 0xFF) | std::uint64_t{gen} << 8;
+    const int shift = static_cast<int>(16 * victim);
+    while (!meta.compare_exchange_weak(m, (m & ~(0xFFFFull << shift)) | field << shift, std::memory_order_relaxed)) {}
+    if (evicts) cs.replacements.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TranspositionTable::new_generation() {
+    generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i <= bucketMask_; i++) {
+        for (Slot& s : buckets_[i].slots) {
+            s.check.store(0, std::memory_order_relaxed);
+            s.data.store(0, std::memory_order_relaxed);
+        }
+        meta_[i].store(0, std::memory_order_relaxed);
+    }
+    for (CounterStripe& cs : counters_) {
+        cs.probes.store(0, std::memory_order_relaxed);
+        cs.hits.store(0, std::memory_order_relaxed);
+        cs.stores.store(0, std::memory_order_relaxed);
+        cs.replacements.store(0, std::memory_order_relaxed);
+    }
+}
+
+TranspositionStats TranspositionTable::stats() const {
+    TranspositionStats st;
+    for (const CounterStripe& cs : counters_) {
+        st.probes += cs.probes.load(std::memory_order_relaxed);
+        st.hits += cs.hits.load(std::memory_order_relaxed);
+        st.stores += cs.stores.load(std::memory_order_relaxed);
+        st.replacements += cs.replacements.load(std::memory_order_relaxed);
+    }
+    return st;
+}
@@ -0,0 +1,95 @@
+// transposition_table.h
+// Lock-free, fixed-capacity hash table caching state evaluations (certainty equivalent,
+// banker offer, deal/no-deal decision) so sessions and simulations running on different
+// threads never evaluate the same (opened-mask, round) state twice.
+//
+// Layout: open addressing over buckets of four 16-byte slots (one cache line per bucket).
+// Each slot stores `check = tag ^ data` next to `data`, where every bit of the tag follows
+// from the key; a reader that sees a half-written slot gets a tag mismatch and treats it
+// as a miss, so neither readers nor writers lock. Replacement bookkeeping (cost and
+// generation) lives in a separate word per bucket that probes never read.
+
+#pragma once
+
+#include "game.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Cached result of evaluating one state
+struct Evaluation {
+    std::uint32_t valueCents{0}; // Certainty-equivalent value of the position, in cents
+    std::uint32_t offerCents{0}; // Banker offer at this state (0 if no call happens here)
+    bool takeDeal{false};        // Strategy decision: accept the offer
+};
+
+// Snapshot of the table counters
+struct TranspositionStats {
+    std::uint64_t probes{0};
+    std::uint64_t hits{0};
+    std::uint64_t stores{0};
+    std::uint64_t replacements{0}; // Stores that evicted a different live state
+
+    double hit_rate() const { return probes ? static_cast<double>(hits) / static_cast<double>(probes) : 0.0; }
+};
+
+class TranspositionTable {
+public:
+    // Capacity is rounded up to a power of two number of slots (minimum one bucket)
+    explicit TranspositionTable(std::size_t capacitySlots);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Look up a state; returns true and fills `out` on a hit
+    bool probe(StateKey key, Evaluation& out);
+
+    // Insert or overwrite a state. `cost` approximates the work spent computing it (kept up
+    // to 255); when the bucket is full the cheapest entry from the oldest generation is
+    // replaced first.
+    void store(StateKey key, const Evaluation& eval, std::uint16_t cost);
+
+    // Age every entry by one generation (e.g. at the start of a new show) so stale
+    // expensive entries eventually give way to fresh ones
+    void new_generation();
+
+    // Drop every entry and reset counters. Not safe concurrently with probe/store.
+    void clear();
+
+    std::size_t capacity() const { return (bucketMask_ + 1) * kBucketSlots; }
+    TranspositionStats stats() const;
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check{0}; // tag ^ data; 0 when empty
+        std::atomic<std::uint64_t> data{0};
+    };
+    static constexpr std::size_t kBucketSlots = 4;
+    struct alignas(64) Bucket {
+        Slot slots[kBucketSlots];
+    };
+    // Per bucket: 16 bits per slot, cost in the low byte and generation in the high one.
+    // Only steers replacement, so a lost update costs a worse victim choice, nothing more.
+    using BucketMeta = std::atomic<std::uint64_t>;
+
+    // Counters are striped per thread so hot probes don't fight over one cache line
+    struct alignas(64) CounterStripe {
+        std::atomic<std::uint64_t> probes{0};
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> stores{0};
+        std::atomic<std::uint64_t> replacements{0};
+    };
+    static constexpr std::size_t kStripes = 16;
+
+    CounterStripe& stripe();
+
+    std::size_t bucket_index(std::uint32_t packedKey) const;
+
+    std::unique_ptr<Bucket[]> buckets_;
+    std::unique_ptr<BucketMeta[]> meta_;
+    std::size_t bucketMask_{0};
+    std::atomic<std::uint8_t> generation_{0};
+    CounterStripe counters_[kStripes];
+};
@@ -0,0 +1,81 @@
+// ui_cull.cpp
+
+#include "ui_cull.h"
+
+#include <algorithm>
+
+namespace {
+
+bool contains(const SDL_Rect& outer, const SDL_Rect& r) {
+    return r.x >= outer.x && r.y >= outer.y && r.x + r.w <= outer.x + outer.w && r.y + r.h <= outer.y + outer.h;
+}
+
+bool intersects(const SDL_Rect& a, const SDL_Rect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Cover test against cover[from...]: the first rect that overlaps `r` leaves up to four
+// uncovered pieces, each of which must be covered by the rest
+bool covered_from(const SDL_Rect& r, const std::vector<SDL_Rect>& cover, std::size_t from) {
+    if (r.w <= 0 || r.h <= 0) return true;
+    for (std::size_t i = from; i < cover.size(); i++) {
+        const SDL_Rect& c = cover[i];
+        if (contains(c, r)) return true;
+        if (!intersects(c, r)) continue;
+        const int top = std::max(r.y, c.y), bottom = std::min(r.y + r.h, c.y + c.h);
+        const SDL_Rect pieces[4] = {
+            { r.x, r.y, r.w, top - r.y },                                // Above
+            { r.x, bottom, r.w, r.y + r.h - bottom },                    // Below
+            { r.x, top, std::max(c.x - r.x, 0), bottom - top },          // Left
+            { c.x + c.w, top, std::max(r.x + r.w - c.x - c.w, 0), bottom - top }, // Right
+        };
+        for (const SDL_Rect& p : pieces)
+            if (!covered_from(p, cover, i + 1)) return false;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool rect_covered(const SDL_Rect& r, const std::vector<SDL_Rect>& cover) {
+    return covered_from(r, cover, 0);
+}
+
+void WidgetCuller::begin_frame(int w, int h) {
+    viewport_ = SDL_Rect{ 0, 0, w, h };
+    overlays_.clear();
+    frame_ = CullStats{};
+}
+
+void WidgetCuller::add_overlay(const SDL_Rect& r) {
+    if (r.w > 0 && r.h > 0) overlays_.push_back(r);
+}
+
+WidgetCuller::Result WidgetCuller::test(const SDL_Rect& r) const {
+    if (!intersects(r, viewport_)) return Result::Offscreen;
+    // Only the part on screen has to be covered
+    SDL_Rect onScreen{};
+    SDL_IntersectRect(&r, &viewport_, &onScreen);
+    return !overlays_.empty() && rect_covered(onScreen, overlays_) ? Result::Occluded : Result::Drawn;
+}
+
+void WidgetCuller::count(Result res, std::uint32_t widgets) {
+    std::uint32_t CullStats::*field = res == Result::Drawn ? &CullStats::drawn
+                                    : res == Result::Offscreen ? &CullStats::offscreen : &CullStats::occluded;
+    frame_.*field += widgets;
+    totals_.*field += widgets;
+}
+
+bool WidgetCuller::visible(const SDL_Rect& r) {
+    const Result res = test(r);
+    count(res, 1);
+    return res == Result::Drawn;
+}
+
+bool WidgetCuller::any_visible(const SDL_Rect& bounds, std::uint32_t widgets) {
+    const Result res = test(bounds);
+    if (res == Result::Drawn) return true;
+    count(res, widgets);
+    return false;
+}
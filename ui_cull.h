@@ -0,0 +1,58 @@
+// ui_cull.h
+// Skipping widgets nobody would see. The display layouts draw in painter's order, so a
+// widget under an opaque overlay (the banker's panel over the case board) is drawn and
+// then painted over. WidgetCuller answers "would this show?" before drawing:
+//
+//   - outside the viewport (a small window, a board taller than the screen): no
+//   - entirely behind the opaque overlays registered for this frame: no
+//
+// Overlays are registered at the start of the frame, before the widgets beneath them,
+// since the layout knows what it will draw on top. A test can stand for a whole group
+// (the board's rect for all its cells), so a covered board costs one test, not 26.
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+struct CullStats {
+    std::uint32_t drawn{0};
+    std::uint32_t offscreen{0};
+    std::uint32_t occluded{0};
+};
+
+// Whether `r` lies entirely within the union of `cover`
+bool rect_covered(const SDL_Rect& r, const std::vector<SDL_Rect>& cover);
+
+class WidgetCuller {
+public:
+    // Start a frame drawn into a w x h viewport, with no overlays
+    void begin_frame(int w, int h);
+
+    // An opaque rect that will be drawn over everything tested after this call
+    void add_overlay(const SDL_Rect& r);
+
+    // Whether anything of one widget at `r` would show; counted either way
+    bool visible(const SDL_Rect& r);
+
+    // The same test for the bounds of a group of `widgets` widgets. A culled group counts
+    // all of them; a visible one counts nothing, its widgets are tested one by one.
+    bool any_visible(const SDL_Rect& bounds, std::uint32_t widgets);
+
+    // Counters for the frame in progress (the last frame, between frames)
+    const CullStats& frame() const { return frame_; }
+    // Since construction
+    const CullStats& totals() const { return totals_; }
+
+private:
+    enum class Result : std::uint8_t { Drawn, Offscreen, Occluded };
+
+    Result test(const SDL_Rect& r) const;
+    void count(Result res, std::uint32_t widgets);
+
+    SDL_Rect viewport_{};
+    std::vector<SDL_Rect> overlays_;
+    CullStats frame_;
+    CullStats totals_;
+};
@@ -0,0 +1,407 @@
+// video_capture.cpp
+
+#include "video_capture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr char kDcapMagic[8] = { 'D', 'O', 'N', 'D', 'C', 'A', 'P', '1' };
+constexpr char kFrameTag[] = "FRAME\n"; // Y4M frame header
+constexpr std::size_t kMinZeroRun = 4; // Shorter unchanged stretches stay in literals
+constexpr std::uint8_t kBlackY = 16, kBlackUV = 128;
+
+std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+std::size_t i420_bytes(int w, int h) {
+    const auto luma = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+    return luma + luma / 2;
+}
+
+void fill_black(std::vector<std::uint8_t>& yuv, int w, int h) {
+    const auto luma = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+    std::fill(yuv.begin(), yuv.begin() + static_cast<std::ptrdiff_t>(luma), kBlackY);
+    std::fill(yuv.begin() + static_cast<std::ptrdiff_t>(luma), yuv.end(), kBlackUV);
+}
+
+// BT.601 limited range. Chroma from the 2x2 block average. Pixels outside the filled
+// `vw` x `vh` area (window smaller than the capture) come out black.
+void bgra_to_i420(const std::uint8_t* src, int pitch, int vw, int vh, int w, int h, std::uint8_t* yuv) {
+    std::uint8_t* yPlane = yuv;
+    std::uint8_t* uPlane = yuv + static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+    std::uint8_t* vPlane = uPlane + static_cast<std::size_t>(w / 2) * static_cast<std::size_t>(h / 2);
+    for (int y = 0; y < h; y += 2) {
+        for (int x = 0; x < w; x += 2) {
+            int sumR = 0, sumG = 0, sumB = 0;
+            for (int dy = 0; dy < 2; dy++)
+                for (int dx = 0; dx < 2; dx++) {
+                    const int px = x + dx, py = y + dy;
+                    int r = 0, g = 0, b = 0;
+                    if (px < vw && py < vh) {
+                        const std::uint8_t* p = src + static_cast<std::ptrdiff_t>(py) * pitch + px * 4;
+                        b = p[0];
+                        g = p[1];
+                        r = p[2];
+                    }
+                    yPlane[static_cast<std::size_t>(py) * static_cast<std::size_t>(w) + static_cast<std::size_t>(px)] =
+                        static_cast<std::uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                    sumR += r;
+                    sumG += g;
+                    sumB += b;
+                }
+            const int r = sumR / 4, g = sumG / 4, b = sumB / 4;
+            const std::size_t c = static_cast<std::size_t>(y / 2) * static_cast<std::size_t>(w / 2) + static_cast<std::size_t>(x / 2);
+            uPlane[c] = static_cast<std::uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[c] = static_cast<std::uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+// Length of the unchanged stretch starting at `i`, compared a word at a time
+std::size_t same_run(const std::uint8_t* a, const std::uint8_t* b, std::size_t i, std::size_t n) {
+    std::size_t j = i;
+    while (j + 8 <= n) {
+        std::uint64_t x, y;
+        std::memcpy(&x, a + j, 8);
+        std::memcpy(&y, b + j, 8);
+        if (x != y) break;
+        j += 8;
+    }
+    while (j < n && a[j] == b[j]) j++;
+    return j - i;
+}
+
+// Token stream: 0x00-0x7f = literal of t+1 delta bytes; 0x80-0xfe = t-0x7f unchanged
+// bytes; 0xff + u32 = that many unchanged bytes
+void pack_delta(const std::uint8_t* cur, const std::uint8_t* prev, std::size_t n, std::vector<std::uint8_t>& out) {
+    auto flush_literal = [&](std::size_t from, std::size_t to) {
+        while (from < to) {
+            const std::size_t len = std::min<std::size_t>(to - from, 128);
+            out.push_back(static_cast<std::uint8_t>(len - 1));
+            for (std::size_t k = from; k < from + len; k++) out.push_back(static_cast<std::uint8_t>(cur[k] - prev[k]));
+            from += len;
+        }
+    };
+    std::size_t pos = 0, literal = 0;
+    while (pos < n) {
+        if (cur[pos] != prev[pos]) {
+            pos++;
+            continue;
+        }
+        const std::size_t run = same_run(cur, prev, pos, n);
+        if (run < kMinZeroRun && pos + run < n) {
+            pos += run;
+            continue;
+        }
+        flush_literal(literal, pos);
+        if (run <= 127) {
+            out.push_back(static_cast<std::uint8_t>(0x7f + run));
+        } else {
+            out.push_back(0xff);
+            const auto r = static_cast<std::uint32_t>(run);
+            const std::uint8_t le[4] = { static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(r >> 8),
+                                         static_cast<std::uint8_t>(r >> 16), static_cast<std::uint8_t>(r >> 24) };
+            out.insert(out.end(), le, le + 4);
+        }
+        pos += run;
+        literal = pos;
+    }
+    flush_literal(literal, n);
+}
+
+// Apply a token stream to `frame` (holding the previous frame). False if it is corrupt.
+bool unpack_delta(const std::uint8_t* in, std::size_t len, std::uint8_t* frame, std::size_t n) {
+    std::size_t pos = 0, i = 0;
+    while (i < len) {
+        const std::uint8_t t = in[i++];
+        if (t < 0x80) {
+            const std::size_t lit = t + 1u;
+            if (i + lit > len || pos + lit > n) return false;
+            for (std::size_t k = 0; k < lit; k++) frame[pos + k] = static_cast<std::uint8_t>(frame[pos + k] + in[i + k]);
+            i += lit;
+            pos += lit;
+        } else if (t < 0xff) {
+            pos += t - 0x7fu;
+        } else {
+            if (i + 4 > len) return false;
+            pos += static_cast<std::size_t>(in[i]) | static_cast<std::size_t>(in[i + 1]) << 8
+                 | static_cast<std::size_t>(in[i + 2]) << 16 | static_cast<std::size_t>(in[i + 3]) << 24;
+            i += 4;
+        }
+        if (pos > n) return false;
+    }
+    return pos == n;
+}
+
+void put_u32(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    const std::uint8_t le[4] = { static_cast<std::uint8_t>(v), static_cast<std::uint8_t>(v >> 8),
+                                 static_cast<std::uint8_t>(v >> 16), static_cast<std::uint8_t>(v >> 24) };
+    out.insert(out.end(), le, le + 4);
+}
+
+bool get_u32(std::FILE* f, std::uint32_t& v) {
+    std::uint8_t le[4];
+    if (std::fread(le, 1, 4, f) != 4) return false;
+    v = static_cast<std::uint32_t>(le[0]) | static_cast<std::uint32_t>(le[1]) << 8
+      | static_cast<std::uint32_t>(le[2]) << 16 | static_cast<std::uint32_t>(le[3]) << 24;
+    return true;
+}
+
+void y4m_header(std::FILE* f, int w, int h, int fps) {
+    std::fprintf(f, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", w, h, fps);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------
+// Main thread
+// ---------------------------------------------------------------------------------------
+
+bool VideoCapture::open(const char* path, int width, int height, const CaptureOptions& options) {
+    close();
+    width_ = width & ~1;
+    height_ = height & ~1;
+    options_ = options;
+    options_.fps = std::max(1, options.fps);
+    options_.poolFrames = std::max(2, options.poolFrames);
+    if (width_ <= 0 || height_ <= 0) {
+        std::fprintf(stderr, "capture: bad frame size %dx%d\n", width, height);
+        return false;
+    }
+    file_ = std::fopen(path, "wb");
+    if (!file_) {
+        std::fprintf(stderr, "capture: cannot create %s\n", path);
+        return false;
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, 1u << 20);
+    if (options_.compress) {
+        std::fwrite(kDcapMagic, 1, sizeof(kDcapMagic), file_);
+        std::vector<std::uint8_t> hdr;
+        put_u32(hdr, static_cast<std::uint32_t>(width_));
+        put_u32(hdr, static_cast<std::uint32_t>(height_));
+        put_u32(hdr, static_cast<std::uint32_t>(options_.fps));
+        std::fwrite(hdr.data(), 1, hdr.size(), file_);
+    } else {
+        y4m_header(file_, width_, height_, options_.fps);
+    }
+    bytes_ = static_cast<std::uint64_t>(std::ftell(file_));
+    written_ = 0;
+    encodeNs_ = 0;
+    writeNs_ = 0;
+    mainStats_ = CaptureStats{};
+    nextDueNs_ = 0;
+    pendingDrops_ = 0;
+
+    const auto frames = static_cast<std::size_t>(options_.poolFrames);
+    const std::size_t bgraBytes = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_) * 4;
+    toEncode_ = std::make_unique<MpscQueue<Frame*>>(frames + 1);
+    toWrite_ = std::make_unique<MpscQueue<Frame*>>(frames + 1);
+    free_ = std::make_unique<MpscQueue<Frame*>>(frames + 1);
+    for (std::size_t i = 0; i < frames; i++) {
+        pool_.push_back(std::make_unique<Frame>());
+        pool_.back()->bgra.resize(bgraBytes);
+        free_->try_push(pool_.back().get());
+    }
+    yuv_.assign(i420_bytes(width_, height_), 0);
+    prevYuv_.assign(yuv_.size(), 0);
+    fill_black(prevYuv_, width_, height_); // The decoder starts from black as well
+    lastOut_.clear();
+    if (!options_.compress) {
+        lastOut_.assign(kFrameTag, kFrameTag + 6);
+        lastOut_.insert(lastOut_.end(), prevYuv_.begin(), prevYuv_.end());
+    }
+
+    encoder_ = std::thread([this] { encode_loop(); });
+    writer_ = std::thread([this] { write_loop(); });
+    return true;
+}
+
+void VideoCapture::close() {
+    if (!file_) return;
+    if (filling_) submit();
+    toEncode_->try_push(nullptr); // Sentinel: flows through both stages
+    encoder_.join();
+    writer_.join();
+    std::fclose(file_);
+    file_ = nullptr;
+    pool_.clear();
+}
+
+bool VideoCapture::frame_due(std::uint64_t nowNs) {
+    if (!file_) return false;
+    const std::uint64_t interval = std::uint64_t{1000000000} / static_cast<std::uint64_t>(options_.fps);
+    if (nextDueNs_ == 0) nextDueNs_ = nowNs;
+    if (nowNs < nextDueNs_) return false;
+    // Every interval the main loop slept through is a frame missing from the archive
+    const std::uint64_t missed = (nowNs - nextDueNs_) / interval;
+    pendingDrops_ += static_cast<std::uint32_t>(missed);
+    mainStats_.dropped += missed;
+    nextDueNs_ += (missed + 1) * interval;
+    return true;
+}
+
+CaptureBuffer VideoCapture::begin_frame(int width, int height) {
+    CaptureBuffer buf;
+    if (!file_) return buf;
+    fillStartNs_ = now_ns();
+    Frame* f = nullptr;
+    if (free_->pop_batch(&f, 1) == 0) {
+        ++pendingDrops_; // Every buffer is still being encoded or written
+        ++mainStats_.dropped;
+        return buf;
+    }
+    filling_ = f;
+    f->width = std::min(width, width_);
+    f->height = std::min(height, height_);
+    buf.pixels = f->bgra.data();
+    buf.width = f->width;
+    buf.height = f->height;
+    buf.pitch = width_ * 4;
+    return buf;
+}
+
+void VideoCapture::submit() {
+    if (!filling_) return;
+    Frame* f = std::exchange(filling_, nullptr);
+    f->repeatBefore = std::exchange(pendingDrops_, 0u);
+    toEncode_->try_push(f);
+    ++mainStats_.frames;
+    const std::uint64_t spent = now_ns() - fillStartNs_;
+    mainStats_.mainNs += spent;
+    mainStats_.mainMaxNs = std::max(mainStats_.mainMaxNs, spent);
+}
+
+CaptureStats VideoCapture::stats() const {
+    CaptureStats s = mainStats_;
+    s.written = written_.load(std::memory_order_relaxed);
+    s.bytes = bytes_.load(std::memory_order_relaxed);
+    s.encodeNs = encodeNs_.load(std::memory_order_relaxed);
+    s.writeNs = writeNs_.load(std::memory_order_relaxed);
+    return s;
+}
+
+// ---------------------------------------------------------------------------------------
+// Pipeline threads
+// ---------------------------------------------------------------------------------------
+
+void VideoCapture::encode_loop() {
+    Frame* batch[8];
+    for (;;) {
+        const std::size_t n = toEncode_->pop_batch(batch, 8);
+        if (n == 0) {
+            toEncode_->wait(-1);
+            continue;
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            if (batch[i]) encode(*batch[i]);
+            toWrite_->try_push(batch[i]);
+            if (!batch[i]) return;
+        }
+    }
+}
+
+void VideoCapture::encode(Frame& f) {
+    const std::uint64_t t0 = now_ns();
+    f.out.clear();
+    bgra_to_i420(f.bgra.data(), width_ * 4, f.width, f.height, width_, height_, yuv_.data());
+    if (options_.compress) {
+        const std::size_t lenAt = f.out.size();
+        put_u32(f.out, 0);
+        pack_delta(yuv_.data(), prevYuv_.data(), yuv_.size(), f.out);
+        // Never empty (an unchanged frame is one zero run), so 0 stays free to mean "repeat"
+        const auto len = static_cast<std::uint32_t>(f.out.size() - lenAt - 4);
+        for (int k = 0; k < 4; k++) f.out[lenAt + static_cast<std::size_t>(k)] = static_cast<std::uint8_t>(len >> (8 * k));
+    } else {
+        f.out.insert(f.out.end(), kFrameTag, kFrameTag + 6);
+        f.out.insert(f.out.end(), yuv_.begin(), yuv_.end());
+    }
+    prevYuv_.swap(yuv_);
+    encodeNs_.fetch_add(now_ns() - t0, std::memory_order_relaxed);
+}
+
+void VideoCapture::write_loop() {
+    Frame* batch[8];
+    for (;;) {
+        const std::size_t n = toWrite_->pop_batch(batch, 8);
+        if (n == 0) {
+            toWrite_->wait(-1);
+            continue;
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            Frame* f = batch[i];
+            if (!f) {
+                std::fflush(file_);
+                return;
+            }
+            const std::uint64_t t0 = now_ns();
+            // Stand-ins for dropped frames, written from the one copy of the previous
+            // picture: a long stall (minimized window) costs file space, not memory
+            static constexpr std::uint8_t kRepeat[4] = {}; // .dcap: zero length
+            const std::uint8_t* rep = options_.compress ? kRepeat : lastOut_.data();
+            const std::size_t repBytes = options_.compress ? sizeof(kRepeat) : lastOut_.size();
+            bool ok = true;
+            for (std::uint32_t r = 0; r < f->repeatBefore && ok; r++)
+                ok = std::fwrite(rep, 1, repBytes, file_) == repBytes;
+            ok = ok && std::fwrite(f->out.data(), 1, f->out.size(), file_) == f->out.size();
+            if (!ok) std::fprintf(stderr, "capture: write failed, frames are being lost\n");
+            written_.fetch_add(std::uint64_t{f->repeatBefore} + 1, std::memory_order_relaxed);
+            bytes_.fetch_add(std::uint64_t{f->repeatBefore} * repBytes + f->out.size(), std::memory_order_relaxed);
+            writeNs_.fetch_add(now_ns() - t0, std::memory_order_relaxed);
+            // Keep this picture for the next repeats; the frame takes the old buffer back
+            if (!options_.compress) lastOut_.swap(f->out);
+            free_->try_push(f);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------
+// Offline conversion
+// ---------------------------------------------------------------------------------------
+
+bool capture_to_y4m(const char* inPath, const char* outPath) {
+    std::FILE* in = std::fopen(inPath, "rb");
+    if (!in) {
+        std::fprintf(stderr, "capture: cannot open %s\n", inPath);
+        return false;
+    }
+    char magic[8];
+    std::uint32_t w = 0, h = 0, fps = 0;
+    if (std::fread(magic, 1, 8, in) != 8 || std::memcmp(magic, kDcapMagic, 8) != 0
+        || !get_u32(in, w) || !get_u32(in, h) || !get_u32(in, fps)
+        || w == 0 || h == 0 || (w | h) & 1u || w > 16384 || h > 16384) {
+        std::fprintf(stderr, "capture: %s is not a .dcap capture\n", inPath);
+        std::fclose(in);
+        return false;
+    }
+    std::FILE* out = std::fopen(outPath, "wb");
+    if (!out) {
+        std::fprintf(stderr, "capture: cannot create %s\n", outPath);
+        std::fclose(in);
+        return false;
+    }
+    y4m_header(out, static_cast<int>(w), static_cast<int>(h), static_cast<int>(fps));
+
+    std::vector<std::uint8_t> frame(i420_bytes(static_cast<int>(w), static_cast<int>(h)));
+    fill_black(frame, static_cast<int>(w), static_cast<int>(h));
+    std::vector<std::uint8_t> packed;
+    bool ok = true;
+    std::uint32_t len = 0;
+    while (ok && get_u32(in, len)) {
+        packed.resize(len);
+        ok = std::fread(packed.data(), 1, len, in) == len
+          && (len == 0 || unpack_delta(packed.data(), len, frame.data(), frame.size()));
+        if (!ok) break;
+        std::fputs("FRAME\n", out);
+        ok = std::fwrite(frame.data(), 1, frame.size(), out) == frame.size();
+    }
+    if (!ok) std::fprintf(stderr, "capture: %s is truncated or corrupt\n", inPath);
+    std::fclose(in);
+    if (std::fclose(out) != 0) ok = false;
+    return ok;
+}
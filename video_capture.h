@@ -0,0 +1,117 @@
+// video_capture.h
+// Archive capture of the rendered show. The main loop reads a frame back from the renderer
+// straight into a pooled buffer and submits it; an encoder thread converts it to I420 and
+// packs it, and a writer thread appends it to the file and hands the buffer back. The main
+// loop never blocks. When every buffer is still in flight the frame is dropped, and the
+// next frame is written that many extra times, so the archive keeps real time.
+//
+// Output is either plain Y4M (playable anywhere; about 80 MB/s at 720p60) or, with
+// `compress`, a .dcap stream: every frame is stored as its byte delta to the previous
+// frame, with zero runs collapsed. Show graphics are mostly static, so this is small and
+// cheap. capture_to_y4m() turns a .dcap back into a Y4M file.
+
+#pragma once
+
+#include "mpsc_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct CaptureOptions {
+    int fps{30};
+    bool compress{false};
+    int poolFrames{6};  // Frames in flight before capture starts dropping
+};
+
+struct CaptureStats {
+    std::uint64_t frames{0};       // Submitted by the main loop
+    std::uint64_t dropped{0};      // Skipped (pipeline full or main loop too slow); repeated in the file
+    std::uint64_t written{0};      // Frames in the file, repeats included
+    std::uint64_t bytes{0};        // File size so far
+    std::uint64_t mainNs{0};       // Main-loop time from begin_frame() to submit(), readback included
+    std::uint64_t mainMaxNs{0};
+    std::uint64_t encodeNs{0};     // Encoder thread busy time
+    std::uint64_t writeNs{0};      // Writer thread busy time
+};
+
+// Pixels to fill for one frame: BGRA in memory (SDL_PIXELFORMAT_ARGB8888)
+struct CaptureBuffer {
+    std::uint8_t* pixels{nullptr}; // nullptr = frame dropped, skip the readback
+    int width{0};                  // Area to fill, clipped to the capture size
+    int height{0};
+    int pitch{0};
+};
+
+class VideoCapture {
+public:
+    VideoCapture() = default;
+    VideoCapture(const VideoCapture&) = delete;
+    VideoCapture& operator=(const VideoCapture&) = delete;
+    ~VideoCapture() { close(); }
+
+    // Start capturing `width` x `height` (rounded down to even) to `path`
+    bool open(const char* path, int width, int height, const CaptureOptions& options);
+    // Finish the queued frames and close the file
+    void close();
+    bool is_open() const { return file_ != nullptr; }
+
+    // Whether a frame should be captured now (fps pacing). Intervals the main loop missed
+    // count as dropped.
+    bool frame_due(std::uint64_t nowNs);
+
+    // Borrow a buffer for a `width` x `height` render output, then submit() it. With no
+    // buffer free, pixels is nullptr and the frame counts as dropped.
+    CaptureBuffer begin_frame(int width, int height);
+    void submit();
+
+    CaptureStats stats() const;
+
+private:
+    struct Frame {
+        std::vector<std::uint8_t> bgra;
+        std::vector<std::uint8_t> out; // File bytes for this frame alone
+        int width{0};                  // Part of bgra the main loop filled
+        int height{0};
+        std::uint32_t repeatBefore{0}; // Dropped frames to stand in for; the writer repeats
+                                       // the previous picture rather than storing copies
+    };
+
+    void encode_loop();
+    void write_loop();
+    void encode(Frame& f);
+
+    int width_{0};
+    int height_{0};
+    CaptureOptions options_;
+    std::FILE* file_{nullptr};
+    std::vector<std::unique_ptr<Frame>> pool_;
+    std::unique_ptr<MpscQueue<Frame*>> toEncode_;
+    std::unique_ptr<MpscQueue<Frame*>> toWrite_;
+    std::unique_ptr<MpscQueue<Frame*>> free_;
+    std::thread encoder_;
+    std::thread writer_;
+
+    // Main thread
+    Frame* filling_{nullptr};
+    std::uint64_t fillStartNs_{0};
+    std::uint64_t nextDueNs_{0};
+    std::uint32_t pendingDrops_{0};
+    CaptureStats mainStats_;
+
+    // Encoder thread
+    std::vector<std::uint8_t> yuv_, prevYuv_;
+    std::atomic<std::uint64_t> encodeNs_{0};
+
+    // Writer thread
+    std::vector<std::uint8_t> lastOut_; // Y4M: the last picture written, "FRAME\n" included
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> writeNs_{0};
+};
+
+// Convert a .dcap capture to Y4M. Returns false on I/O error or a corrupt stream.
+bool capture_to_y4m(const char* inPath, const char* outPath);